@@ -54,6 +54,8 @@ void archi_init();
 
 #if defined(SIMULATOR)
 #    include "../support/archi/simulator/simulator.h"
+#elif defined(MOCK)
+#    include "../support/archi/mock/mock.h"
 #endif
 
 #endif  // ARCHI_H
@@ -82,4 +82,41 @@ typedef uint8_t rt_dev_t_class;
 ssize_t device_write(rt_dev_t device, const char *data, size_t size);
 ssize_t device_read(rt_dev_t device, char *data, size_t size_max);
 
+// ===== vectored and asynchronous io =====
+typedef struct
+{
+    const char *data;
+    size_t size;
+} DeviceIovec;
+
+ssize_t device_writev(rt_dev_t device, const DeviceIovec *iov, uint8_t iovCount);
+int device_transmitFinished(rt_dev_t device);
+
+typedef struct DeviceRequest
+{
+    struct DeviceRequest *next;
+    const DeviceIovec *iov;
+    DeviceIovec buffer;  // iov storage for device_writeAsync
+    void (*callback)(struct DeviceRequest *request);
+    size_t offset;    // offset in the current iov
+    ssize_t written;  // bytes written, -1 in case of error
+    rt_dev_t device;
+    uint8_t iovCount;
+    uint8_t iovId;
+    volatile uint8_t pending;
+} DeviceRequest;
+
+int device_writeAsync(DeviceRequest *request,
+                      rt_dev_t device,
+                      const char *data,
+                      size_t size,
+                      void (*callback)(DeviceRequest *request));
+int device_writevAsync(DeviceRequest *request,
+                       rt_dev_t device,
+                       const DeviceIovec *iov,
+                       uint8_t iovCount,
+                       void (*callback)(DeviceRequest *request));
+int device_isPending(const DeviceRequest *request);
+void device_task(void);
+
 #endif  // DEVICE_H
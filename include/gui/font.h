@@ -19,12 +19,50 @@ typedef struct
     const char *data;
 } Letter;
 
+/**
+ * @brief Range of contiguous characters of a packed font
+ */
+typedef struct
+{
+    uint8_t first;   ///< first character code (Latin-1)
+    uint8_t last;    ///< last character code (Latin-1)
+    uint16_t glyph;  ///< index of the glyph of the first character
+} FontRange;
+
+/**
+ * @brief Kerning pair, advance of left character is adjusted when followed by right
+ */
+typedef struct
+{
+    uint8_t left;
+    uint8_t right;
+    int8_t offset;
+} FontKerning;
+
+/**
+ * @brief Font struct
+ *
+ * Legacy fonts have one 1 bpp Letter per character between first and last.
+ * Packed fonts have a NULL letters table, all glyphs are stored in one blob,
+ * column by column, each pixel on bpp bits MSB first, each glyph starting on a
+ * byte boundary. Pixel value is the pen coverage, from brush (0) to pen (max).
+ */
 typedef struct
 {
     uint8_t height;
-    char first;
-    char last;
+    uint8_t first;
+    uint8_t last;
     const Letter **letters;
+
+    // packed format, used when letters is NULL
+    uint8_t bpp;  ///< bits per pixel, 1, 2 or 4
+    uint8_t rangeCount;
+    const FontRange *ranges;
+    const uint8_t *widths;    ///< advance width of each glyph
+    const uint16_t *offsets;  ///< offset of each glyph in glyphs blob
+    const uint8_t *glyphs;
+    uint16_t kerningCount;
+    const FontKerning *kernings;  ///< sorted by left then right characters
 } Font;
 
 #endif  // _FONT_
@@ -20,6 +20,28 @@
 #    define __space_prog__
 #endif
 
+/**
+ * @brief Picture data encoding
+ *
+ * Pixels are always stored column by column (x major, y minor).
+ * - PICTURE_FORMAT_RAW: data contains width * height RGB565 words
+ * - PICTURE_FORMAT_PALETTE: data is a palette of RGB565 words, indexes contains
+ *   the palette index of each pixel, packed on bpp bits, MSB first
+ * - PICTURE_FORMAT_RLE: data is a palette, indexes contains a list of spans:
+ *   - a header byte 0x80 | (n - 1) followed by one index byte, n pixels of the same color
+ *   - a header byte (n - 1) followed by n indexes packed on bpp bits, MSB first,
+ *     padded to a byte boundary
+ */
+typedef enum
+{
+    PICTURE_FORMAT_RAW = 0,  ///< uncompressed RGB565 pixels
+    PICTURE_FORMAT_PALETTE,  ///< palette with packed 1/2/4/8 bits indexes
+    PICTURE_FORMAT_RLE       ///< palette with run length encoded indexes
+} PICTURE_FORMAT;
+
+#define PICTURE_RLE_REPEAT    0x80  ///< span header flag of a repeated index
+#define PICTURE_RLE_MAX_SPAN  128   ///< maximum pixel count of a span
+
 /**
  * @brief Picture struct
  * contains data and metadata (width, height...)
@@ -30,9 +52,13 @@ typedef struct
     uint16_t width;
     uint16_t height;
 
-    // data
+    // data, RGB565 pixels or palette depending on format
     __prog__ const uint16_t *data;
 
+    // compression, a zero initialized tail means raw format
+    uint8_t format;  ///< PICTURE_FORMAT
+    uint8_t bpp;     ///< bits per palette index (1, 2, 4 or 8)
+    __prog__ const uint8_t *indexes;
 } Picture;
 
 #endif  // PICTURE_H
@@ -0,0 +1 @@
+#include "../../support/module/log/log.h"
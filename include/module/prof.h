@@ -0,0 +1 @@
+#include "../../support/module/prof/prof.h"
@@ -43,4 +43,7 @@ size_t fifo_avail(Fifo *fifo);
 size_t fifo_push(Fifo *fifo, const char *data, size_t sizeToWrite);
 size_t fifo_pop(Fifo *fifo, char *data, size_t max_size);
 
+size_t fifo_span(Fifo *fifo, const char **data);
+size_t fifo_drop(Fifo *fifo, size_t size);
+
 #endif  // FIFO_H
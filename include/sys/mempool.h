@@ -0,0 +1,78 @@
+/**
+ * @file mempool.h
+ * @author agent
+ * @copyright UniSwarm 2026
+ *
+ * @date October 19, 2026, 07:15 PM
+ *
+ * @brief Fixed block memory pool
+ *
+ * A pool is a static array of blocks of the same size, free blocks are linked
+ * in place, alloc and free are O(1) and can be called from interrupt handlers.
+ * Blocks are taken in address order the first time, a STATIC_MEMPOOL can be
+ * used without init call. An allocation bit per block, stored after the
+ * blocks, rejects double free.
+ * Several pools of increasing block sizes can be used as size classes with
+ * mempool_allocSize / mempool_freeAny.
+ */
+
+#ifndef MEMPOOL_H
+#define MEMPOOL_H
+
+#include <stdint.h>
+#include <stdlib.h>
+
+typedef struct MemPoolBlock
+{
+    struct MemPoolBlock *next;
+} MemPoolBlock;
+
+typedef struct
+{
+    size_t blockSize;
+    uint16_t blockCount;
+    uint16_t carved;  // blocks already taken once, next ones are not linked yet
+    volatile uint16_t used;
+    uint16_t highWater;  // max blocks used at the same time
+    uint16_t failures;   // allocations failed as the pool was empty
+    uint16_t badFrees;   // frees rejected as the block was not allocated, double free
+    MemPoolBlock *free;
+    char *data;
+    uint8_t *map;  // allocation bit per block
+} MemPool;
+
+// block size rounded up to keep each block aligned on a pointer
+#define MEMPOOL_BLOCK_SIZE(size)                                                                                       \
+    ((((size) < sizeof(MemPoolBlock) ? sizeof(MemPoolBlock) : (size)) + sizeof(void *) - 1) & ~(sizeof(void *) - 1))
+
+// storage of a pool in bytes, blocks followed by the allocation map
+#define MEMPOOL_DATA_SIZE(size, count) ((size_t)(count)*MEMPOOL_BLOCK_SIZE(size) + ((count) + 7) / 8)
+
+#define MEMPOOL_INITIALIZER(data, size, count)                                                                         \
+    {                                                                                                                  \
+        MEMPOOL_BLOCK_SIZE(size), (count), 0, 0, 0, 0, 0, NULL, (char *)(data),                                        \
+            (uint8_t *)(data) + (size_t)(count)*MEMPOOL_BLOCK_SIZE(size)                                               \
+    }
+
+#define STATIC_MEMPOOL(x, size, count)                                                                                 \
+    void *x##_data[(MEMPOOL_DATA_SIZE(size, count) + sizeof(void *) - 1) / sizeof(void *)];                            \
+    MemPool x = MEMPOOL_INITIALIZER(x##_data, size, count)
+
+#define STATIC_MEMPOOL_INIT(x, size, count) mempool_init(&x, (char *)x##_data, (size), (count))
+
+void mempool_init(MemPool *pool, char *data, size_t blockSize, uint16_t blockCount);
+void *mempool_alloc(MemPool *pool);
+int mempool_free(MemPool *pool, void *block);
+
+size_t mempool_blockSize(MemPool *pool);
+uint16_t mempool_used(MemPool *pool);
+uint16_t mempool_avail(MemPool *pool);
+uint16_t mempool_highWater(MemPool *pool);
+uint16_t mempool_failures(MemPool *pool);
+uint16_t mempool_badFrees(MemPool *pool);
+
+// size classes, pools sorted by increasing block size
+void *mempool_allocSize(MemPool *pools, uint8_t poolCount, size_t size);
+int mempool_freeAny(MemPool *pools, uint8_t poolCount, void *block);
+
+#endif  // MEMPOOL_H
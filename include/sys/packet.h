@@ -0,0 +1,33 @@
+/**
+ * @file packet.h
+ * @author agent
+ * @copyright UniSwarm 2026
+ *
+ * @date October 20, 2026, 10:05 AM
+ *
+ * @brief Packet buffers shared by drivers and modules
+ *
+ * One memory pool of PACKET_COUNT blocks of PACKET_SIZE bytes, for buffers
+ * only needed from time to time (network backlog, can frames, command lines)
+ * that would otherwise each keep their own static array. Size and count can
+ * be defined in DEFINES.
+ */
+
+#ifndef PACKET_H
+#define PACKET_H
+
+#include "mempool.h"
+
+#ifndef PACKET_SIZE
+#    define PACKET_SIZE 128
+#endif
+#ifndef PACKET_COUNT
+#    define PACKET_COUNT 8
+#endif
+
+void *packet_alloc(void);
+int packet_free(void *packet);
+
+MemPool *packet_pool(void);
+
+#endif  // PACKET_H
@@ -0,0 +1,42 @@
+/**
+ * @file scheduler.h
+ * @author agent
+ * @copyright UniSwarm 2026
+ *
+ * @date October 19, 2026, 06:40 PM
+ *
+ * @brief Cooperative event driven task scheduler
+ *
+ * Tasks run to completion, only when an event is pending for them. Events are
+ * signaled with scheduler_signal, from main code or interrupt handlers (uart
+ * rx, timer, can rx handlers...). Pending tasks run by priority, 0 is the
+ * highest one, in signal order for a same priority. The CPU idles when no
+ * task is pending.
+ */
+
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <stdint.h>
+
+#ifndef SCHEDULER_PRIORITY_COUNT
+#    define SCHEDULER_PRIORITY_COUNT 8
+#endif
+
+typedef struct SchedulerTask
+{
+    struct SchedulerTask *next;
+    void (*run)(uint16_t events);
+    volatile uint16_t events;
+    uint8_t priority;
+    uint8_t queued;
+} SchedulerTask;
+
+int scheduler_addTask(SchedulerTask *task, void (*run)(uint16_t events), uint8_t priority);
+void scheduler_signal(SchedulerTask *task, uint16_t events);
+
+int scheduler_runOnce(void);
+void scheduler_run(void);
+void scheduler_stop(void);
+
+#endif  // SCHEDULER_H
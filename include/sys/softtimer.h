@@ -0,0 +1,52 @@
+/**
+ * @file softtimer.h
+ * @author agent
+ * @copyright UniSwarm 2026
+ *
+ * @date October 19, 2026, 05:30 PM
+ *
+ * @brief Software timers multiplexed on one hardware timer
+ *
+ * Hierarchical timing wheel : SOFTTIMER_WHEEL_LEVELS levels of
+ * 2^SOFTTIMER_WHEEL_BITS slots, level n slots span 2^(n*SOFTTIMER_WHEEL_BITS)
+ * ticks. Start and stop are O(1), a tick expires one slot and cascades an
+ * upper level slot every 2^SOFTTIMER_WHEEL_BITS ticks.
+ */
+
+#ifndef SOFTTIMER_H
+#define SOFTTIMER_H
+
+#include <driver/device.h>
+#include <stdint.h>
+
+#ifndef SOFTTIMER_WHEEL_BITS
+#    define SOFTTIMER_WHEEL_BITS 4
+#endif
+#ifndef SOFTTIMER_WHEEL_LEVELS
+#    define SOFTTIMER_WHEEL_LEVELS 4
+#endif
+// longest hardware period in ticks in tickless mode
+#ifndef SOFTTIMER_TICKLESS_MAX
+#    define SOFTTIMER_TICKLESS_MAX 100
+#endif
+
+typedef struct SoftTimer
+{
+    struct SoftTimer *next;
+    struct SoftTimer **pprev;  // NULL when stopped
+    uint32_t expire;           // tick of next expiration
+    uint32_t period;           // period in ticks, 0 for one shot timers
+    void (*handler)(void);
+} SoftTimer;
+
+int softtimer_init(rt_dev_t timer, uint32_t tickUs);
+int softtimer_setTickless(uint8_t tickless);
+void softtimer_tick(void);
+uint32_t softtimer_ticks(void);
+uint32_t softtimer_nextExpire(void);
+
+int softtimer_start(SoftTimer *softTimer, void (*handler)(void), uint32_t delayUs, uint32_t periodUs);
+int softtimer_stop(SoftTimer *softTimer);
+int softtimer_isActive(const SoftTimer *softTimer);
+
+#endif  // SOFTTIMER_H
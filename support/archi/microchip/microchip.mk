@@ -38,12 +38,37 @@ OBJECTS := $(addprefix $(OUT_PWD)/, $(OBJECTS))
 $(OBJECTS) : $(CONFIG_HEADERS)
 
 # rule to build OBJECTS to OUT_PWD and give dependencies
+ifndef OBJ_CACHE
 $(OUT_PWD)/%.o : %.c
 	@test -d $(OUT_PWD) || mkdir -p $(OUT_PWD)
 	@printf "$(COMPCOLOR)µCC %-35s => %s\n$(NORM)" $(notdir $<) $(OUT_PWD)/$(notdir $@)
 	$(VERB)$(CC) $(CCFLAGS) $(CCFLAGS_XC) -c $< $(DEFINES) $(INCLUDEPATH) -o $(OUT_PWD)/$(notdir $@)
 	@$(CC) $(CCFLAGS) $(CCFLAGS_XC) -MM $< $(DEFINES) $(INCLUDEPATH) -MT $(OUT_PWD)/$(notdir $@) > $(OUT_PWD)/$*.d
 	$(VERB)$(OBJDUMP) -S $(OUT_PWD)/$(notdir $@) > $(OUT_PWD)/$*.lst
+else
+# object cache shared between builds (archtest matrix), objects are indexed by
+# the hash of the preprocessed source and of the code generation flags. -mcpu
+# is kept in the key, XC objects may carry device attributes, so objects are
+# only shared between builds of the same device (boards, rebuilds).
+OBJ_CACHE_HASH ?= sha1sum
+OBJ_CACHE_FLAGS = $(ARCHI) $(CC) $(filter-out -D% -I%,$(CCFLAGS) $(CCFLAGS_XC))
+$(OUT_PWD)/%.o : %.c
+	@test -d $(OUT_PWD) || mkdir -p $(OUT_PWD)
+	@test -d $(OBJ_CACHE) || mkdir -p $(OBJ_CACHE)
+	$(VERB)$(CC) $(CCFLAGS) $(CCFLAGS_XC) -E -P $< $(DEFINES) $(INCLUDEPATH) -MD -MF $(OUT_PWD)/$*.d -MT $(OUT_PWD)/$(notdir $@) -o $(OUT_PWD)/$*.i
+	$(VERB)key=$$( (echo "$(OBJ_CACHE_FLAGS)"; cat $(OUT_PWD)/$*.i) | $(OBJ_CACHE_HASH) | cut -d' ' -f1); \
+	rm -f $(OUT_PWD)/$*.i; \
+	if test -f $(OBJ_CACHE)/$$key.o; then \
+		printf "$(COMPCOLOR)µCC %-35s => %s (cached)\n$(NORM)" $(notdir $<) $(OUT_PWD)/$(notdir $@); \
+		cp $(OBJ_CACHE)/$$key.o $(OUT_PWD)/$(notdir $@); \
+		if test -f $(OBJ_CACHE)/$$key.su; then cp $(OBJ_CACHE)/$$key.su $(OUT_PWD)/$*.su; fi; \
+	else \
+		printf "$(COMPCOLOR)µCC %-35s => %s\n$(NORM)" $(notdir $<) $(OUT_PWD)/$(notdir $@); \
+		$(CC) $(CCFLAGS) $(CCFLAGS_XC) -c $< $(DEFINES) $(INCLUDEPATH) -o $(OUT_PWD)/$(notdir $@) || exit 1; \
+		if test -f $(OUT_PWD)/$*.su; then cp $(OUT_PWD)/$*.su $(OBJ_CACHE)/$$key.su; fi; \
+		cp $(OUT_PWD)/$(notdir $@) $(OBJ_CACHE)/$$key.o.$$$$ && mv -f $(OBJ_CACHE)/$$key.o.$$$$ $(OBJ_CACHE)/$$key.o; \
+	fi
+endif
 
 $(OUT_PWD)/%.o : %.S
 	@test -d $(OUT_PWD) || mkdir -p $(OUT_PWD)
@@ -64,6 +89,29 @@ $(OUT_PWD)/$(PROJECT).elf : $(OBJECTS)
 	@printf "$(COMPCOLOR)µLD %-35s => %s\n$(NORM)" "*.o" $(OUT_PWD)/$(PROJECT).elf
 	$(VERB)$(CC) $(CCFLAGS) $(CCFLAGS_XC) -o $(OUT_PWD)/$(PROJECT).elf $(addprefix $(OUT_PWD)/,$(notdir $(OBJECTS))) $(LIBS) -lc $(LDFLAGS_XC) -Wl,-Map="$(OUT_PWD)/$(PROJECT).map"
 
+# size report per driver and module, from linker map and -fstack-usage files
+# make size-report: prints and writes $(OUT_PWD)/size_report.txt, with deltas
+#   to SIZE_BASELINE if it exists, fails if flash or RAM grows more than
+#   SIZE_THRESHOLD bytes
+# make size-baseline: saves current report as SIZE_BASELINE
+SIZE_BASELINE ?= size_baseline.txt
+SIZE_THRESHOLD ?=
+SIZE_REPORT_AWK := $(UDEVKIT)/support/archi/microchip/size_report.awk
+ifneq (,$(filter size-report size-baseline,$(MAKECMDGOALS)))
+ CCFLAGS_XC += -fstack-usage
+endif
+.PHONY : size-report size-baseline
+size-report : $(OUT_PWD)/$(PROJECT).elf
+	@test -n "$$(ls $(OUT_PWD)/*.su 2>/dev/null)" || echo "$(YELLOW)no stack usage files, run make clean size-report$(NORM)"
+	$(VERB)baseline=$$(ls $(SIZE_BASELINE) 2>/dev/null); \
+	awk -f $(SIZE_REPORT_AWK) -v baseline="$$baseline" -v threshold=$(SIZE_THRESHOLD) \
+		$$baseline $$(ls $(OUT_PWD)/*.d 2>/dev/null) $(OUT_PWD)/$(PROJECT).map $$(ls $(OUT_PWD)/*.su 2>/dev/null) \
+		> $(OUT_PWD)/size_report.txt; status=$$?; cat $(OUT_PWD)/size_report.txt; exit $$status
+size-baseline : size-report
+	@test -d $(dir $(SIZE_BASELINE)) || mkdir -p $(dir $(SIZE_BASELINE))
+	$(VERB)cp $(OUT_PWD)/size_report.txt $(SIZE_BASELINE)
+	@echo "size baseline saved to $(SIZE_BASELINE)"
+
 .PHONY : showmem dbg.% dbg
 # prints memory report
 showmem : $(OUT_PWD)/$(PROJECT).elf
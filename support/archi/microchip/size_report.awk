@@ -0,0 +1,224 @@
+# size_report.awk: flash, RAM and stack usage per driver and module
+#
+# usage: awk -f size_report.awk [-v baseline=<report>] [-v threshold=<bytes>] \
+#            <build>/*.d <build>/<project>.map [<build>/*.su]
+#
+# - .d dependency files give the source path of each object, which gives its
+#   component (driver/<name>, module/<name>, sys, archi, board or project)
+# - the linker map gives the size of each input section kept in the elf,
+#   text/const sections are counted as flash, data/bss sections as RAM
+# - -fstack-usage .su files give the largest stack frame of each component
+# - if baseline is a previous report, size deltas are added and the script
+#   exits with 1 when total flash or RAM grows by more than threshold bytes
+
+function hex2dec(hex,    i, c, value)
+{
+    value = 0
+    hex = tolower(hex)
+    sub(/^0x/, "", hex)
+    for (i = 1; i <= length(hex); i++)
+    {
+        c = index("0123456789abcdef", substr(hex, i, 1))
+        if (c == 0)
+            break
+        value = value * 16 + c - 1
+    }
+    return value
+}
+
+function basename(path)
+{
+    sub(/.*[\/\\]/, "", path)
+    return path
+}
+
+function component(source)
+{
+    if (match(source, /support\/driver\/[^\/]+\//))
+        return "driver/" substr(source, RSTART + 15, RLENGTH - 16)
+    if (match(source, /support\/module\/[^\/]+\//))
+        return "module/" substr(source, RSTART + 15, RLENGTH - 16)
+    if (match(source, /support\/(sys|archi|board|robot)\//))
+        return substr(source, RSTART + 8, RLENGTH - 9)
+    return "project"
+}
+
+# object file or archive member of a map line
+function objectComponent(file,    obj)
+{
+    if (match(file, /\.a\(.*\)$/))
+    {
+        obj = file
+        sub(/\(.*\)$/, "", obj)
+        return "lib/" basename(obj)
+    }
+    obj = basename(file)
+    if (obj in objComponent)
+        return objComponent[obj]
+    return "other"
+}
+
+function account(section, size, file,    comp)
+{
+    if (size == 0 || outSection == "/DISCARD/")
+        return
+    comp = objectComponent(file)
+    if (section ~ /^\.(text|rodata|const|isr|init|fini|dinit|ivt|aivt|reset|vector|romdata|ramfunc|ctors|dtors|eh_frame|gcc_except_table)/)
+        flash[comp] += size
+    else if (section ~ /^\.[npsxy]?(data|bss)/ || section ~ /^COMMON/)
+        ram[comp] += size
+    else
+        return
+    components[comp] = 1
+}
+
+BEGIN {
+    inMap = 0
+    pending = ""
+    if (threshold == "")
+        threshold = -1
+}
+
+FILENAME == baseline {
+    if ($1 != "COMPONENT" && $1 != "TOTAL" && NF >= 4)
+    {
+        baseFlash[$1] = $2
+        baseRam[$1] = $3
+        baseStack[$1] = $4
+        hasBaseline = 1
+    }
+    next
+}
+
+FILENAME ~ /\.d$/ {
+    if (FNR == 1 && NF >= 2)
+    {
+        obj = $1
+        sub(/:$/, "", obj)
+        objComponent[basename(obj)] = component($2)
+    }
+    next
+}
+
+FILENAME ~ /\.map$/ {
+    if (!inMap)
+    {
+        if ($0 ~ /^Linker script and memory map/)
+            inMap = 1
+        next
+    }
+    # output section
+    if ($0 ~ /^[.\/][^ ]*/)
+    {
+        outSection = $1
+        pending = ""
+        next
+    }
+    # input section, on one line or with address, size and file on the next one
+    if ($0 ~ /^ [._A-Za-z]/ && $1 != "*fill*")
+    {
+        if (NF >= 4 && $2 ~ /^0x/ && $3 ~ /^0x/)
+        {
+            account($1, hex2dec($3), $4)
+            pending = ""
+        }
+        else if (NF == 1)
+            pending = $1
+        else
+            pending = ""
+        next
+    }
+    if (pending != "" && NF >= 3 && $1 ~ /^0x/ && $2 ~ /^0x/)
+        account(pending, hex2dec($2), $3)
+    pending = ""
+    next
+}
+
+FILENAME ~ /\.su$/ {
+    # file.c:line:col:function<tab>bytes<tab>qualifiers
+    n = split($0, fields, "\t")
+    if (n >= 2)
+    {
+        obj = basename(FILENAME)
+        sub(/\.su$/, ".o", obj)
+        comp = (obj in objComponent) ? objComponent[obj] : "other"
+        if (fields[2] + 0 > stack[comp] + 0)
+            stack[comp] = fields[2] + 0
+        components[comp] = 1
+        hasStack = 1
+    }
+    next
+}
+
+function delta(value, base)
+{
+    if (value - base == 0)
+        return "="
+    return sprintf("%+d", value - base)
+}
+
+END {
+    if (!inMap)
+    {
+        print "size_report: no linker map found" > "/dev/stderr"
+        exit 2
+    }
+    for (comp in baseFlash)
+        components[comp] = 1
+
+    header = sprintf("%-24s %8s %8s %8s", "COMPONENT", "FLASH", "RAM", "STACK")
+    if (hasBaseline)
+        header = header sprintf(" %8s %8s %8s", "dFLASH", "dRAM", "dSTACK")
+    print header
+
+    # sorted output without asort, for portability between awk flavors
+    count = 0
+    for (comp in components)
+        names[++count] = comp
+    for (i = 2; i <= count; i++)
+    {
+        name = names[i]
+        for (j = i - 1; j > 0 && names[j] > name; j--)
+            names[j + 1] = names[j]
+        names[j + 1] = name
+    }
+
+    for (i = 1; i <= count; i++)
+    {
+        comp = names[i]
+        f = flash[comp] + 0
+        r = ram[comp] + 0
+        s = stack[comp] + 0
+        totalFlash += f
+        totalRam += r
+        if (s > maxStack)
+            maxStack = s
+        line = sprintf("%-24s %8d %8d %8d", comp, f, r, s)
+        if (hasBaseline)
+        {
+            baseTotalFlash += baseFlash[comp]
+            baseTotalRam += baseRam[comp]
+            if (baseStack[comp] + 0 > baseMaxStack)
+                baseMaxStack = baseStack[comp] + 0
+            line = line sprintf(" %8s %8s %8s", delta(f, baseFlash[comp]), delta(r, baseRam[comp]), delta(s, baseStack[comp]))
+        }
+        print line
+    }
+
+    line = sprintf("%-24s %8d %8d %8d", "TOTAL", totalFlash, totalRam, maxStack)
+    if (hasBaseline)
+        line = line sprintf(" %8s %8s %8s", delta(totalFlash, baseTotalFlash), delta(totalRam, baseTotalRam), delta(maxStack, baseMaxStack))
+    print line
+    if (!hasStack)
+        print "size_report: no .su file, stack usage needs -fstack-usage objects" > "/dev/stderr"
+
+    if (hasBaseline && threshold >= 0)
+    {
+        if (totalFlash - baseTotalFlash > threshold || totalRam - baseTotalRam > threshold)
+        {
+            printf("size_report: footprint grows by more than %d bytes (flash %+d, RAM %+d)\n",
+                   threshold, totalFlash - baseTotalFlash, totalRam - baseTotalRam) > "/dev/stderr"
+            exit 1
+        }
+    }
+}
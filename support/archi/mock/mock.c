@@ -0,0 +1,585 @@
+/**
+ * @file mock.c
+ * @author agent
+ * @copyright UniSwarm 2026
+ *
+ * @date October 19, 2026, 09:00 AM
+ *
+ * @brief Host register level mock of PIC32MM GPM to run real drivers on a PC
+ *
+ * Time is counted in peripheral clock cycles. mock_run() advances the models
+ * event by event (end of a character, timer period match) and dispatches the
+ * interrupts raised between two events, so interrupt handlers observe the
+ * same ordering as on the target.
+ */
+
+#include "mock.h"
+
+#include <archi.h>
+
+#include <string.h>
+
+// ============== registers ==============
+volatile uint32_t mock_IFS[2];
+volatile uint32_t mock_IEC[2];
+volatile uint32_t mock_IPC[16];
+
+volatile __UxMODEbits_t mock_UxMODE[MOCK_UART_COUNT];
+volatile uint32_t mock_UxBRG[MOCK_UART_COUNT];
+static volatile __UxSTAbits_t mock_UxSTA[MOCK_UART_COUNT];
+
+volatile __TxCONbits_t mock_TxCON[MOCK_TIMER_COUNT];
+volatile uint32_t mock_TMRx[MOCK_TIMER_COUNT];
+volatile uint32_t mock_PRx[MOCK_TIMER_COUNT];
+
+// ============== interrupt handlers ==============
+// weak references, a driver not linked in the test keeps its handlers NULL
+void T1Interrupt(void) __attribute__((weak));
+void T2Interrupt(void) __attribute__((weak));
+void T3Interrupt(void) __attribute__((weak));
+void U1RXInterrupt(void) __attribute__((weak));
+void U1TXInterrupt(void) __attribute__((weak));
+void U1EInterrupt(void) __attribute__((weak));
+void U2RXInterrupt(void) __attribute__((weak));
+void U2TXInterrupt(void) __attribute__((weak));
+void U2EInterrupt(void) __attribute__((weak));
+void U3RXInterrupt(void) __attribute__((weak));
+void U3TXInterrupt(void) __attribute__((weak));
+void U3EInterrupt(void) __attribute__((weak));
+
+typedef struct
+{
+    uint8_t irq;
+    void (*handler)(void);
+} Mock_Vector;
+
+#define MOCK_VECTOR_COUNT 12
+static Mock_Vector mock_vectors[MOCK_VECTOR_COUNT];
+static uint32_t mock_isrCounter;
+
+// ============== peripheral models ==============
+typedef struct
+{
+    uint16_t txFifo[MOCK_UART_FIFO_DEPTH];
+    uint8_t txHead;
+    uint8_t txLen;
+    uint8_t txPending;  // last pushed slot waits for the value written in txLatch
+    uint16_t txShift;
+    uint32_t txLeft;  // cycles before end of character in shift register, 0 if idle
+
+    uint16_t rxFifo[MOCK_UART_FIFO_DEPTH];
+    uint8_t rxHead;
+    uint8_t rxLen;
+    uint32_t rxLeft;  // cycles before end of character on the line, 0 if idle
+
+    char line[MOCK_UART_LINE_SIZE];  // bytes injected but not received yet
+    size_t lineHead;
+    size_t lineLen;
+
+    uint32_t txLatch;
+    uint32_t rxLatch;
+    void (*txHandler)(uint8_t uart, uint16_t data);
+} Mock_Uart;
+
+typedef struct
+{
+    uint32_t prescalerCount;
+} Mock_Timer;
+
+static Mock_Uart mock_uarts[MOCK_UART_COUNT];
+static Mock_Timer mock_timers[MOCK_TIMER_COUNT];
+static uint64_t mock_cycleCounter;
+
+static const uint16_t mock_timerADiv[4] = {1, 8, 64, 256};
+static const uint16_t mock_timerBDiv[8] = {1, 2, 4, 8, 16, 32, 64, 256};
+
+static void mock_int_set(uint8_t irq);
+static uint8_t mock_int_priority(uint8_t irq);
+static void mock_dispatch(void);
+
+static uint32_t mock_uart_next(uint8_t uart);
+static void mock_uart_step(uint8_t uart, uint32_t cycles);
+static void mock_uart_updateStatus(uint8_t uart);
+static void mock_uart_commitLatch(Mock_Uart *model);
+
+static uint32_t mock_timer_div(uint8_t timer);
+static uint32_t mock_timer_next(uint8_t timer);
+static void mock_timer_step(uint8_t timer, uint32_t cycles);
+
+/**
+ * @brief Puts registers in their power on reset state and clears models
+ */
+void mock_reset(void)
+{
+    uint8_t i;
+
+    memset((void *)mock_IFS, 0, sizeof(mock_IFS));
+    memset((void *)mock_IEC, 0, sizeof(mock_IEC));
+    memset((void *)mock_IPC, 0, sizeof(mock_IPC));
+
+    memset(mock_uarts, 0, sizeof(mock_uarts));
+    for (i = 0; i < MOCK_UART_COUNT; i++)
+    {
+        mock_UxMODE[i].w = 0;
+        mock_UxBRG[i] = 0;
+        mock_UxSTA[i].w = 0;
+        mock_UxSTA[i].TRMT = 1;
+        mock_UxSTA[i].RIDLE = 1;
+    }
+
+    memset(mock_timers, 0, sizeof(mock_timers));
+    for (i = 0; i < MOCK_TIMER_COUNT; i++)
+    {
+        mock_TxCON[i].w = 0;
+        mock_TMRx[i] = 0;
+        mock_PRx[i] = 0xFFFF;
+    }
+
+    mock_vectors[0] = (Mock_Vector){_TIMER_1_VECTOR, T1Interrupt};
+    mock_vectors[1] = (Mock_Vector){_TIMER_2_VECTOR, T2Interrupt};
+    mock_vectors[2] = (Mock_Vector){_TIMER_3_VECTOR, T3Interrupt};
+    mock_vectors[3] = (Mock_Vector){_UART1_RX_VECTOR, U1RXInterrupt};
+    mock_vectors[4] = (Mock_Vector){_UART1_TX_VECTOR, U1TXInterrupt};
+    mock_vectors[5] = (Mock_Vector){_UART1_ERR_VECTOR, U1EInterrupt};
+    mock_vectors[6] = (Mock_Vector){_UART2_RX_VECTOR, U2RXInterrupt};
+    mock_vectors[7] = (Mock_Vector){_UART2_TX_VECTOR, U2TXInterrupt};
+    mock_vectors[8] = (Mock_Vector){_UART2_ERR_VECTOR, U2EInterrupt};
+    mock_vectors[9] = (Mock_Vector){_UART3_RX_VECTOR, U3RXInterrupt};
+    mock_vectors[10] = (Mock_Vector){_UART3_TX_VECTOR, U3TXInterrupt};
+    mock_vectors[11] = (Mock_Vector){_UART3_ERR_VECTOR, U3EInterrupt};
+
+    mock_cycleCounter = 0;
+    mock_isrCounter = 0;
+}
+
+/**
+ * @brief Advances all peripheral models and dispatches interrupts
+ * @param cycles number of peripheral clock cycles to simulate
+ */
+void mock_run(uint32_t cycles)
+{
+    uint8_t i;
+
+    mock_dispatch();
+    while (cycles > 0)
+    {
+        uint32_t step = cycles;
+        for (i = 0; i < MOCK_UART_COUNT; i++)
+        {
+            uint32_t next = mock_uart_next(i);
+            if (next != 0 && next < step)
+            {
+                step = next;
+            }
+        }
+        for (i = 0; i < MOCK_TIMER_COUNT; i++)
+        {
+            uint32_t next = mock_timer_next(i);
+            if (next != 0 && next < step)
+            {
+                step = next;
+            }
+        }
+
+        for (i = 0; i < MOCK_UART_COUNT; i++)
+        {
+            mock_uart_step(i, step);
+        }
+        for (i = 0; i < MOCK_TIMER_COUNT; i++)
+        {
+            mock_timer_step(i, step);
+        }
+        mock_cycleCounter += step;
+        cycles -= step;
+
+        mock_dispatch();
+    }
+}
+
+/**
+ * @brief Number of peripheral clock cycles simulated since last reset
+ * @return cycles count
+ */
+uint64_t mock_cycles(void)
+{
+    return mock_cycleCounter;
+}
+
+/**
+ * @brief Number of interrupt handlers called by the mock since last reset
+ * @return handlers calls count
+ */
+uint32_t mock_isrCount(void)
+{
+    return mock_isrCounter;
+}
+
+static void mock_int_set(uint8_t irq)
+{
+    mock_IFS[irq >> 5] |= (1U << (irq & 0x1F));
+}
+
+static uint8_t mock_int_priority(uint8_t irq)
+{
+    return (mock_IPC[irq >> 2] >> (((irq & 0x03) << 3) + 2)) & 0x07;
+}
+
+/**
+ * @brief Calls the handlers of pending and enabled interrupts, highest
+ * priority first then lowest vector number, as the interrupt controller does
+ */
+static void mock_dispatch(void)
+{
+    uint8_t i;
+    uint16_t guard;
+
+    for (guard = 0; guard < 1024; guard++)
+    {
+        Mock_Vector *vector = NULL;
+        uint8_t priority = 0;
+
+        for (i = 0; i < MOCK_VECTOR_COUNT; i++)
+        {
+            uint8_t irq = mock_vectors[i].irq;
+            uint32_t mask = 1U << (irq & 0x1F);
+            if ((mock_IFS[irq >> 5] & mask) == 0 || (mock_IEC[irq >> 5] & mask) == 0)
+            {
+                continue;
+            }
+            if (mock_vectors[i].handler == NULL || mock_int_priority(irq) <= priority)
+            {
+                continue;
+            }
+            priority = mock_int_priority(irq);
+            vector = &mock_vectors[i];
+        }
+        if (vector == NULL)
+        {
+            return;
+        }
+
+        mock_isrCounter++;
+        vector->handler();
+        if (vector->irq >= _UART1_RX_VECTOR)
+        {
+            // handlers change fifo state, level interrupts follow it
+            mock_uart_updateStatus((vector->irq - _UART1_RX_VECTOR) / 3);
+        }
+    }
+}
+
+/**
+ * @brief Sets the function called at the end of each character sent on the
+ * line by the uart
+ * @param uart uart index, 0 for UART1
+ * @param handler function or NULL
+ */
+void mock_uart_setTxHandler(uint8_t uart, void (*handler)(uint8_t uart, uint16_t data))
+{
+    if (uart >= MOCK_UART_COUNT)
+    {
+        return;
+    }
+    mock_uarts[uart].txHandler = handler;
+}
+
+/**
+ * @brief Puts data on the RX line of the uart, each byte is received after
+ * one character time
+ * @param uart uart index, 0 for UART1
+ * @param data data to receive
+ * @param size size of data
+ * @return number of bytes accepted by the line
+ */
+size_t mock_uart_inject(uint8_t uart, const char *data, size_t size)
+{
+    Mock_Uart *model;
+    size_t i;
+
+    if (uart >= MOCK_UART_COUNT)
+    {
+        return 0;
+    }
+    model = &mock_uarts[uart];
+    for (i = 0; i < size && model->lineLen < MOCK_UART_LINE_SIZE; i++)
+    {
+        model->line[(model->lineHead + model->lineLen) % MOCK_UART_LINE_SIZE] = data[i];
+        model->lineLen++;
+    }
+    return i;
+}
+
+/**
+ * @brief Duration of one character with current uart settings
+ * @param uart uart index, 0 for UART1
+ * @return number of peripheral clock cycles for start, data, parity and stop bits
+ */
+uint32_t mock_uart_frameCycles(uint8_t uart)
+{
+    uint32_t bits;
+
+    if (uart >= MOCK_UART_COUNT)
+    {
+        return 0;
+    }
+    bits = 1 + 8 + 1;  // start, data, stop
+    if (mock_UxMODE[uart].PDSEL == 0b01 || mock_UxMODE[uart].PDSEL == 0b10 || mock_UxMODE[uart].PDSEL == 0b11)
+    {
+        bits++;  // parity or 9th bit
+    }
+    if (mock_UxMODE[uart].STSEL == 1)
+    {
+        bits++;
+    }
+    return bits * (mock_UxMODE[uart].BRGH ? 4 : 16) * (mock_UxBRG[uart] + 1);
+}
+
+/**
+ * @brief UxSTA read/write hook, refreshes hardware driven bits
+ * @param uart uart index
+ * @return pointer to status register
+ */
+volatile __UxSTAbits_t *mock_uart_sta(uint8_t uart)
+{
+    mock_uart_updateStatus(uart);
+    return &mock_UxSTA[uart];
+}
+
+/**
+ * @brief UxTXREG write hook, each access pushes one slot in TX fifo
+ * @param uart uart index
+ * @return pointer to the slot that will receive written data
+ */
+volatile uint32_t *mock_uart_txreg(uint8_t uart)
+{
+    Mock_Uart *model = &mock_uarts[uart];
+
+    mock_uart_commitLatch(model);
+    if (model->txLen >= MOCK_UART_FIFO_DEPTH || mock_UxMODE[uart].ON == 0)
+    {
+        return &model->txLatch;  // write lost as on hardware
+    }
+
+    // latch is copied in the pushed slot by the next access to the model
+    model->txLen++;
+    model->txPending = 1;
+    return &model->txLatch;
+}
+
+/**
+ * @brief UxRXREG read hook, each access pops one data of RX fifo
+ * @param uart uart index
+ * @return pointer to the popped data
+ */
+volatile uint32_t *mock_uart_rxreg(uint8_t uart)
+{
+    Mock_Uart *model = &mock_uarts[uart];
+
+    if (model->rxLen > 0)
+    {
+        model->rxLatch = model->rxFifo[model->rxHead];
+        model->rxHead = (model->rxHead + 1) % MOCK_UART_FIFO_DEPTH;
+        model->rxLen--;
+    }
+    mock_uart_updateStatus(uart);
+    return &model->rxLatch;
+}
+
+static void mock_uart_commitLatch(Mock_Uart *model)
+{
+    if (model->txPending == 0)
+    {
+        return;
+    }
+    model->txFifo[(model->txHead + model->txLen - 1) % MOCK_UART_FIFO_DEPTH] = model->txLatch & 0x01FF;
+    model->txPending = 0;
+}
+
+static void mock_uart_updateStatus(uint8_t uart)
+{
+    Mock_Uart *model = &mock_uarts[uart];
+    volatile __UxSTAbits_t *sta = &mock_UxSTA[uart];
+    uint8_t txIrq = _UART1_TX_VECTOR + uart * 3;
+    uint8_t rxIrq = _UART1_RX_VECTOR + uart * 3;
+    uint8_t rxLevel;
+
+    mock_uart_commitLatch(model);
+
+    sta->URXDA = (model->rxLen > 0) ? 1 : 0;
+    sta->UTXBF = (model->txLen >= MOCK_UART_FIFO_DEPTH) ? 1 : 0;
+    sta->TRMT = (model->txLen == 0 && model->txLeft == 0) ? 1 : 0;
+    sta->RIDLE = (model->rxLeft == 0) ? 1 : 0;
+
+    if (mock_UxMODE[uart].ON == 0)
+    {
+        return;
+    }
+
+    // TX interrupt is a level on fifo state selected by UTXISEL
+    if ((sta->UTXISEL == 0b00 && model->txLen < MOCK_UART_FIFO_DEPTH) || (sta->UTXISEL == 0b01 && sta->TRMT == 1)
+        || (sta->UTXISEL == 0b10 && model->txLen == 0))
+    {
+        mock_int_set(txIrq);
+    }
+
+    // RX interrupt is a level on fifo fill selected by URXISEL
+    rxLevel = 1;
+    if (sta->URXISEL == 0b01)
+    {
+        rxLevel = MOCK_UART_FIFO_DEPTH / 2;
+    }
+    else if (sta->URXISEL >= 0b10)
+    {
+        rxLevel = MOCK_UART_FIFO_DEPTH - 1;
+    }
+    if (model->rxLen >= rxLevel)
+    {
+        mock_int_set(rxIrq);
+    }
+}
+
+static uint32_t mock_uart_next(uint8_t uart)
+{
+    Mock_Uart *model = &mock_uarts[uart];
+    uint32_t next = 0;
+
+    if (mock_UxMODE[uart].ON == 0)
+    {
+        return 0;
+    }
+    if (mock_UxSTA[uart].UTXEN == 1 && (model->txLeft != 0 || model->txLen != 0))
+    {
+        next = (model->txLeft != 0) ? model->txLeft : mock_uart_frameCycles(uart);
+    }
+    if (mock_UxSTA[uart].URXEN == 1 && (model->rxLeft != 0 || model->lineLen != 0))
+    {
+        uint32_t rxNext = (model->rxLeft != 0) ? model->rxLeft : mock_uart_frameCycles(uart);
+        if (next == 0 || rxNext < next)
+        {
+            next = rxNext;
+        }
+    }
+    return next;
+}
+
+static void mock_uart_step(uint8_t uart, uint32_t cycles)
+{
+    Mock_Uart *model = &mock_uarts[uart];
+
+    if (mock_UxMODE[uart].ON == 0)
+    {
+        return;
+    }
+    mock_uart_commitLatch(model);
+
+    // transmitter: shift register loads from fifo, then shifts one frame
+    if (mock_UxSTA[uart].UTXEN == 1)
+    {
+        if (model->txLeft == 0 && model->txLen != 0)
+        {
+            model->txShift = model->txFifo[model->txHead];
+            model->txHead = (model->txHead + 1) % MOCK_UART_FIFO_DEPTH;
+            model->txLen--;
+            model->txLeft = mock_uart_frameCycles(uart);
+        }
+        if (model->txLeft != 0)
+        {
+            if (cycles >= model->txLeft)
+            {
+                model->txLeft = 0;
+                if (model->txHandler != NULL)
+                {
+                    model->txHandler(uart, model->txShift);
+                }
+            }
+            else
+            {
+                model->txLeft -= cycles;
+            }
+        }
+    }
+
+    // receiver: one byte of the line per frame, overrun when fifo is full
+    if (mock_UxSTA[uart].URXEN == 1)
+    {
+        if (model->rxLeft == 0 && model->lineLen != 0)
+        {
+            model->rxLeft = mock_uart_frameCycles(uart);
+        }
+        if (model->rxLeft != 0)
+        {
+            if (cycles >= model->rxLeft)
+            {
+                uint8_t data = (uint8_t)model->line[model->lineHead];
+                model->lineHead = (model->lineHead + 1) % MOCK_UART_LINE_SIZE;
+                model->lineLen--;
+                model->rxLeft = 0;
+                if (model->rxLen < MOCK_UART_FIFO_DEPTH)
+                {
+                    model->rxFifo[(model->rxHead + model->rxLen) % MOCK_UART_FIFO_DEPTH] = data;
+                    model->rxLen++;
+                }
+                else
+                {
+                    mock_UxSTA[uart].OERR = 1;
+                    mock_int_set(_UART1_ERR_VECTOR + uart * 3);
+                }
+            }
+            else
+            {
+                model->rxLeft -= cycles;
+            }
+        }
+    }
+
+    mock_uart_updateStatus(uart);
+}
+
+static uint32_t mock_timer_div(uint8_t timer)
+{
+    if (timer == 0)
+    {
+        return mock_timerADiv[mock_TxCON[0].TCKPS & 0x03];
+    }
+    return mock_timerBDiv[mock_TxCON[timer].TCKPS];
+}
+
+static uint32_t mock_timer_next(uint8_t timer)
+{
+    uint32_t top;
+
+    if (mock_TxCON[timer].ON == 0 || mock_TxCON[timer].TCS == 1)
+    {
+        return 0;
+    }
+    top = (mock_TMRx[timer] > mock_PRx[timer]) ? 0xFFFF : mock_PRx[timer];
+    return (top - mock_TMRx[timer] + 1) * mock_timer_div(timer) - mock_timers[timer].prescalerCount;
+}
+
+static void mock_timer_step(uint8_t timer, uint32_t cycles)
+{
+    Mock_Timer *model = &mock_timers[timer];
+    uint32_t div, ticks, top;
+
+    if (mock_TxCON[timer].ON == 0 || mock_TxCON[timer].TCS == 1)
+    {
+        return;
+    }
+
+    div = mock_timer_div(timer);
+    model->prescalerCount += cycles;
+    ticks = model->prescalerCount / div;
+    model->prescalerCount %= div;
+
+    top = (mock_TMRx[timer] > mock_PRx[timer]) ? 0xFFFF : mock_PRx[timer];
+    if (mock_TMRx[timer] + ticks > top)
+    {
+        // period match, steps never cross more than one match
+        mock_TMRx[timer] = mock_TMRx[timer] + ticks - top - 1;
+        mock_int_set(_TIMER_1_VECTOR + timer);
+    }
+    else
+    {
+        mock_TMRx[timer] += ticks;
+    }
+}
@@ -0,0 +1,51 @@
+/**
+ * @file mock.h
+ * @author agent
+ * @copyright UniSwarm 2026
+ *
+ * @date October 19, 2026, 09:00 AM
+ *
+ * @brief Host register level mock of PIC32MM GPM to run real drivers on a PC
+ *
+ * Registers are RAM variables and peripherals are cycle approximated models
+ * advanced by mock_run(). Pending and enabled interrupts are dispatched by
+ * priority to the driver handlers (U1TXInterrupt, T1Interrupt...), which can
+ * also be called directly.
+ */
+
+#ifndef MOCK_H
+#define MOCK_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifndef MOCK_UART_FIFO_DEPTH
+#    define MOCK_UART_FIFO_DEPTH 8
+#endif
+#ifndef MOCK_UART_LINE_SIZE
+#    define MOCK_UART_LINE_SIZE 256
+#endif
+
+    // ======== core ========
+    void mock_reset(void);
+    void mock_run(uint32_t cycles);
+    uint64_t mock_cycles(void);
+    uint32_t mock_isrCount(void);
+
+    // ======== uart model ========
+    void mock_uart_setTxHandler(uint8_t uart, void (*handler)(uint8_t uart, uint16_t data));
+    size_t mock_uart_inject(uint8_t uart, const char *data, size_t size);
+    uint32_t mock_uart_frameCycles(uint8_t uart);
+
+#define archi_init() mock_reset()
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // MOCK_H
@@ -0,0 +1,42 @@
+# host build of real drivers against the register level mock of mock.c
+# only PIC32MM GPM devices are modeled
+
+CC_MOCK ?= gcc
+OUT_MOCK_PWD ?= build-mock
+MOCK_EXE := $(PROJECT)_mock
+
+MOCK_PATH := $(UDEVKIT)/support/archi/mock
+DEFINES_MOCK += -D MOCK -I $(MOCK_PATH)/xc -I $(MOCK_PATH)
+
+# drivers with a register model, other drivers use their simulator version
+MOCK_DRIVERS_SRC := uart_pic32mz_mm_mk.c timer_pic32.c
+MOCK_SIM_SRC := sysclock_sim.c
+
+vpath %.c $(MOCK_PATH)
+MOCK_SRC += mock.c $(filter $(MOCK_DRIVERS_SRC),$(ARCHI_SRC)) $(filter $(MOCK_SIM_SRC),$(SIM_SRC))
+HEADER += mock.h
+
+MOCK_OBJECTS := $(addprefix $(OUT_MOCK_PWD)/, $(notdir $(SRC:.c=.o) $(MOCK_SRC:.c=.o)))
+$(MOCK_OBJECTS) : $(CONFIG_HEADERS)
+
+# rule to build OBJECTS to OUT_MOCK_PWD and give dependencies
+$(OUT_MOCK_PWD)/%.o : %.c
+	@test -d $(OUT_MOCK_PWD) || mkdir -p $(OUT_MOCK_PWD)
+	@printf "$(COMPCOLOR)CC %-36s => %s$(NORM)\n" $(notdir $<) $(OUT_MOCK_PWD)/$(notdir $@)
+	$(VERB)$(CC_MOCK) -Wall -c $< $(DEFINES) $(DEFINES_MOCK) $(INCLUDEPATH) -o $(OUT_MOCK_PWD)/$(notdir $@)
+	@$(CC_MOCK) -MM $< $(DEFINES) $(DEFINES_MOCK) $(INCLUDEPATH) -MT $(OUT_MOCK_PWD)/$(notdir $@) > $(OUT_MOCK_PWD)/$*_mock.d
+
+# rule to link MOCK_OBJECTS to an executable in OUT_MOCK_PWD
+$(OUT_MOCK_PWD)/$(MOCK_EXE) : $(MOCK_OBJECTS)
+	@printf "$(COMPCOLOR)LD %-36s => %s$(NORM)\n" "*.o" $(OUT_MOCK_PWD)/$(MOCK_EXE)
+	$(VERB)$(CC_MOCK) -o $(OUT_MOCK_PWD)/$(MOCK_EXE) $(addprefix $(OUT_MOCK_PWD)/,$(notdir $(MOCK_OBJECTS))) -lm
+
+mock-exe: $(OUT_MOCK_PWD)/$(MOCK_EXE)
+
+mock: mock-exe
+	$(OUT_MOCK_PWD)/$(MOCK_EXE)
+
+clean: mock-clean
+mock-clean :
+	rm -f $(OUT_MOCK_PWD)/*.o $(OUT_MOCK_PWD)/*.d
+	rm -f $(OUT_MOCK_PWD)/$(MOCK_EXE)
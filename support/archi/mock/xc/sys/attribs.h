@@ -0,0 +1,19 @@
+/**
+ * @file attribs.h
+ * @author agent
+ * @copyright UniSwarm 2026
+ *
+ * @date October 19, 2026, 09:00 AM
+ *
+ * @brief Host replacement of XC32 sys/attribs.h for mock architecture
+ *
+ * Interrupt handlers become plain functions that mock.c or a test can call.
+ */
+
+#ifndef MOCK_SYS_ATTRIBS_H
+#define MOCK_SYS_ATTRIBS_H
+
+#define __ISR(vector, ipl)
+#define __ISR_AT_VECTOR(vector, ipl)
+
+#endif  // MOCK_SYS_ATTRIBS_H
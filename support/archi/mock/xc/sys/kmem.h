@@ -0,0 +1,20 @@
+/**
+ * @file kmem.h
+ * @author agent
+ * @copyright UniSwarm 2026
+ *
+ * @date October 19, 2026, 09:00 AM
+ *
+ * @brief Host replacement of XC32 sys/kmem.h for mock architecture
+ */
+
+#ifndef MOCK_SYS_KMEM_H
+#define MOCK_SYS_KMEM_H
+
+#include <stdint.h>
+
+#define KVA_TO_PA(v)   ((uintptr_t)(v))
+#define PA_TO_KVA0(pa) ((void *)(pa))
+#define PA_TO_KVA1(pa) ((void *)(pa))
+
+#endif  // MOCK_SYS_KMEM_H
@@ -0,0 +1,326 @@
+/**
+ * @file xc.h
+ * @author agent
+ * @copyright UniSwarm 2026
+ *
+ * @date October 19, 2026, 09:00 AM
+ *
+ * @brief Host replacement of XC32 xc.h for mock architecture
+ *
+ * Declares the subset of PIC32MM GPM special function registers used by the
+ * uart and timer drivers. Registers are RAM variables owned by mock.c, status
+ * and data registers of the UARTs are accessed through hooks so that the
+ * peripheral models see each read and write.
+ */
+
+#ifndef MOCK_XC_H
+#define MOCK_XC_H
+
+#include <stdint.h>
+
+#if !defined(DEVICE_32MM0064GPM028) && !defined(DEVICE_32MM0064GPM036) && !defined(DEVICE_32MM0064GPM048)              \
+    && !defined(DEVICE_32MM0064GPM064) && !defined(DEVICE_32MM0128GPM028) && !defined(DEVICE_32MM0128GPM036)           \
+    && !defined(DEVICE_32MM0128GPM048) && !defined(DEVICE_32MM0128GPM064) && !defined(DEVICE_32MM0256GPM028)           \
+    && !defined(DEVICE_32MM0256GPM036) && !defined(DEVICE_32MM0256GPM048) && !defined(DEVICE_32MM0256GPM064)
+#    error "mock architecture only models PIC32MM GPM devices"
+#endif
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define MOCK_UART_COUNT  3
+#define MOCK_TIMER_COUNT 3
+
+// ============== interrupt vectors ==============
+#define _TIMER_1_VECTOR 17
+#define _TIMER_2_VECTOR 18
+#define _TIMER_3_VECTOR 19
+#define _UART1_RX_VECTOR 53
+#define _UART1_TX_VECTOR 54
+#define _UART1_ERR_VECTOR 55
+#define _UART2_RX_VECTOR 56
+#define _UART2_TX_VECTOR 57
+#define _UART2_ERR_VECTOR 58
+#define _UART3_RX_VECTOR 59
+#define _UART3_TX_VECTOR 60
+#define _UART3_ERR_VECTOR 61
+
+// ============== interrupt controller ==============
+typedef union
+{
+    struct
+    {
+        uint32_t : 17;
+        uint32_t T1IF : 1;
+        uint32_t T2IF : 1;
+        uint32_t T3IF : 1;
+        uint32_t : 12;
+    };
+    uint32_t w;
+} __IFS0bits_t;
+
+typedef union
+{
+    struct
+    {
+        uint32_t : 17;
+        uint32_t T1IE : 1;
+        uint32_t T2IE : 1;
+        uint32_t T3IE : 1;
+        uint32_t : 12;
+    };
+    uint32_t w;
+} __IEC0bits_t;
+
+typedef union
+{
+    struct
+    {
+        uint32_t : 21;
+        uint32_t U1RXIF : 1;
+        uint32_t U1TXIF : 1;
+        uint32_t U1EIF : 1;
+        uint32_t U2RXIF : 1;
+        uint32_t U2TXIF : 1;
+        uint32_t U2EIF : 1;
+        uint32_t U3RXIF : 1;
+        uint32_t U3TXIF : 1;
+        uint32_t U3EIF : 1;
+        uint32_t : 2;
+    };
+    uint32_t w;
+} __IFS1bits_t;
+
+typedef union
+{
+    struct
+    {
+        uint32_t : 21;
+        uint32_t U1RXIE : 1;
+        uint32_t U1TXIE : 1;
+        uint32_t U1EIE : 1;
+        uint32_t U2RXIE : 1;
+        uint32_t U2TXIE : 1;
+        uint32_t U2EIE : 1;
+        uint32_t U3RXIE : 1;
+        uint32_t U3TXIE : 1;
+        uint32_t U3EIE : 1;
+        uint32_t : 2;
+    };
+    uint32_t w;
+} __IEC1bits_t;
+
+typedef union
+{
+    struct
+    {
+        uint32_t : 8;
+        uint32_t T1IS : 2;
+        uint32_t T1IP : 3;
+        uint32_t : 3;
+        uint32_t T2IS : 2;
+        uint32_t T2IP : 3;
+        uint32_t : 3;
+        uint32_t T3IS : 2;
+        uint32_t T3IP : 3;
+        uint32_t : 3;
+    };
+    uint32_t w;
+} __IPC4bits_t;
+
+typedef union
+{
+    struct
+    {
+        uint32_t : 8;
+        uint32_t U1RXIS : 2;
+        uint32_t U1RXIP : 3;
+        uint32_t : 3;
+        uint32_t U1TXIS : 2;
+        uint32_t U1TXIP : 3;
+        uint32_t : 3;
+        uint32_t U1EIS : 2;
+        uint32_t U1EIP : 3;
+        uint32_t : 3;
+    };
+    uint32_t w;
+} __IPC13bits_t;
+
+typedef union
+{
+    struct
+    {
+        uint32_t U2RXIS : 2;
+        uint32_t U2RXIP : 3;
+        uint32_t : 3;
+        uint32_t U2TXIS : 2;
+        uint32_t U2TXIP : 3;
+        uint32_t : 3;
+        uint32_t U2EIS : 2;
+        uint32_t U2EIP : 3;
+        uint32_t : 3;
+        uint32_t U3RXIS : 2;
+        uint32_t U3RXIP : 3;
+        uint32_t : 3;
+    };
+    uint32_t w;
+} __IPC14bits_t;
+
+typedef union
+{
+    struct
+    {
+        uint32_t U3TXIS : 2;
+        uint32_t U3TXIP : 3;
+        uint32_t : 3;
+        uint32_t U3EIS : 2;
+        uint32_t U3EIP : 3;
+        uint32_t : 19;
+    };
+    uint32_t w;
+} __IPC15bits_t;
+
+extern volatile uint32_t mock_IFS[2];
+extern volatile uint32_t mock_IEC[2];
+extern volatile uint32_t mock_IPC[16];
+
+#define IFS0bits  (*(volatile __IFS0bits_t *)&mock_IFS[0])
+#define IFS1bits  (*(volatile __IFS1bits_t *)&mock_IFS[1])
+#define IEC0bits  (*(volatile __IEC0bits_t *)&mock_IEC[0])
+#define IEC1bits  (*(volatile __IEC1bits_t *)&mock_IEC[1])
+#define IPC4bits  (*(volatile __IPC4bits_t *)&mock_IPC[4])
+#define IPC13bits (*(volatile __IPC13bits_t *)&mock_IPC[13])
+#define IPC14bits (*(volatile __IPC14bits_t *)&mock_IPC[14])
+#define IPC15bits (*(volatile __IPC15bits_t *)&mock_IPC[15])
+#define IFS0      mock_IFS[0]
+#define IFS1      mock_IFS[1]
+#define IEC0      mock_IEC[0]
+#define IEC1      mock_IEC[1]
+
+// ============== uart ==============
+typedef union
+{
+    struct
+    {
+        uint32_t STSEL : 1;
+        uint32_t PDSEL : 2;
+        uint32_t BRGH : 1;
+        uint32_t RXINV : 1;
+        uint32_t ABAUD : 1;
+        uint32_t LPBACK : 1;
+        uint32_t WAKE : 1;
+        uint32_t UEN : 2;
+        uint32_t : 1;
+        uint32_t RTSMD : 1;
+        uint32_t IREN : 1;
+        uint32_t SIDL : 1;
+        uint32_t : 1;
+        uint32_t ON : 1;
+        uint32_t : 16;
+    };
+    struct
+    {
+        uint32_t : 15;
+        uint32_t UARTEN : 1;
+        uint32_t : 16;
+    };
+    uint32_t w;
+} __UxMODEbits_t;
+
+typedef union
+{
+    struct
+    {
+        uint32_t URXDA : 1;
+        uint32_t OERR : 1;
+        uint32_t FERR : 1;
+        uint32_t PERR : 1;
+        uint32_t RIDLE : 1;
+        uint32_t ADDEN : 1;
+        uint32_t URXISEL : 2;
+        uint32_t TRMT : 1;
+        uint32_t UTXBF : 1;
+        uint32_t UTXEN : 1;
+        uint32_t UTXBRK : 1;
+        uint32_t URXEN : 1;
+        uint32_t UTXINV : 1;
+        uint32_t UTXISEL : 2;
+        uint32_t : 16;
+    };
+    uint32_t w;
+} __UxSTAbits_t;
+
+extern volatile __UxMODEbits_t mock_UxMODE[MOCK_UART_COUNT];
+extern volatile uint32_t mock_UxBRG[MOCK_UART_COUNT];
+volatile __UxSTAbits_t *mock_uart_sta(uint8_t uart);
+volatile uint32_t *mock_uart_txreg(uint8_t uart);
+volatile uint32_t *mock_uart_rxreg(uint8_t uart);
+
+#define U1MODEbits mock_UxMODE[0]
+#define U1MODE     mock_UxMODE[0].w
+#define U1BRG      mock_UxBRG[0]
+#define U1STAbits  (*mock_uart_sta(0))
+#define U1STA      (mock_uart_sta(0)->w)
+#define U1TXREG    (*mock_uart_txreg(0))
+#define U1RXREG    (*mock_uart_rxreg(0))
+#define U2MODEbits mock_UxMODE[1]
+#define U2MODE     mock_UxMODE[1].w
+#define U2BRG      mock_UxBRG[1]
+#define U2STAbits  (*mock_uart_sta(1))
+#define U2STA      (mock_uart_sta(1)->w)
+#define U2TXREG    (*mock_uart_txreg(1))
+#define U2RXREG    (*mock_uart_rxreg(1))
+#define U3MODEbits mock_UxMODE[2]
+#define U3MODE     mock_UxMODE[2].w
+#define U3BRG      mock_UxBRG[2]
+#define U3STAbits  (*mock_uart_sta(2))
+#define U3STA      (mock_uart_sta(2)->w)
+#define U3TXREG    (*mock_uart_txreg(2))
+#define U3RXREG    (*mock_uart_rxreg(2))
+
+// ============== timers ==============
+// type A (timer 1) only uses the two lower bits of TCKPS and TSYNC, type B
+// (timers 2 and 3) uses the three bits of TCKPS and T32
+typedef union
+{
+    struct
+    {
+        uint32_t : 1;
+        uint32_t TCS : 1;
+        uint32_t TSYNC : 1;
+        uint32_t T32 : 1;
+        uint32_t TCKPS : 3;
+        uint32_t TGATE : 1;
+        uint32_t : 5;
+        uint32_t SIDL : 1;
+        uint32_t : 1;
+        uint32_t ON : 1;
+        uint32_t : 16;
+    };
+    uint32_t w;
+} __TxCONbits_t;
+
+extern volatile __TxCONbits_t mock_TxCON[MOCK_TIMER_COUNT];
+extern volatile uint32_t mock_TMRx[MOCK_TIMER_COUNT];
+extern volatile uint32_t mock_PRx[MOCK_TIMER_COUNT];
+
+#define T1CONbits mock_TxCON[0]
+#define T1CON     mock_TxCON[0].w
+#define TMR1      mock_TMRx[0]
+#define PR1       mock_PRx[0]
+#define T2CONbits mock_TxCON[1]
+#define T2CON     mock_TxCON[1].w
+#define TMR2      mock_TMRx[1]
+#define PR2       mock_PRx[1]
+#define T3CONbits mock_TxCON[2]
+#define T3CON     mock_TxCON[2].w
+#define TMR3      mock_TMRx[2]
+#define PR3       mock_PRx[2]
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // MOCK_XC_H
@@ -59,6 +59,19 @@
 #        define disable_interrupt() __builtin_disi(0x3FFF)
 #    endif
 
+// nestable critical section, usable in interrupts : raises the CPU priority to 7 and restores
+// the saved one, DISI and GIE are left untouched. Idle still wakes up on a masked interrupt.
+#    define disable_interrupt_save(state)                                                                              \
+        do                                                                                                             \
+        {                                                                                                              \
+            SET_AND_SAVE_CPU_IPL(state, 7);                                                                            \
+        } while (0)
+#    define restore_interrupt(state)                                                                                   \
+        do                                                                                                             \
+        {                                                                                                              \
+            RESTORE_CPU_IPL(state);                                                                                    \
+        } while (0)
+
 #    define archi_init()                                                                                               \
         {                                                                                                              \
         }
@@ -74,6 +87,8 @@
 #    define disable_interrupt()                                                                                        \
         {                                                                                                              \
         }
+#    define disable_interrupt_save(state) (state) = 0
+#    define restore_interrupt(state)      (void)(state)
 #    define unlockClockConfig()                                                                                        \
         {                                                                                                              \
         }
@@ -25,10 +25,24 @@
 #        define disable_interrupt()                                                                                    \
             {                                                                                                          \
             }
+#        define disable_interrupt_save(state) (state) = 0
+#        define restore_interrupt(state)      (void)(state)
 #    else
 #        define nop()               _nop()
 #        define enable_interrupt()  __builtin_enable_interrupts()
 #        define disable_interrupt() __builtin_disable_interrupts()
+
+// nestable critical section, usable in interrupts : saves Status and enables interrupts back
+// only if IE was set. Wait still wakes up on a masked interrupt on M4K and microAptiv cores.
+#        define disable_interrupt_save(state) (state) = __builtin_disable_interrupts()
+#        define restore_interrupt(state)                                                                               \
+            do                                                                                                         \
+            {                                                                                                          \
+                if ((state) & 1)                                                                                       \
+                {                                                                                                      \
+                    __builtin_enable_interrupts();                                                                     \
+                }                                                                                                      \
+            } while (0)
 #    endif
 #    include <sys/attribs.h>
 #    include <sys/kmem.h>
@@ -66,6 +80,8 @@
 #    define disable_interrupt()                                                                                        \
         {                                                                                                              \
         }
+#    define disable_interrupt_save(state) (state) = 0
+#    define restore_interrupt(state)      (void)(state)
 
 #    define unlockConfig()                                                                                             \
         {                                                                                                              \
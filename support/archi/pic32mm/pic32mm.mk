@@ -3,3 +3,5 @@ vpath %.c $(UDEVKIT)/support/archi/pic32mm/
 ARCHI_SRC += pic32mm.c
 
 include $(UDEVKIT)/support/archi/pic32/pic32.mk
+
+include $(UDEVKIT)/support/archi/mock/mock.mk
@@ -13,9 +13,12 @@
 
 #include "simulator_pthread.h"
 #include "simulator_socket.h"
+#include "simulator_cycles.h"
+#include "simulator_trace.h"
 
 #include <signal.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include <iostream>
@@ -23,7 +26,15 @@
 #include <queue>
 #include <vector>
 
-static std::map<uint64_t, std::queue<std::vector<char>>> packages;
+typedef struct
+{
+    std::vector<char> data;
+    uint64_t timeUs;  // reception time, for trace latency
+} simulator_package;
+
+static std::map<uint64_t, std::queue<simulator_package>> packages;
+// packages are received by drivers rx threads as well as by the main thread
+static pthread_mutex_t packagesMutex = PTHREAD_MUTEX_INITIALIZER;
 
 void simulator_init()
 {
@@ -31,13 +42,23 @@ void simulator_init()
     setbuf(stdout, NULL);
     // signal(SIGTERM, simulator_end);
 
+    simulator_trace_init();
     simulator_socket_init();
     simulator_pthread_init();
+
+    // board name used by udk-sim topology to route peripherals between instances
+    const char *boardName = getenv("UDK_SIM_BOARD");
+    if (boardName != NULL)
+    {
+        simulator_send(SIMULATOR_MODULE, 0, SIMULATOR_BOARD_NAME, boardName, strlen(boardName));
+    }
 }
 
 void simulator_end()
 {
     simulator_socket_end();
+    simulator_trace_end();
+    simulator_cycles_end();
     puts("end simulator execution\n");
 }
 
@@ -49,43 +70,56 @@ void simulator_send(uint16_t moduleId, uint16_t periphId, uint16_t functionId, c
     ((unsigned short *)simDat)[2] = periphId;
     ((unsigned short *)simDat)[3] = functionId;
     memcpy(simDat + 8, data, size);
+    simulator_trace_packet(SIMULATOR_TRACE_SEND, moduleId, periphId, functionId, size);
     simulator_socket_send(simDat, size + 8);
     free(simDat);
 }
 
 int simulator_rec_task()
 {
-    char data[2048];
+    // socket data are a stream, a packet may be split between two reads
+    static char data[4096];
+    static size_t dataSize = 0;
+    size_t offset;
     uint16_t sizePacket, moduleId, periphId, functionId;
     ssize_t size;
 
-    // TODO debug this for multiple packet at the same time
-    while ((size = simulator_socket_read(data, 2048)) >= 8)
+    pthread_mutex_lock(&packagesMutex);
+    while ((size = simulator_socket_read(data + dataSize, sizeof(data) - dataSize)) > 0)
     {
-        sizePacket = ((uint16_t *)data)[0];
-        moduleId = ((uint16_t *)data)[1];
-        periphId = ((uint16_t *)data)[2];
-        functionId = ((uint16_t *)data)[3];
-
-        std::vector<char> dataPacket(data + 8, data + sizePacket);
-        uint64_t key = ((uint64_t)moduleId << 32) + ((uint64_t)periphId << 16) + functionId;
-        std::map<uint64_t, std::queue<std::vector<char>>>::iterator it = packages.find(key);
-
-        if (it == packages.end())
+        dataSize += size;
+        offset = 0;
+        while (dataSize - offset >= 8)
         {
-            std::queue<std::vector<char>> queue;
-            queue.push(dataPacket);
-            packages.insert(std::pair<uint64_t, std::queue<std::vector<char>>>(key, queue));
+            sizePacket = ((uint16_t *)(data + offset))[0];
+            moduleId = ((uint16_t *)(data + offset))[1];
+            periphId = ((uint16_t *)(data + offset))[2];
+            functionId = ((uint16_t *)(data + offset))[3];
+            if (sizePacket < 8 || sizePacket > sizeof(data))
+            {
+                offset = dataSize;  // out of sync, drops received data
+                break;
+            }
+            if (sizePacket > dataSize - offset)
+            {
+                break;
+            }
+
+            simulator_package package;
+            package.data.assign(data + offset + 8, data + offset + sizePacket);
+            package.timeUs = simulator_trace_enabled() ? simulator_trace_timeUs() : 0;
+            simulator_trace_packet(SIMULATOR_TRACE_RECV, moduleId, periphId, functionId, sizePacket - 8);
+
+            uint64_t key = ((uint64_t)moduleId << 32) + ((uint64_t)periphId << 16) + functionId;
+            std::queue<simulator_package> &queue = packages[key];
+            queue.push(package);
+            simulator_trace_queue(moduleId, periphId, functionId, queue.size());
+            offset += sizePacket;
         }
-        else
-        {
-            (*it).second.push(dataPacket);
-        }
-
-        // dbg
-        data[size] = 0;
-        // printf("module %d, periph %d, fct %d %s\n", moduleId, periphId, functionId, data + 8);
+        memmove(data, data + offset, dataSize - offset);
+        dataSize -= offset;
     }
+    pthread_mutex_unlock(&packagesMutex);
 
     return 0;
 }
@@ -94,20 +128,23 @@ int simulator_recv(uint16_t moduleId, uint16_t periphId, uint16_t functionId, ch
 {
     UDK_UNUSED(size);
 
+    int packageSize = -1;
     uint64_t key = ((uint64_t)moduleId << 32) + ((uint64_t)periphId << 16) + functionId;
-    std::map<uint64_t, std::queue<std::vector<char>>>::iterator it = packages.find(key);
-    if (it != packages.end())
+
+    pthread_mutex_lock(&packagesMutex);
+    std::map<uint64_t, std::queue<simulator_package>>::iterator it = packages.find(key);
+    if (it != packages.end() && !(*it).second.empty())
     {
-        if ((*it).second.empty())
+        simulator_package &package = (*it).second.front();
+        packageSize = package.data.size();
+        memcpy(data, package.data.data(), packageSize);
+        if (simulator_trace_enabled())
         {
-            return -1;
+            simulator_trace_latency(moduleId, periphId, functionId, simulator_trace_timeUs() - package.timeUs);
         }
-
-        std::vector<char> package = (*it).second.front();
-        memcpy(data, package.data(), package.size());
         (*it).second.pop();
-
-        return package.size();
     }
-    return -1;
+    pthread_mutex_unlock(&packagesMutex);
+
+    return packageSize;
 }
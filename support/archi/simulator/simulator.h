@@ -39,6 +39,10 @@ extern "C"
 
 #define archi_init() simulator_init()
 
+// simulator session packets
+#define SIMULATOR_MODULE     0x0000
+#define SIMULATOR_BOARD_NAME 0x0001  // name given by UDK_SIM_BOARD env variable
+
 #ifdef __cplusplus
 }
 #endif
@@ -36,8 +36,8 @@ DEFINES_SIM += -D SIMULATOR -I $(SIMULATOR_PATH)
 vpath %.h $(SIMULATOR_PATH)
 vpath %.c $(SIMULATOR_PATH)
 vpath %.cpp $(SIMULATOR_PATH)
-SIM_SRC += simulator.cpp simulator_socket.c simulator_pthread.c
-HEADER += simulator.h simulator_socket.h simulator_pthread.h
+SIM_SRC += simulator.cpp simulator_socket.c simulator_pthread.c simulator_trace.cpp simulator_cycles.c
+HEADER += simulator.h simulator_socket.h simulator_pthread.h simulator_trace.h simulator_cycles.h
 
 vpath %.h $(OUT_SIM_PWD)
 vpath %.c $(OUT_SIM_PWD)
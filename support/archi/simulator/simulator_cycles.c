@@ -0,0 +1,188 @@
+/**
+ * @file simulator_cycles.c
+ * @author agent
+ * @copyright UniSwarm 2026
+ *
+ * @date October 19, 2026, 03:10 PM
+ *
+ * @brief Simulated CPU cycle counter
+ *
+ * The global counter sums the cycles of all threads. Each thread also has its
+ * own counter, which gives the cycles consumed by a timer handler without
+ * counting the main loop running at the same time in another thread, as an
+ * interrupt preempts the main loop on target.
+ */
+
+#include "simulator_cycles.h"
+#include "simulator_trace.h"
+
+#include <pthread.h>
+#include <stdio.h>
+
+#define SIMULATOR_CYCLES_HANDLER_COUNT 16
+
+typedef struct
+{
+    const char *name;
+    uint32_t periodUs;
+    uint64_t calls;
+    uint64_t cycles;
+    uint64_t maxCycles;
+    uint64_t overruns;
+} simulator_cycles_handler;
+
+static uint64_t simulator_cycles_total = 0;
+static __thread uint64_t simulator_cycles_threadTotal = 0;
+static uint32_t simulator_cycles_cpuFreq = 0;
+
+static simulator_cycles_handler simulator_cycles_handlers[SIMULATOR_CYCLES_HANDLER_COUNT];
+static pthread_mutex_t simulator_cycles_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ * @brief Sets the simulated CPU frequency in instructions cycles per second
+ */
+void simulator_cycles_setFreq(uint32_t freq)
+{
+    simulator_cycles_cpuFreq = freq;
+}
+
+uint32_t simulator_cycles_freq(void)
+{
+    return simulator_cycles_cpuFreq;
+}
+
+/**
+ * @brief Adds cycles that the current code section would take on target
+ */
+void simulator_cycles_consume(uint32_t cycles)
+{
+    __atomic_fetch_add(&simulator_cycles_total, cycles, __ATOMIC_RELAXED);
+    simulator_cycles_threadTotal += cycles;
+}
+
+/**
+ * @brief Cycles consumed since simulation start by all threads
+ */
+uint64_t simulator_cycles(void)
+{
+    return __atomic_load_n(&simulator_cycles_total, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief Cycles consumed since simulation start by the current thread
+ */
+uint64_t simulator_cycles_thread(void)
+{
+    return simulator_cycles_threadTotal;
+}
+
+/**
+ * @brief Converts cycles to target time
+ * @return time in microseconds, 0 if CPU frequency is unknown
+ */
+uint64_t simulator_cycles_toUs(uint64_t cycles)
+{
+    if (simulator_cycles_cpuFreq == 0)
+    {
+        return 0;
+    }
+    return cycles * 1000000 / simulator_cycles_cpuFreq;
+}
+
+static simulator_cycles_handler *simulator_cycles_findHandler(const char *name)
+{
+    unsigned i;
+
+    for (i = 0; i < SIMULATOR_CYCLES_HANDLER_COUNT; i++)
+    {
+        if (simulator_cycles_handlers[i].name == name || simulator_cycles_handlers[i].name == NULL)
+        {
+            simulator_cycles_handlers[i].name = name;
+            return &simulator_cycles_handlers[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Calls a periodic handler (timer interrupt...) and checks its cycles against its period
+ * @param name static handler name, as "timer1"
+ * @param handler function to call
+ * @param periodUs handler call period, 0 if not periodic
+ */
+void simulator_cycles_call(const char *name, void (*handler)(void), uint32_t periodUs)
+{
+    simulator_cycles_handler *stats;
+    uint64_t cycles = simulator_cycles_threadTotal;
+
+    simulator_trace_call(name, handler);
+    cycles = simulator_cycles_threadTotal - cycles;
+
+    pthread_mutex_lock(&simulator_cycles_mutex);
+    stats = simulator_cycles_findHandler(name);
+    if (stats != NULL)
+    {
+        stats->periodUs = periodUs;
+        stats->calls++;
+        stats->cycles += cycles;
+        if (cycles > stats->maxCycles)
+        {
+            stats->maxCycles = cycles;
+        }
+        if (periodUs != 0 && simulator_cycles_cpuFreq != 0 && cycles * 1000000 > (uint64_t)periodUs * simulator_cycles_cpuFreq)
+        {
+            if (stats->overruns == 0)
+            {
+                printf("%s: %llu cycles (%llu us) do not fit in %u us period\n",
+                       name,
+                       (unsigned long long)cycles,
+                       (unsigned long long)simulator_cycles_toUs(cycles),
+                       (unsigned)periodUs);
+            }
+            stats->overruns++;
+        }
+    }
+    pthread_mutex_unlock(&simulator_cycles_mutex);
+}
+
+/**
+ * @brief Prints consumed cycles and handlers load, only if firmware declared cycles
+ */
+void simulator_cycles_end(void)
+{
+    unsigned i;
+    uint64_t total = simulator_cycles();
+
+    if (total == 0)
+    {
+        return;
+    }
+
+    printf("cycles: %llu at %lu Hz, %llu us\n",
+           (unsigned long long)total,
+           (unsigned long)simulator_cycles_cpuFreq,
+           (unsigned long long)simulator_cycles_toUs(total));
+    printf("%-16s %10s %10s %10s %10s %6s %10s\n", "handler", "calls", "avg cycles", "max cycles", "period us", "load", "overruns");
+
+    pthread_mutex_lock(&simulator_cycles_mutex);
+    for (i = 0; i < SIMULATOR_CYCLES_HANDLER_COUNT && simulator_cycles_handlers[i].name != NULL; i++)
+    {
+        const simulator_cycles_handler *stats = &simulator_cycles_handlers[i];
+        uint64_t avgCycles = stats->calls ? stats->cycles / stats->calls : 0;
+        unsigned load = 0;
+
+        if (stats->periodUs != 0 && simulator_cycles_cpuFreq != 0)
+        {
+            load = (unsigned)(stats->maxCycles * 100000000 / ((uint64_t)stats->periodUs * simulator_cycles_cpuFreq));
+        }
+        printf("%-16s %10llu %10llu %10llu %10u %5u%% %10llu\n",
+               stats->name,
+               (unsigned long long)stats->calls,
+               (unsigned long long)avgCycles,
+               (unsigned long long)stats->maxCycles,
+               (unsigned)stats->periodUs,
+               load,
+               (unsigned long long)stats->overruns);
+    }
+    pthread_mutex_unlock(&simulator_cycles_mutex);
+}
@@ -0,0 +1,44 @@
+/**
+ * @file simulator_cycles.h
+ * @author agent
+ * @copyright UniSwarm 2026
+ *
+ * @date October 19, 2026, 03:10 PM
+ *
+ * @brief Simulated CPU cycle counter
+ *
+ * Simulated code runs at host speed, firmware declares the cycles its
+ * sections would take on target with sim_consume_cycles(). Cycles are
+ * converted to target time with the CPU clock set by sysclock_setClock and
+ * timer handlers are checked against their period. A report is printed at
+ * the end of the simulation.
+ */
+
+#ifndef SIMULATOR_CYCLES_H
+#define SIMULATOR_CYCLES_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+
+    void simulator_cycles_setFreq(uint32_t freq);
+    uint32_t simulator_cycles_freq(void);
+
+    void simulator_cycles_consume(uint32_t cycles);
+    uint64_t simulator_cycles(void);
+    uint64_t simulator_cycles_thread(void);
+    uint64_t simulator_cycles_toUs(uint64_t cycles);
+
+    void simulator_cycles_call(const char *name, void (*handler)(void), uint32_t periodUs);
+    void simulator_cycles_end(void);
+
+#define sim_consume_cycles(cycles) simulator_cycles_consume(cycles)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // SIMULATOR_CYCLES_H
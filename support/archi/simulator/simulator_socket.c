@@ -10,6 +10,7 @@
  */
 
 #include "simulator_socket.h"
+#include "simulator_pthread.h"
 
 #include <errno.h>
 #include <stdio.h>
@@ -84,3 +85,28 @@ int simulator_socket_read(char *data, size_t size)
     }
     return 0;
 }
+
+/**
+ * @brief Waits for data from udk-sim during timeoutMs at most, sleeps if not connected or closed
+ */
+void simulator_socket_wait(int timeoutMs)
+{
+    fd_set fds;
+    struct timeval timeout;
+    char byte;
+
+    if (simulator_sock != 0)
+    {
+        FD_ZERO(&fds);
+        FD_SET(simulator_sock, &fds);
+        timeout.tv_sec = timeoutMs / 1000;
+        timeout.tv_usec = (timeoutMs % 1000) * 1000;
+        // readable and nothing to peek means udk-sim closed the connection
+        if (select(simulator_sock + 1, &fds, NULL, NULL, &timeout) <= 0
+            || recv(simulator_sock, &byte, 1, MSG_PEEK | SOCKET_MODE) != 0)
+        {
+            return;
+        }
+    }
+    psleep(timeoutMs);
+}
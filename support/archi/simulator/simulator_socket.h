@@ -50,5 +50,6 @@ void simulator_socket_init(void);
 void simulator_socket_end(void);
 void simulator_socket_send(char *data, size_t size);
 int simulator_socket_read(char *data, size_t size);
+void simulator_socket_wait(int timeoutMs);
 
 #endif  // SIMULATOR_SOCKET_H
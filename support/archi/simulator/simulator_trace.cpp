@@ -0,0 +1,270 @@
+/**
+ * @file simulator_trace.cpp
+ * @author agent
+ * @copyright UniSwarm 2026
+ *
+ * @date October 19, 2026, 11:00 AM
+ *
+ * @brief Simulator traffic counters and Chrome trace export
+ *
+ * Trace events are written to the file as they happen (Chrome trace JSON
+ * array format), counters are kept per (module, periph, function) with log2
+ * histograms of queue depth and queue latency.
+ */
+
+#include "simulator_trace.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+
+#define SIMULATOR_TRACE_HIST_SIZE 16
+
+typedef struct
+{
+    uint64_t sendPackets;
+    uint64_t sendBytes;
+    uint64_t recvPackets;
+    uint64_t recvBytes;
+    size_t queueMax;
+    uint32_t queueHist[SIMULATOR_TRACE_HIST_SIZE];
+    uint64_t latencyCount;
+    uint64_t latencySumUs;
+    uint64_t latencyMaxUs;
+    uint32_t latencyHist[SIMULATOR_TRACE_HIST_SIZE];
+} simulator_trace_stats;
+
+static std::map<uint64_t, simulator_trace_stats> simulator_trace_statsMap;
+static std::mutex simulator_trace_mutex;
+static FILE *simulator_trace_file = NULL;
+static std::atomic<bool> simulator_trace_on(false);
+static std::chrono::steady_clock::time_point simulator_trace_start;
+
+static uint64_t simulator_trace_key(uint16_t moduleId, uint16_t periphId, uint16_t functionId)
+{
+    return ((uint64_t)moduleId << 32) + ((uint64_t)periphId << 16) + functionId;
+}
+
+// bucket 0 for 0, bucket n for [2^(n-1), 2^n[, last bucket for all greater values
+static unsigned simulator_trace_bucket(uint64_t value)
+{
+    unsigned bucket = 0;
+    while (value != 0 && bucket < SIMULATOR_TRACE_HIST_SIZE - 1)
+    {
+        value >>= 1;
+        bucket++;
+    }
+    return bucket;
+}
+
+void simulator_trace_init(void)
+{
+    const char *path = getenv("UDK_SIM_TRACE");
+    if (path == NULL || path[0] == '\0')
+    {
+        return;
+    }
+
+    simulator_trace_file = fopen(path, "w");
+    if (simulator_trace_file == NULL)
+    {
+        perror("UDK_SIM_TRACE");
+        return;
+    }
+    fputs("[\n", simulator_trace_file);
+    simulator_trace_start = std::chrono::steady_clock::now();
+    simulator_trace_on = true;
+}
+
+/**
+ * @brief Closes trace file and prints counters
+ */
+void simulator_trace_end(void)
+{
+    if (!simulator_trace_on)
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(simulator_trace_mutex);
+    simulator_trace_on = false;
+    fputs("{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"udk simulator\"}}]\n", simulator_trace_file);
+    fclose(simulator_trace_file);
+
+    printf("%-16s %10s %12s %10s %12s %6s %10s %10s\n",
+           "module:periph:fn",
+           "sent",
+           "sent bytes",
+           "received",
+           "recv bytes",
+           "queue",
+           "avg us",
+           "max us");
+    for (const std::pair<const uint64_t, simulator_trace_stats> &it : simulator_trace_statsMap)
+    {
+        const simulator_trace_stats &stats = it.second;
+        char name[20];
+        snprintf(name,
+                 sizeof(name),
+                 "%04x:%u:%u",
+                 (unsigned)(it.first >> 32),
+                 (unsigned)((it.first >> 16) & 0xFFFF),
+                 (unsigned)(it.first & 0xFFFF));
+        printf("%-16s %10llu %12llu %10llu %12llu %6u %10llu %10llu\n",
+               name,
+               (unsigned long long)stats.sendPackets,
+               (unsigned long long)stats.sendBytes,
+               (unsigned long long)stats.recvPackets,
+               (unsigned long long)stats.recvBytes,
+               (unsigned)stats.queueMax,
+               (unsigned long long)(stats.latencyCount ? stats.latencySumUs / stats.latencyCount : 0),
+               (unsigned long long)stats.latencyMaxUs);
+
+        if (stats.latencyCount != 0)
+        {
+            printf("  latency log2 us histogram:");
+            for (unsigned i = 0; i < SIMULATOR_TRACE_HIST_SIZE; i++)
+            {
+                printf(" %u", stats.latencyHist[i]);
+            }
+            printf("\n  queue depth log2 histogram:");
+            for (unsigned i = 0; i < SIMULATOR_TRACE_HIST_SIZE; i++)
+            {
+                printf(" %u", stats.queueHist[i]);
+            }
+            printf("\n");
+        }
+    }
+}
+
+int simulator_trace_enabled(void)
+{
+    return simulator_trace_on ? 1 : 0;
+}
+
+/**
+ * @brief Time since trace start
+ * @return time in microseconds
+ */
+uint64_t simulator_trace_timeUs(void)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - simulator_trace_start).count();
+}
+
+/**
+ * @brief Counts a packet exchanged with udk-sim and adds an instant event to trace
+ */
+void simulator_trace_packet(SIMULATOR_TRACE_DIR dir, uint16_t moduleId, uint16_t periphId, uint16_t functionId, size_t size)
+{
+    if (!simulator_trace_on)
+    {
+        return;
+    }
+
+    uint64_t time = simulator_trace_timeUs();
+    std::lock_guard<std::mutex> lock(simulator_trace_mutex);
+    if (!simulator_trace_on)
+    {
+        return;
+    }
+    simulator_trace_stats &stats = simulator_trace_statsMap[simulator_trace_key(moduleId, periphId, functionId)];
+    if (dir == SIMULATOR_TRACE_SEND)
+    {
+        stats.sendPackets++;
+        stats.sendBytes += size;
+    }
+    else
+    {
+        stats.recvPackets++;
+        stats.recvBytes += size;
+    }
+
+    fprintf(simulator_trace_file,
+            "{\"name\":\"%s %04x:%u:%u\",\"cat\":\"packet\",\"ph\":\"i\",\"s\":\"t\",\"ts\":%llu,\"pid\":1,\"tid\":%u,"
+            "\"args\":{\"size\":%u}},\n",
+            (dir == SIMULATOR_TRACE_SEND) ? "send" : "recv",
+            moduleId,
+            periphId,
+            functionId,
+            (unsigned long long)time,
+            moduleId,
+            (unsigned)size);
+}
+
+/**
+ * @brief Records the depth of a receive queue after a packet was pushed
+ */
+void simulator_trace_queue(uint16_t moduleId, uint16_t periphId, uint16_t functionId, size_t depth)
+{
+    if (!simulator_trace_on)
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(simulator_trace_mutex);
+    if (!simulator_trace_on)
+    {
+        return;
+    }
+    simulator_trace_stats &stats = simulator_trace_statsMap[simulator_trace_key(moduleId, periphId, functionId)];
+    stats.queueHist[simulator_trace_bucket(depth)]++;
+    if (depth > stats.queueMax)
+    {
+        stats.queueMax = depth;
+    }
+}
+
+/**
+ * @brief Records the time a received packet waited in queue before being read by the driver
+ */
+void simulator_trace_latency(uint16_t moduleId, uint16_t periphId, uint16_t functionId, uint64_t latencyUs)
+{
+    if (!simulator_trace_on)
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(simulator_trace_mutex);
+    if (!simulator_trace_on)
+    {
+        return;
+    }
+    simulator_trace_stats &stats = simulator_trace_statsMap[simulator_trace_key(moduleId, periphId, functionId)];
+    stats.latencyCount++;
+    stats.latencySumUs += latencyUs;
+    if (latencyUs > stats.latencyMaxUs)
+    {
+        stats.latencyMaxUs = latencyUs;
+    }
+    stats.latencyHist[simulator_trace_bucket(latencyUs)]++;
+}
+
+/**
+ * @brief Calls a handler (timer interrupt...) and adds its run as a complete event to trace
+ */
+void simulator_trace_call(const char *name, void (*handler)(void))
+{
+    if (!simulator_trace_on)
+    {
+        handler();
+        return;
+    }
+
+    uint64_t start = simulator_trace_timeUs();
+    handler();
+    uint64_t duration = simulator_trace_timeUs() - start;
+
+    std::lock_guard<std::mutex> lock(simulator_trace_mutex);
+    if (simulator_trace_on)
+    {
+        fprintf(simulator_trace_file,
+                "{\"name\":\"%s\",\"cat\":\"handler\",\"ph\":\"X\",\"ts\":%llu,\"dur\":%llu,\"pid\":1,\"tid\":0},\n",
+                name,
+                (unsigned long long)start,
+                (unsigned long long)duration);
+    }
+}
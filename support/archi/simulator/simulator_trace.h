@@ -0,0 +1,46 @@
+/**
+ * @file simulator_trace.h
+ * @author agent
+ * @copyright UniSwarm 2026
+ *
+ * @date October 19, 2026, 11:00 AM
+ *
+ * @brief Simulator traffic counters and Chrome trace export
+ *
+ * Enabled by UDK_SIM_TRACE env variable giving the path of the trace file,
+ * which can be opened in chrome://tracing or Perfetto. Counters are printed
+ * at the end of the simulation.
+ */
+
+#ifndef SIMULATOR_TRACE_H
+#define SIMULATOR_TRACE_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+    typedef enum
+    {
+        SIMULATOR_TRACE_SEND = 0,  ///< packet sent to udk-sim
+        SIMULATOR_TRACE_RECV       ///< packet received from udk-sim
+    } SIMULATOR_TRACE_DIR;
+
+    void simulator_trace_init(void);
+    void simulator_trace_end(void);
+    int simulator_trace_enabled(void);
+    uint64_t simulator_trace_timeUs(void);
+
+    void simulator_trace_packet(SIMULATOR_TRACE_DIR dir, uint16_t moduleId, uint16_t periphId, uint16_t functionId, size_t size);
+    void simulator_trace_queue(uint16_t moduleId, uint16_t periphId, uint16_t functionId, size_t depth);
+    void simulator_trace_latency(uint16_t moduleId, uint16_t periphId, uint16_t functionId, uint64_t latencyUs);
+    void simulator_trace_call(const char *name, void (*handler)(void));
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // SIMULATOR_TRACE_H
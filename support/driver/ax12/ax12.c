@@ -7,17 +7,70 @@
  * @date April 16, 2016, 14:41 PM
  *
  * @brief AX12 servomotor support
+ *
+ * Writes are sent immediately. Reads are queued and sent one by one by
+ * ax12_task, the status packet is parsed in the uart rx interrupt. The end of
+ * transmission, which switches txen back to receive, and timeouts are soft
+ * timers, softtimer_init must be called before use.
  */
 
 #include "ax12.h"
 
-// uint8_t idr = 255;
-// uint8_t buffr[30];
-uint8_t ax12_trame[20];
+#include <sys/softtimer.h>
+
+#include <archi.h>
+
+#ifdef SIMULATOR
+#    include <pthread.h>
+static pthread_mutex_t ax12_mutex = PTHREAD_MUTEX_INITIALIZER;
+#    define ax12_lock(state)                                                                                           \
+        do                                                                                                             \
+        {                                                                                                              \
+            disable_interrupt_save(state);                                                                             \
+            pthread_mutex_lock(&ax12_mutex);                                                                           \
+        } while (0)
+#    define ax12_unlock(state)                                                                                         \
+        do                                                                                                             \
+        {                                                                                                              \
+            pthread_mutex_unlock(&ax12_mutex);                                                                         \
+            restore_interrupt(state);                                                                                  \
+        } while (0)
+#else
+#    define ax12_lock(state)   disable_interrupt_save(state)
+#    define ax12_unlock(state) restore_interrupt(state)
+#endif
+
 rt_dev_t ax12_uart;
 rt_dev_t ax12_txen;
 uint8_t ax12_inverted;
 
+typedef enum
+{
+    AX12_STATE_IDLE,
+    AX12_STATE_SENDING,   // read instruction in the uart, received bytes are its echo
+    AX12_STATE_RECEIVING  // waiting for the status packet
+} AX12_STATE;
+
+static Ax12Request *ax12_queue = NULL;
+static Ax12Request *ax12_queueTail = NULL;
+static Ax12Request *volatile ax12_current = NULL;
+static volatile uint8_t ax12_state = AX12_STATE_IDLE;
+static uint32_t ax12_timeoutUs = AX12_TIMEOUT_US;
+static SoftTimer ax12_timeoutTimer;
+static SoftTimer ax12_txTimer;
+static SoftTimer ax12_writeTimer;
+static volatile uint8_t ax12_writeExpired;
+
+// byte time at 1 Mbaud, 8N1
+#define AX12_BYTE_US 10
+
+// status packet parser
+static uint8_t ax12_rxIndex;
+static uint8_t ax12_rxSum;
+static uint8_t ax12_rxError;
+
+static void ax12_rxHandler(rt_dev_t device, const char *data, size_t size);
+
 /**
  * @brief Set the device the send mode
  */
@@ -68,6 +121,7 @@ void ax12_init(rt_dev_t uart, rt_dev_t txen, uint8_t inverted)
     uart_open(ax12_uart);
     uart_setBaudSpeed(ax12_uart, 1000000);
     uart_setBitConfig(ax12_uart, 8, UART_BIT_PARITY_NONE, 1);
+    uart_setRxHandler(ax12_uart, UART_RX_HANDLER_SIZE, 1, ax12_rxHandler);
     uart_enable(ax12_uart);
 
     ax12_txen = txen;
@@ -78,26 +132,152 @@ void ax12_init(rt_dev_t uart, rt_dev_t txen, uint8_t inverted)
     }
 }
 
+/**
+ * @brief Switches the bus to receive at the end of transmission, from the tx soft timer or the rx interrupt
+ */
+static void ax12_txDone(void)
+{
+    rt_reg_t irqState;
+
+    ax12_receiveMode();
+    ax12_lock(irqState);
+    if (ax12_state == AX12_STATE_SENDING)
+    {
+        ax12_state = AX12_STATE_RECEIVING;
+    }
+    ax12_unlock(irqState);
+}
+
+static void ax12_txPoll(void)
+{
+    if (uart_transmitFinished(ax12_uart) <= 0)
+    {
+        return;  // polled again next tick
+    }
+    softtimer_stop(&ax12_txTimer);
+    ax12_txDone();
+}
+
+static void ax12_writeTimeout(void)
+{
+    ax12_writeExpired = 1;
+}
+
+/**
+ * @brief Switches the bus to send and pushes a whole frame, waits for room when it is larger than the uart tx
+ * fifo, and polls the end of transmission from the frame time
+ */
+static int ax12_write(const uint8_t *data, uint8_t size)
+{
+    ssize_t written;
+    int ret = 0;
+
+    softtimer_stop(&ax12_txTimer);  // previous frame end
+    ax12_sendMode();
+    softtimer_start(&ax12_txTimer, ax12_txPoll, (uint32_t)size * AX12_BYTE_US, 1);
+    ax12_writeExpired = 0;
+    softtimer_start(&ax12_writeTimer, ax12_writeTimeout, AX12_WRITE_TIMEOUT_US, 0);
+    while (size > 0)
+    {
+        written = uart_write(ax12_uart, (const char *)data, size);
+        if (written < 0 || (written == 0 && ax12_writeExpired))
+        {
+            ret = -1;  // uart does not drain
+            break;
+        }
+        data += written;
+        size -= written;
+    }
+    softtimer_stop(&ax12_writeTimer);
+    return ret;
+}
+
+/**
+ * @brief Starts a frame, header, id and instruction
+ * @param frame frame storage
+ * @param ax_id the device address, AX12_BROADCAST_ID for all
+ * @param instruction INST_ instruction code
+ */
+void ax12_frameBegin(Ax12Frame *frame, uint8_t ax_id, uint8_t instruction)
+{
+    frame->data[0] = 0xFF;
+    frame->data[1] = 0xFF;
+    frame->data[2] = ax_id;
+    frame->data[4] = instruction;  // length is set at the end
+    frame->size = 5;
+    frame->checksum = ax_id + instruction;
+}
+
+/**
+ * @brief Appends a parameter byte to a frame
+ * @param frame frame started with ax12_frameBegin
+ * @param val byte to append
+ * @return 0 if ok, -1 if the frame is full
+ */
+int ax12_framePush(Ax12Frame *frame, uint8_t val)
+{
+    if (frame->size >= AX12_FRAME_MAX - 1)  // keeps room for the checksum
+    {
+        return -1;
+    }
+    frame->data[frame->size++] = val;
+    frame->checksum += val;
+    return 0;
+}
+
+/**
+ * @brief Appends a short parameter to a frame, low byte first
+ * @param frame frame started with ax12_frameBegin
+ * @param val short to append
+ * @return 0 if ok, -1 if the frame is full
+ */
+int ax12_framePushShort(Ax12Frame *frame, uint16_t val)
+{
+    if (ax12_framePush(frame, (uint8_t)val) < 0)
+    {
+        return -1;
+    }
+    return ax12_framePush(frame, (uint8_t)(val >> 8));
+}
+
+static void ax12_frameEnd(Ax12Frame *frame)
+{
+    uint8_t length = frame->size - 3;  // instruction, params and checksum
+
+    frame->data[3] = length;
+    frame->data[frame->size++] = ~(uint8_t)(frame->checksum + length);
+}
+
+/**
+ * @brief Ends a frame with its length and checksum and sends it
+ * @param frame frame started with ax12_frameBegin
+ * @return 0 if ok, -1 if a read is in progress on the bus or in case of error
+ */
+int ax12_sendFrame(Ax12Frame *frame)
+{
+    if (ax12_current != NULL)
+    {
+        return -1;
+    }
+
+    ax12_frameEnd(frame);
+    return ax12_write(frame->data, frame->size);
+}
+
 /**
  * @brief Send a char (8 bits) to the specified ax
  * @param ax_id the device address
  * @param param addr of the parameter to set
  * @param val value to write
+ * @return 0 if ok, -1 if a read is in progress on the bus or in case of error
  */
-void ax12_send_char(uint8_t ax_id, uint8_t param, uint8_t val)
+int ax12_send_char(uint8_t ax_id, uint8_t param, uint8_t val)
 {
-    char ax12_trame[20];
-    ax12_sendMode();
-    ax12_trame[0] = 0xFF;
-    ax12_trame[1] = 0xFF;
-    ax12_trame[2] = ax_id;
-    ax12_trame[3] = 4;
-    ax12_trame[4] = INST_WRITE;
-    ax12_trame[5] = param;
-    ax12_trame[6] = val;
-    ax12_trame[7] = ~(uint8_t)(ax12_trame[2] + ax12_trame[3] + ax12_trame[4] + ax12_trame[5] + ax12_trame[6]);
-
-    uart_write(ax12_uart, ax12_trame, 8);
+    Ax12Frame frame;
+    ax12_frameBegin(&frame, ax_id, INST_WRITE);
+    ax12_framePush(&frame, param);
+    ax12_framePush(&frame, val);
+    return ax12_sendFrame(&frame);
 }
 
 /**
@@ -105,23 +285,15 @@ void ax12_send_char(uint8_t ax_id, uint8_t param, uint8_t val)
  * @param ax_id the device address
  * @param param addr of the parameter to set
  * @param val value to write
+ * @return 0 if ok, -1 if a read is in progress on the bus or in case of error
  */
-void ax12_send_1_short(uint8_t ax_id, uint8_t param, uint16_t val)
+int ax12_send_1_short(uint8_t ax_id, uint8_t param, uint16_t val)
 {
-    char ax12_trame[20];
-    ax12_sendMode();
-    ax12_trame[0] = 0xFF;
-    ax12_trame[1] = 0xFF;
-    ax12_trame[2] = ax_id;
-    ax12_trame[3] = 5;
-    ax12_trame[4] = INST_WRITE;
-    ax12_trame[5] = param;
-    ax12_trame[6] = (char)val;
-    ax12_trame[7] = (char)((short)val >> 8);
-    ax12_trame[8] =
-        ~(uint8_t)(ax12_trame[2] + ax12_trame[3] + ax12_trame[4] + ax12_trame[5] + ax12_trame[6] + ax12_trame[7]);
-
-    uart_write(ax12_uart, ax12_trame, 9);
+    Ax12Frame frame;
+    ax12_frameBegin(&frame, ax_id, INST_WRITE);
+    ax12_framePush(&frame, param);
+    ax12_framePushShort(&frame, val);
+    return ax12_sendFrame(&frame);
 }
 
 /**
@@ -130,25 +302,16 @@ void ax12_send_1_short(uint8_t ax_id, uint8_t param, uint16_t val)
  * @param param addr of the parameter to set
  * @param val value to write
  * @param val2 second value to write at `param` + 2
+ * @return 0 if ok, -1 if a read is in progress on the bus or in case of error
  */
-void ax12_send_2_short(uint8_t ax_id, uint8_t param, uint16_t val, uint16_t val2)
+int ax12_send_2_short(uint8_t ax_id, uint8_t param, uint16_t val, uint16_t val2)
 {
-    char ax12_trame[20];
-    ax12_sendMode();
-    ax12_trame[0] = 0xFF;
-    ax12_trame[1] = 0xFF;
-    ax12_trame[2] = ax_id;
-    ax12_trame[3] = 7;
-    ax12_trame[4] = INST_WRITE;
-    ax12_trame[5] = param;
-    ax12_trame[6] = (char)val;
-    ax12_trame[7] = (char)((short)val >> 8);
-    ax12_trame[8] = (char)val2;
-    ax12_trame[9] = (char)((short)val2 >> 8);
-    ax12_trame[10] = ~(uint8_t)(ax12_trame[2] + ax12_trame[3] + ax12_trame[4] + ax12_trame[5] + ax12_trame[6]
-                                + ax12_trame[7] + ax12_trame[8] + ax12_trame[9]);
-
-    uart_write(ax12_uart, ax12_trame, 11);
+    Ax12Frame frame;
+    ax12_frameBegin(&frame, ax_id, INST_WRITE);
+    ax12_framePush(&frame, param);
+    ax12_framePushShort(&frame, val);
+    ax12_framePushShort(&frame, val2);
+    return ax12_sendFrame(&frame);
 }
 
 /**
@@ -158,114 +321,358 @@ void ax12_send_2_short(uint8_t ax_id, uint8_t param, uint16_t val, uint16_t val2
  * @param val first value to write
  * @param val2 second value to write at `param` + 2
  * @param val3 third value to write at `param` + 4
+ * @return 0 if ok, -1 if a read is in progress on the bus or in case of error
  */
-void ax12_send_3_short(uint8_t ax_id, uint8_t param, uint16_t val, uint16_t val2, uint16_t val3)
+int ax12_send_3_short(uint8_t ax_id, uint8_t param, uint16_t val, uint16_t val2, uint16_t val3)
 {
-    char ax12_trame[20];
-    ax12_sendMode();
-    ax12_trame[0] = 0xFF;
-    ax12_trame[1] = 0xFF;
-    ax12_trame[2] = ax_id;
-    ax12_trame[3] = 9;
-    ax12_trame[4] = INST_WRITE;
-    ax12_trame[5] = param;
-    ax12_trame[6] = (char)val;
-    ax12_trame[7] = (char)((short)val >> 8);
-    ax12_trame[8] = (char)val2;
-    ax12_trame[9] = (char)((short)val2 >> 8);
-    ax12_trame[10] = (char)val3;
-    ax12_trame[11] = (char)((short)val3 >> 8);
-    ax12_trame[12] = ~(uint8_t)(ax12_trame[2] + ax12_trame[3] + ax12_trame[4] + ax12_trame[5] + ax12_trame[6]
-                                + ax12_trame[7] + ax12_trame[8] + ax12_trame[9] + ax12_trame[10] + ax12_trame[11]);
-
-    uart_write(ax12_uart, ax12_trame, 13);
+    Ax12Frame frame;
+    ax12_frameBegin(&frame, ax_id, INST_WRITE);
+    ax12_framePush(&frame, param);
+    ax12_framePushShort(&frame, val);
+    ax12_framePushShort(&frame, val2);
+    ax12_framePushShort(&frame, val3);
+    return ax12_sendFrame(&frame);
 }
 
 /**
- * @brief Read parameters of the device
- * @param ax_id the device address
+ * @brief Writes the same registers of several ax in one SYNC_WRITE frame
+ * @param param addr of the first parameter to set
+ * @param size bytes written per ax
+ * @param ax_ids device addresses, count items
+ * @param data values, size bytes per ax in ax_ids order, low byte first
+ * @param count number of ax
+ * @return 0 if ok, -1 if the frame exceeds AX12_FRAME_MAX, if a read is in progress or in case of error
  */
-/*void ax12_read_param_ax(uint8_t ax_id, uint8_t param, uint8_t nbParam)
-{
-    int p;
-    axSendMode();
-    ax12_trame[0] = 0xFF;
-    ax12_trame[1] = 0xFF;
-    ax12_trame[2] = ax_id;
-    ax12_trame[3] = 4;
-    ax12_trame[4] = INST_READ;
-    ax12_trame[5] = param;
-    ax12_trame[6] = nbParam;
-    ax12_trame[7] = ~(uint8_t)(ax12_trame[2]+ax12_trame[3]+ax12_trame[4]+ax12_trame[5]+ax12_trame[6]);
-    my_size = 8;
-    idax = 0;
-    U3TXREG = ax12_trame[0];
-    IEC5bits.U3TXIE = 1;
-    //for(p = 0;p<100;p++);
-    //while(idax! = my_size);
-    //for(p = 0;p<100;p++);
-    //axRecMode();
-}*/
+int ax12_syncWrite(uint8_t param, uint8_t size, const uint8_t *ax_ids, const uint8_t *data, uint8_t count)
+{
+    Ax12Frame frame;
+    uint8_t i, j;
+
+    if (size == 0 || count == 0 || 8 + (uint16_t)count * (size + 1) > AX12_FRAME_MAX)
+    {
+        return -1;
+    }
+
+    ax12_frameBegin(&frame, AX12_BROADCAST_ID, INST_SYNC_WRITE);
+    ax12_framePush(&frame, param);
+    ax12_framePush(&frame, size);
+    for (i = 0; i < count; i++)
+    {
+        ax12_framePush(&frame, ax_ids[i]);
+        for (j = 0; j < size; j++)
+        {
+            ax12_framePush(&frame, *data++);
+        }
+    }
+    return ax12_sendFrame(&frame);
+}
 
 /**
- * @brief foo
- * @return 1 if ok, 0 in case of error
+ * @brief Moves several ax with one SYNC_WRITE frame
+ * @param ax_ids device addresses, count items
+ * @param positions destination positions. 0-1023, 511 is the center of a 270° movement
+ * @param speeds speed limits for this movement. 0-1023, NULL to only write positions
+ * @param count number of ax
+ * @return 0 if ok, -1 if the frame exceeds AX12_FRAME_MAX, if a read is in progress or in case of error
  */
-/*uint8_t parseResponse6(uint8_t ax_id, uint16_t *pos, uint16_t *speed, uint16_t *load)
-{
-    uint8_t sum, i;
-    for(i = 6;i<20;i++) if(buffr[i] = =0xFF && buffr[i+1] = =0xFF) break;
-    if(buffr[i+1]! = 0xFF) return 0;
-    if(buffr[i+2]! = ax_id) return 0;
-    sum =
-~(uint8_t)(buffr[i+2]+buffr[i+3]+buffr[i+4]+buffr[i+5]+buffr[i+6]+buffr[i+7]+buffr[i+8]+buffr[i+9]+buffr[i+10]);
-    if(buffr[i+11]! = sum) return 0;
-    *pos = (uint16_t)buffr[i+6]*256+buffr[i+5];
-    *speed = (uint16_t)buffr[i+8]*256+buffr[i+7];
-    *load = (uint16_t)buffr[i+10]*256+buffr[i+9];
-    return 1;
-}*/
+int ax12_syncMoveTo(const uint8_t *ax_ids, const uint16_t *positions, const uint16_t *speeds, uint8_t count)
+{
+    Ax12Frame frame;
+    uint8_t size = (speeds != NULL) ? 4 : 2;
+    uint8_t i;
+
+    if (count == 0 || 8 + (uint16_t)count * (size + 1) > AX12_FRAME_MAX)
+    {
+        return -1;
+    }
+
+    ax12_frameBegin(&frame, AX12_BROADCAST_ID, INST_SYNC_WRITE);
+    ax12_framePush(&frame, P_GOAL_POSITION_L);
+    ax12_framePush(&frame, size);
+    for (i = 0; i < count; i++)
+    {
+        ax12_framePush(&frame, ax_ids[i]);
+        ax12_framePushShort(&frame, positions[i]);
+        if (speeds != NULL)
+        {
+            ax12_framePushShort(&frame, speeds[i]);
+        }
+    }
+    return ax12_sendFrame(&frame);
+}
+
+/**
+ * @brief Queues a non blocking read of ax registers
+ * @param request request storage, must stay valid until the callback
+ * @param ax_id the device address
+ * @param param addr of the first parameter to read
+ * @param data destination of the size read bytes
+ * @param size number of bytes to read
+ * @param callback function called from ax12_task when the read is done or timed out, can be NULL
+ * @return 0 if ok, -1 if the request is already queued or in case of error
+ */
+int ax12_read(Ax12Request *request,
+              uint8_t ax_id,
+              uint8_t param,
+              uint8_t *data,
+              uint8_t size,
+              void (*callback)(Ax12Request *request))
+{
+    Ax12Request *queued;
+
+    if (request == NULL || data == NULL || size == 0 || size > AX12_FRAME_MAX - 6 || ax_id >= AX12_BROADCAST_ID)
+    {
+        return -1;
+    }
+    if (request == ax12_current)
+    {
+        return -1;
+    }
+    for (queued = ax12_queue; queued != NULL; queued = queued->next)
+    {
+        if (queued == request)
+        {
+            return -1;
+        }
+    }
+
+    request->next = NULL;
+    request->callback = callback;
+    request->data = data;
+    request->id = ax_id;
+    request->param = param;
+    request->size = size;
+    request->error = 0;
+    request->status = AX12_REQUEST_PENDING;
+
+    if (ax12_queueTail == NULL)
+    {
+        ax12_queue = request;
+    }
+    else
+    {
+        ax12_queueTail->next = request;
+    }
+    ax12_queueTail = request;
+
+    return 0;
+}
 
 /**
- * @brief clear internal respond buffer
+ * @brief Queues the same non blocking read on several ax
+ * @param requests count request storages, must stay valid until their callbacks
+ * @param ax_ids device addresses, count items
+ * @param count number of ax
+ * @param param addr of the first parameter to read
+ * @param data destination, size bytes per ax in ax_ids order
+ * @param size number of bytes to read per ax
+ * @param callback function called for each request, can be NULL
+ * @return 0 if ok, -1 in case of error, requests queued before the error stay queued
  */
-/*void clearAxResponse(void)
+int ax12_bulkRead(Ax12Request *requests,
+                  const uint8_t *ax_ids,
+                  uint8_t count,
+                  uint8_t param,
+                  uint8_t *data,
+                  uint8_t size,
+                  void (*callback)(Ax12Request *request))
 {
     uint8_t i;
-    for (i = 0; i<30; i++)
-        buffr[i] = 0;
-}*/
+
+    for (i = 0; i < count; i++)
+    {
+        if (ax12_read(&requests[i], ax_ids[i], param, data + (uint16_t)i * size, size, callback) < 0)
+        {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Read request status
+ * @return 1 if the request is queued or in progress, 0 otherwise
+ */
+int ax12_isPending(const Ax12Request *request)
+{
+    return request->status == AX12_REQUEST_PENDING;
+}
+
+/**
+ * @brief Bus status
+ * @return 1 if reads are queued or in progress, writes fail while a read is in progress
+ */
+int ax12_busy(void)
+{
+    return ax12_current != NULL || ax12_queue != NULL;
+}
+
+/**
+ * @brief Sets the status packet timeout of reads
+ * @param timeoutUs timeout in us from the read instruction, AX12_TIMEOUT_US by default
+ */
+void ax12_setTimeout(uint32_t timeoutUs)
+{
+    ax12_timeoutUs = timeoutUs;
+}
+
+static void ax12_timeout(void)
+{
+    Ax12Request *request;
+    rt_reg_t irqState;
+
+    ax12_lock(irqState);
+    request = ax12_current;
+    if (request != NULL && request->status == AX12_REQUEST_PENDING)
+    {
+        request->status = AX12_REQUEST_TIMEOUT;
+    }
+    ax12_unlock(irqState);
+}
+
+static void ax12_start(Ax12Request *request)
+{
+    Ax12Frame frame;
+
+    ax12_frameBegin(&frame, request->id, INST_READ);
+    ax12_framePush(&frame, request->param);
+    ax12_framePush(&frame, request->size);
+    ax12_frameEnd(&frame);
+
+    softtimer_stop(&ax12_txTimer);  // previous frame end would take the read instruction as sent
+    ax12_rxIndex = 0;
+    ax12_state = AX12_STATE_SENDING;
+    ax12_current = request;
+
+    softtimer_start(&ax12_timeoutTimer, ax12_timeout, ax12_timeoutUs, 0);
+    if (ax12_write(frame.data, frame.size) < 0)
+    {
+        ax12_timeout();
+    }
+}
 
 /**
- * @brief foo
+ * @brief Status packet parser, called from uart rx interrupt for each byte
  */
-/*void interrupt rx3_int(void) @ U3RX_VCTR
+static void ax12_parse(uint8_t byte)
 {
-    uint8_t rec;
-    while(U3STAbits.URXDA = =1)
+    Ax12Request *request = ax12_current;
+    uint8_t pos;
+    rt_reg_t irqState;
+
+    if (request == NULL || request->status != AX12_REQUEST_PENDING || ax12_state == AX12_STATE_IDLE)
     {
-        if(U3STAbits.FERR = =1)
+        return;
+    }
+    if (ax12_state == AX12_STATE_SENDING)
+    {
+        if (uart_transmitFinished(ax12_uart) <= 0)
         {
-            rec = U3RXREG;
-            IFS5bits.U3RXIF = 0;
-            return;
+            return;  // echo of the read instruction on single wire buses
         }
-        if(U3STAbits.OERR = =1)
+        ax12_txDone();
+    }
+
+    switch (ax12_rxIndex)
+    {
+        case 0:
+        case 1:
+            ax12_rxIndex = (byte == 0xFF) ? ax12_rxIndex + 1 : 0;
+            break;
+
+        case 2:
+            if (byte == 0xFF)
+            {
+                break;  // extra sync byte
+            }
+            ax12_rxIndex = (byte == request->id) ? 3 : 0;
+            ax12_rxSum = byte;
+            break;
+
+        case 3:
+            ax12_rxIndex = (byte == request->size + 2) ? 4 : 0;
+            ax12_rxSum += byte;
+            break;
+
+        case 4:
+            ax12_rxError = byte;
+            ax12_rxSum += byte;
+            ax12_rxIndex++;
+            break;
+
+        default:
+            pos = ax12_rxIndex - 5;
+            if (pos < request->size)
+            {
+                request->data[pos] = byte;
+                ax12_rxSum += byte;
+                ax12_rxIndex++;
+                break;
+            }
+            ax12_rxIndex = 0;
+            if ((uint8_t)(ax12_rxSum + byte) != 0xFF)  // checksum is ~sum
+            {
+                break;  // bad checksum, ends with a timeout if no valid packet follows
+            }
+            ax12_lock(irqState);
+            if (request->status == AX12_REQUEST_PENDING)
+            {
+                request->error = ax12_rxError;
+                request->status = AX12_REQUEST_DONE;
+            }
+            ax12_unlock(irqState);
+            break;
+    }
+}
+
+static void ax12_rxHandler(rt_dev_t device, const char *data, size_t size)
+{
+    UDK_UNUSED(device);
+
+    while (size > 0)
+    {
+        ax12_parse((uint8_t)*data++);
+        size--;
+    }
+}
+
+/**
+ * @brief Calls callbacks of finished reads and sends the next queued read. To be called in main loop.
+ */
+void ax12_task(void)
+{
+    Ax12Request *request = ax12_current;
+    rt_reg_t irqState;
+
+    if (request != NULL)
+    {
+        if (request->status == AX12_REQUEST_PENDING)
         {
-            rec = U3RXREG;
-            U3STAbits.OERR = 0;
-            IFS5bits.U3RXIF = 0;
             return;
         }
-        rec = U3RXREG;
-        if(idr<30)
+
+        softtimer_stop(&ax12_timeoutTimer);
+        ax12_lock(irqState);
+        ax12_state = AX12_STATE_IDLE;
+        ax12_current = NULL;
+        ax12_unlock(irqState);
+        if (request->callback != NULL)
         {
-            buffr[idr] = rec;
-            idr++;
+            request->callback(request);
         }
     }
-    IFS5bits.U3RXIF = 0;
-}*/
+
+    request = ax12_queue;
+    if (request != NULL)
+    {
+        ax12_queue = request->next;
+        if (ax12_queue == NULL)
+        {
+            ax12_queueTail = NULL;
+        }
+        ax12_start(request);
+    }
+}
 
 /**
  * @brief Move an ax to the specified position with the specified speed and torque
@@ -273,58 +680,64 @@ void ax12_send_3_short(uint8_t ax_id, uint8_t param, uint16_t val, uint16_t val2
  * @param position destination position. 0-1023, 511 is the center of a 270° movement
  * @param speed speed limit for this movement. 0-1023
  * @param torque torque limit for this movement. 0-1023
+ * @return 0 if ok, -1 if a read is in progress on the bus or in case of error
  */
-void ax12_moveTo(uint8_t ax_id, uint16_t position, uint16_t speed, uint16_t torque)
+int ax12_moveTo(uint8_t ax_id, uint16_t position, uint16_t speed, uint16_t torque)
 {
-    ax12_send_3_short(ax_id, P_GOAL_POSITION_L, position, speed, torque);
+    return ax12_send_3_short(ax_id, P_GOAL_POSITION_L, position, speed, torque);
 }
 
 /**
  * @brief Move an ax to the specified position
  * @param ax_id the device address
  * @param position destination position. 0-1023, 511 is the center of a 270° movement
+ * @return 0 if ok, -1 if a read is in progress on the bus or in case of error
  */
-void ax12_setPosition(uint8_t ax_id, uint16_t position)
+int ax12_setPosition(uint8_t ax_id, uint16_t position)
 {
-    ax12_send_1_short(ax_id, P_GOAL_POSITION_L, position);
+    return ax12_send_1_short(ax_id, P_GOAL_POSITION_L, position);
 }
 
 /**
  * @brief Set limit speed
  * @param ax_id the device address
  * @param speed speed limit for this movement. 0-1023
+ * @return 0 if ok, -1 if a read is in progress on the bus or in case of error
  */
-void ax12_setSpeed(uint8_t ax_id, uint16_t speed)
+int ax12_setSpeed(uint8_t ax_id, uint16_t speed)
 {
-    ax12_send_1_short(ax_id, P_GOAL_SPEED_L, speed);
+    return ax12_send_1_short(ax_id, P_GOAL_SPEED_L, speed);
 }
 
 /**
  * @brief Set limit torque
  * @param ax_id the device address
  * @param torque torque limit for this movement. 0-1023
+ * @return 0 if ok, -1 if a read is in progress on the bus or in case of error
  */
-void ax12_setTorque(uint8_t ax_id, uint16_t torque)
+int ax12_setTorque(uint8_t ax_id, uint16_t torque)
 {
-    ax12_send_1_short(ax_id, P_TORQUE_LIMIT_L, torque);
+    return ax12_send_1_short(ax_id, P_TORQUE_LIMIT_L, torque);
 }
 
 /**
  * @brief Light on/off the ax led
  * @param ax_id the device address
  * @param led value of the led 0(Off)/1(On)
+ * @return 0 if ok, -1 if a read is in progress on the bus or in case of error
  */
-void ax12_setLed(uint8_t ax_id, uint8_t led)
+int ax12_setLed(uint8_t ax_id, uint8_t led)
 {
-    ax12_send_char(ax_id, P_LED, led);
+    return ax12_send_char(ax_id, P_LED, led);
 }
 
 /**
  * @brief CHange id of an ax motor
  * @param ax_id actual id of the motor
  * @param newId future id to set
+ * @return 0 if ok, -1 if a read is in progress on the bus or in case of error
  */
-void ax12_setId(uint8_t ax_id, uint8_t newId)
+int ax12_setId(uint8_t ax_id, uint8_t newId)
 {
-    ax12_send_char(ax_id, P_ID, newId);
+    return ax12_send_char(ax_id, P_ID, newId);
 }
@@ -17,21 +17,84 @@
 
 void ax12_init(rt_dev_t uart, rt_dev_t txen, uint8_t inverted);
 
-void ax12_send_char(uint8_t ax_id, uint8_t param, uint8_t val);
-void ax12_send_1_short(uint8_t ax_id, uint8_t param, uint16_t val);
-void ax12_send_2_short(uint8_t ax_id, uint8_t param, uint16_t val, uint16_t val2);
-void ax12_send_3_short(uint8_t ax_id, uint8_t param, uint16_t val, uint16_t val2, uint16_t val3);
-
-/*void read_param_ax(uint8_t ax_id, uint8_t param, uint8_t nbParam);
-uint8_t parseResponse6(uint8_t ax_id, uint16_t *pos, uint16_t *speed, uint16_t *load);
-void clearAxResponse(void);*/
-
-void ax12_moveTo(uint8_t ax_id, uint16_t position, uint16_t speed, uint16_t torque);
-void ax12_setPosition(uint8_t ax_id, uint16_t position);
-void ax12_setSpeed(uint8_t ax_id, uint16_t speed);
-void ax12_setTorque(uint8_t ax_id, uint16_t torque);
-void ax12_setLed(uint8_t ax_id, uint8_t led);
-void ax12_setId(uint8_t ax_id, uint8_t newId);
+int ax12_send_char(uint8_t ax_id, uint8_t param, uint8_t val);
+int ax12_send_1_short(uint8_t ax_id, uint8_t param, uint16_t val);
+int ax12_send_2_short(uint8_t ax_id, uint8_t param, uint16_t val, uint16_t val2);
+int ax12_send_3_short(uint8_t ax_id, uint8_t param, uint16_t val, uint16_t val2, uint16_t val3);
+
+int ax12_moveTo(uint8_t ax_id, uint16_t position, uint16_t speed, uint16_t torque);
+int ax12_setPosition(uint8_t ax_id, uint16_t position);
+int ax12_setSpeed(uint8_t ax_id, uint16_t speed);
+int ax12_setTorque(uint8_t ax_id, uint16_t torque);
+int ax12_setLed(uint8_t ax_id, uint8_t led);
+int ax12_setId(uint8_t ax_id, uint8_t newId);
+
+// ===== frame builder =====
+#ifndef AX12_FRAME_MAX
+#    define AX12_FRAME_MAX 128
+#endif
+
+#define AX12_BROADCAST_ID 0xFE
+
+typedef struct
+{
+    uint8_t data[AX12_FRAME_MAX];
+    uint8_t size;
+    uint8_t checksum;  // running sum of id, instruction and params
+} Ax12Frame;
+
+void ax12_frameBegin(Ax12Frame *frame, uint8_t ax_id, uint8_t instruction);
+int ax12_framePush(Ax12Frame *frame, uint8_t val);
+int ax12_framePushShort(Ax12Frame *frame, uint16_t val);
+int ax12_sendFrame(Ax12Frame *frame);
+
+// frame write is given up if the uart tx fifo does not drain in this time, a full frame takes 1.3 ms at 1 Mbaud
+#ifndef AX12_WRITE_TIMEOUT_US
+#    define AX12_WRITE_TIMEOUT_US 5000
+#endif
+
+// ===== sync write =====
+int ax12_syncWrite(uint8_t param, uint8_t size, const uint8_t *ax_ids, const uint8_t *data, uint8_t count);
+int ax12_syncMoveTo(const uint8_t *ax_ids, const uint16_t *positions, const uint16_t *speeds, uint8_t count);
+
+// ===== non blocking reads =====
+#ifndef AX12_TIMEOUT_US
+#    define AX12_TIMEOUT_US 2000
+#endif
+
+#define AX12_REQUEST_DONE    0
+#define AX12_REQUEST_PENDING 1
+#define AX12_REQUEST_TIMEOUT (-1)
+
+typedef struct Ax12Request
+{
+    struct Ax12Request *next;
+    void (*callback)(struct Ax12Request *request);
+    uint8_t *data;  // read values, valid if status is AX12_REQUEST_DONE
+    uint8_t id;
+    uint8_t param;
+    uint8_t size;
+    uint8_t error;  // error bits of the status packet
+    volatile int8_t status;
+} Ax12Request;
+
+int ax12_read(Ax12Request *request,
+              uint8_t ax_id,
+              uint8_t param,
+              uint8_t *data,
+              uint8_t size,
+              void (*callback)(Ax12Request *request));
+int ax12_bulkRead(Ax12Request *requests,
+                  const uint8_t *ax_ids,
+                  uint8_t count,
+                  uint8_t param,
+                  uint8_t *data,
+                  uint8_t size,
+                  void (*callback)(Ax12Request *request));
+int ax12_isPending(const Ax12Request *request);
+int ax12_busy(void);
+void ax12_setTimeout(uint32_t timeoutUs);
+void ax12_task(void);
 
 //--- Control Table Address ---
 // EEPROM AREA
@@ -101,4 +164,13 @@ void ax12_setId(uint8_t ax_id, uint8_t newId);
 #define INST_SYNC_WRITE     0x83
 #define INST_SYNC_REG_WRITE 0x84
 
+//--- Status packet error bits ---
+#define AX12_ERROR_VOLTAGE     0x01
+#define AX12_ERROR_ANGLE       0x02
+#define AX12_ERROR_OVERHEATING 0x04
+#define AX12_ERROR_RANGE       0x08
+#define AX12_ERROR_CHECKSUM    0x10
+#define AX12_ERROR_OVERLOAD    0x20
+#define AX12_ERROR_INSTRUCTION 0x40
+
 #endif  // AX12_H
@@ -4,7 +4,8 @@ AX12_DRIVER=
 vpath %.c $(DRIVERPATH)
 vpath %.h $(DRIVERPATH)
 
-DRIVERS += uart
+DRIVERS += uart gpio timer
+SYS += softtimer uart_rx
 
 SRC += ax12.c
 HEADER += ax12.h
@@ -83,6 +83,47 @@ int can_filterConfiguration(rt_dev_t device,
 int can_filterEnable(rt_dev_t device, uint8_t nFilter);
 int can_filterDisable(rt_dev_t device, uint8_t nFilter);
 
+// ===== receive dispatch =====
+#ifndef CAN_DISPATCH_BUCKETS
+#    define CAN_DISPATCH_BUCKETS 32  // hash buckets per bus, power of two
+#endif
+
+typedef struct CanRxHandler
+{
+    struct CanRxHandler *next;
+    struct CanRxHandler **pprev;  // NULL when not registered
+    void (*handler)(rt_dev_t device, const CAN_MSG_HEADER *header, const char *data);
+    uint32_t key;    // identifier, CAN_DISPATCH_EXT set for extended frames
+    uint32_t count;  // dispatched frames
+} CanRxHandler;
+
+// a handler storage must start unregistered, static storages are, automatic ones need this initializer
+#define CAN_RX_HANDLER_INITIALIZER                                                                                     \
+    {                                                                                                                  \
+        NULL, NULL, NULL, 0, 0                                                                                         \
+    }
+
+#define CAN_DISPATCH_EXT 0x80000000
+
+typedef struct
+{
+    uint32_t received;
+    uint32_t unhandled;  // frames without handler, given to the default handler
+    uint16_t maxBatch;   // most frames drained by one can_dispatch call
+} CanDispatchStats;
+
+int can_setRxHandler(rt_dev_t device,
+                     CanRxHandler *rxHandler,
+                     uint32_t id,
+                     CAN_FRAME_FORMAT_FLAGS frame,
+                     void (*handler)(rt_dev_t device, const CAN_MSG_HEADER *header, const char *data));
+int can_removeRxHandler(rt_dev_t device, CanRxHandler *rxHandler);
+int can_setDefaultRxHandler(rt_dev_t device,
+                            void (*handler)(rt_dev_t device, const CAN_MSG_HEADER *header, const char *data));
+int can_dispatch(rt_dev_t device, uint8_t fifo, uint16_t maxCount);
+int can_dispatchStats(rt_dev_t device, CanDispatchStats *stats);
+void can_dispatchResetStats(rt_dev_t device);
+
 #if defined(ARCHI_dspic30f)
 #    include "can_dspic30f.h"
 #elif defined(ARCHI_dspic33ch) || defined(ARCHI_dspic33ck)
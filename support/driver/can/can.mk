@@ -27,4 +27,10 @@ endif
 
 SIM_SRC += can_sim.c
 
+# receive dispatch, on archis with a can_rec implementation
+ifeq ($(ARCHI),$(filter $(ARCHI),dspic33ch dspic33ck pic32mx pic32mk pic32mzda pic32mzec pic32mzef))
+ ARCHI_SRC += can_dispatch.c
+endif
+SIM_SRC += can_dispatch.c
+
 endif
@@ -0,0 +1,327 @@
+/**
+ * @file can_dispatch.c
+ * @author agent
+ * @copyright UniSwarm 2026
+ *
+ * @date October 19, 2026, 11:20 PM
+ *
+ * @brief CAN receive dispatch by identifier, shared by can drivers
+ *
+ * Handlers are chained in a hash table of CAN_DISPATCH_BUCKETS buckets per bus,
+ * lookup is O(1) while the number of handlers stays in the order of the
+ * bucket count. can_dispatch drains a hardware fifo with can_rec in batches
+ * and calls the handler of each frame identifier, from main loop or from an
+ * interrupt.
+ */
+
+#include "can.h"
+
+#include <archi.h>
+
+#ifdef SIMULATOR
+#    include <pthread.h>
+static pthread_mutex_t can_dispatch_mutex = PTHREAD_MUTEX_INITIALIZER;
+#    define can_dispatch_lock(state)                                                                                   \
+        do                                                                                                             \
+        {                                                                                                              \
+            disable_interrupt_save(state);                                                                             \
+            pthread_mutex_lock(&can_dispatch_mutex);                                                                   \
+        } while (0)
+#    define can_dispatch_unlock(state)                                                                                 \
+        do                                                                                                             \
+        {                                                                                                              \
+            pthread_mutex_unlock(&can_dispatch_mutex);                                                                 \
+            restore_interrupt(state);                                                                                  \
+        } while (0)
+#else
+#    define can_dispatch_lock(state)   disable_interrupt_save(state)
+#    define can_dispatch_unlock(state) restore_interrupt(state)
+#endif
+
+#if (CAN_DISPATCH_BUCKETS & (CAN_DISPATCH_BUCKETS - 1)) != 0
+#    error CAN_DISPATCH_BUCKETS must be a power of two
+#endif
+
+#if CAN_COUNT >= 1
+#    define CAN_DISPATCH_COUNT CAN_COUNT
+#else
+#    define CAN_DISPATCH_COUNT 1
+#endif
+
+// largest CAN FD payload
+#define CAN_DISPATCH_DATA_MAX 64
+
+struct can_dispatch_dev
+{
+    CanRxHandler *buckets[CAN_DISPATCH_BUCKETS];
+    void (*defaultHandler)(rt_dev_t device, const CAN_MSG_HEADER *header, const char *data);
+    CanDispatchStats stats;
+};
+
+static struct can_dispatch_dev can_dispatchs[CAN_DISPATCH_COUNT];
+
+static uint16_t can_dispatch_hash(uint32_t key)
+{
+    // folds extended identifiers, standard identifiers keep their low bits
+    key ^= key >> 16;
+    key ^= key >> 8;
+    return key & (CAN_DISPATCH_BUCKETS - 1);
+}
+
+static CanRxHandler *can_dispatch_find(struct can_dispatch_dev *dispatch, uint32_t key)
+{
+    CanRxHandler *rxHandler;
+
+    for (rxHandler = dispatch->buckets[can_dispatch_hash(key)]; rxHandler != NULL; rxHandler = rxHandler->next)
+    {
+        if (rxHandler->key == key)
+        {
+            return rxHandler;
+        }
+    }
+    return NULL;
+}
+
+static void can_dispatch_unlink(CanRxHandler *rxHandler)
+{
+    *rxHandler->pprev = rxHandler->next;
+    if (rxHandler->next != NULL)
+    {
+        rxHandler->next->pprev = rxHandler->pprev;
+    }
+    rxHandler->pprev = NULL;
+}
+
+/**
+ * @brief Registers the handler of one frame identifier
+ * @param device can bus device number
+ * @param rxHandler handler storage, zeroed or CAN_RX_HANDLER_INITIALIZER before its first registration, must stay
+ * valid while registered, moved to the new identifier if already registered
+ * @param id frame identifier
+ * @param frame CAN_FRAME_STD or CAN_FRAME_EXT
+ * @param handler function called by can_dispatch for each frame with this identifier
+ * @return 0 if ok, -1 if the identifier already has another handler or in case of error, a previous registration of
+ * rxHandler is then kept
+ */
+int can_setRxHandler(rt_dev_t device,
+                     CanRxHandler *rxHandler,
+                     uint32_t id,
+                     CAN_FRAME_FORMAT_FLAGS frame,
+                     void (*handler)(rt_dev_t device, const CAN_MSG_HEADER *header, const char *data))
+{
+    struct can_dispatch_dev *dispatch;
+    CanRxHandler **bucket;
+    CanRxHandler *used;
+    uint32_t key;
+    uint8_t can = MINOR(device);
+    rt_reg_t irqState;
+
+    if (can >= CAN_COUNT || rxHandler == NULL || handler == NULL)
+    {
+        return -1;
+    }
+    if (frame == CAN_FRAME_STD && id <= 0x7FF)
+    {
+        key = id;
+    }
+    else if (frame == CAN_FRAME_EXT && id <= 0x1FFFFFFF)
+    {
+        key = id | CAN_DISPATCH_EXT;
+    }
+    else
+    {
+        return -1;
+    }
+    dispatch = &can_dispatchs[can];
+
+    can_dispatch_lock(irqState);
+    used = can_dispatch_find(dispatch, key);
+    if (used != NULL && used != rxHandler)
+    {
+        // the previous registration of rxHandler, if any, is kept
+        can_dispatch_unlock(irqState);
+        return -1;
+    }
+    if (rxHandler->pprev != NULL)
+    {
+        can_dispatch_unlink(rxHandler);
+    }
+    rxHandler->handler = handler;
+    rxHandler->key = key;
+    rxHandler->count = 0;
+
+    bucket = &dispatch->buckets[can_dispatch_hash(key)];
+    rxHandler->next = *bucket;
+    if (*bucket != NULL)
+    {
+        (*bucket)->pprev = &rxHandler->next;
+    }
+    rxHandler->pprev = bucket;
+    *bucket = rxHandler;
+    can_dispatch_unlock(irqState);
+
+    return 0;
+}
+
+/**
+ * @brief Unregisters a handler
+ * @param device can bus device number
+ * @param rxHandler handler storage
+ * @return 0 if ok, -1 if the handler was not registered
+ */
+int can_removeRxHandler(rt_dev_t device, CanRxHandler *rxHandler)
+{
+    uint8_t can = MINOR(device);
+    rt_reg_t irqState;
+
+    if (can >= CAN_COUNT)
+    {
+        return -1;
+    }
+
+    can_dispatch_lock(irqState);
+    if (rxHandler->pprev == NULL)
+    {
+        can_dispatch_unlock(irqState);
+        return -1;
+    }
+    can_dispatch_unlink(rxHandler);
+    can_dispatch_unlock(irqState);
+
+    return 0;
+}
+
+/**
+ * @brief Sets the handler of frames without registered identifier
+ * @param device can bus device number
+ * @param handler function called by can_dispatch, NULL to drop these frames
+ * @return 0 if ok, -1 in case of error
+ */
+int can_setDefaultRxHandler(rt_dev_t device,
+                            void (*handler)(rt_dev_t device, const CAN_MSG_HEADER *header, const char *data))
+{
+    uint8_t can = MINOR(device);
+    if (can >= CAN_COUNT)
+    {
+        return -1;
+    }
+
+    can_dispatchs[can].defaultHandler = handler;
+    return 0;
+}
+
+/**
+ * @brief Drains a receive fifo and calls the handler of each frame
+ * @param device can bus device number
+ * @param fifo fifo given to can_rec
+ * @param maxCount maximum frames dispatched by this call, 0 to drain the whole fifo
+ * @return number of dispatched frames, -1 in case of error
+ */
+int can_dispatch(rt_dev_t device, uint8_t fifo, uint16_t maxCount)
+{
+    struct can_dispatch_dev *dispatch;
+    void (*handler)(rt_dev_t device, const CAN_MSG_HEADER *header, const char *data);
+    CanRxHandler *rxHandler;
+    CAN_MSG_HEADER header;
+    char data[CAN_DISPATCH_DATA_MAX];
+    uint32_t key;
+    uint16_t count = 0;
+    uint8_t can = MINOR(device);
+    rt_reg_t irqState;
+
+    if (can >= CAN_COUNT)
+    {
+        return -1;
+    }
+    dispatch = &can_dispatchs[can];
+
+    while ((maxCount == 0 || count < maxCount) && can_rec(device, fifo, &header, data) == 1)
+    {
+        count++;
+        key = header.id;
+        if ((header.flags & CAN_VERS2BA) == CAN_VERS2BA)
+        {
+            key |= CAN_DISPATCH_EXT;
+        }
+
+        can_dispatch_lock(irqState);
+        rxHandler = can_dispatch_find(dispatch, key);
+        if (rxHandler != NULL)
+        {
+            rxHandler->count++;
+            handler = rxHandler->handler;
+        }
+        else
+        {
+            dispatch->stats.unhandled++;
+            handler = dispatch->defaultHandler;
+        }
+        dispatch->stats.received++;
+        can_dispatch_unlock(irqState);
+
+        if (handler != NULL)
+        {
+            handler(device, &header, data);
+        }
+    }
+
+    if (count > dispatch->stats.maxBatch)
+    {
+        dispatch->stats.maxBatch = count;
+    }
+    return count;
+}
+
+/**
+ * @brief Copies dispatch stats of a bus, per identifier counts are in CanRxHandler
+ * @param device can bus device number
+ * @param stats destination
+ * @return 0 if ok, -1 in case of error
+ */
+int can_dispatchStats(rt_dev_t device, CanDispatchStats *stats)
+{
+    uint8_t can = MINOR(device);
+    rt_reg_t irqState;
+
+    if (can >= CAN_COUNT)
+    {
+        return -1;
+    }
+
+    can_dispatch_lock(irqState);
+    *stats = can_dispatchs[can].stats;
+    can_dispatch_unlock(irqState);
+    return 0;
+}
+
+/**
+ * @brief Clears dispatch stats of a bus and counts of its handlers
+ * @param device can bus device number
+ */
+void can_dispatchResetStats(rt_dev_t device)
+{
+    struct can_dispatch_dev *dispatch;
+    CanRxHandler *rxHandler;
+    uint16_t bucket;
+    uint8_t can = MINOR(device);
+    rt_reg_t irqState;
+
+    if (can >= CAN_COUNT)
+    {
+        return;
+    }
+    dispatch = &can_dispatchs[can];
+
+    can_dispatch_lock(irqState);
+    dispatch->stats.received = 0;
+    dispatch->stats.unhandled = 0;
+    dispatch->stats.maxBatch = 0;
+    for (bucket = 0; bucket < CAN_DISPATCH_BUCKETS; bucket++)
+    {
+        for (rxHandler = dispatch->buckets[bucket]; rxHandler != NULL; rxHandler = rxHandler->next)
+        {
+            rxHandler->count = 0;
+        }
+    }
+    can_dispatch_unlock(irqState);
+}
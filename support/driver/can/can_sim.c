@@ -113,6 +113,11 @@ int can_open(rt_dev_t device)
     cans[can].used = 1;
     can_sendconfig(can);
 
+    if (strcmp(cans[can].bus, CAN_SIM_FABRIC_BUS) == 0)
+    {
+        return 0;
+    }
+
 #ifdef SIM_UNIX
     struct ifreq ifr;
     struct sockaddr_can addr;
@@ -348,6 +353,17 @@ int can_send(rt_dev_t device, uint8_t fifo, CAN_MSG_HEADER *header, char *data)
         return -1;
     }
 
+    if (strcmp(cans[can].bus, CAN_SIM_FABRIC_BUS) == 0)
+    {
+        can_sim_frame frame;
+        frame.can_id = header->id;
+        frame.can_dlc = (header->size > 8) ? 8 : header->size;
+        frame.flag = header->flags;
+        memcpy(frame.data, data, frame.can_dlc);
+        simulator_send(CAN_SIM_MODULE, can, CAN_SIM_WRITE, (char *)&frame, sizeof(frame));
+        return 1;
+    }
+
 #ifdef SIM_UNIX
     int retval, i;
     struct can_frame frame;
@@ -428,6 +444,21 @@ int can_rec(rt_dev_t device, uint8_t fifo, CAN_MSG_HEADER *header, char *data)
         return -1;
     }
 
+    if (strcmp(cans[can].bus, CAN_SIM_FABRIC_BUS) == 0)
+    {
+        can_sim_frame frame;
+        simulator_rec_task();
+        if (simulator_recv(CAN_SIM_MODULE, can, CAN_SIM_READ, (char *)&frame, sizeof(frame)) != sizeof(frame))
+        {
+            return 0;
+        }
+        header->id = frame.can_id;
+        header->size = (frame.can_dlc > 8) ? 8 : frame.can_dlc;
+        header->flags = frame.flag;
+        memcpy(data, frame.data, header->size);
+        return 1;
+    }
+
 #ifdef SIM_UNIX
     struct can_frame frame;
 
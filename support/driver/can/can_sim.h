@@ -41,6 +41,9 @@ typedef struct
 #define CAN_SIM_WRITE  0x0002
 #define CAN_SIM_READ   0x0003
 
+// bus name routing frames through udk-sim fabric instead of SocketCAN
+#define CAN_SIM_FABRIC_BUS "udk-sim"
+
 #ifndef SIMULATOR
 #    define can_sim_setBus(device, bus) 0
 #else
@@ -832,6 +832,24 @@ uint32_t ccp_periodUs(rt_dev_t device)
 #endif
 }
 
+#if CCP_COUNT >= 1
+/**
+ * @brief Reads the 32 bits timer of a ccp while it runs, high word is read again if the low word wrapped in between
+ */
+static uint32_t ccp_readTimer32(volatile uint16_t *high, volatile uint16_t *low)
+{
+    uint16_t valueH, valueL;
+
+    do
+    {
+        valueH = *high;
+        valueL = *low;
+    } while (valueH != *high);
+
+    return ((uint32_t)valueH << 16) + valueL;
+}
+#endif
+
 /**
  * @brief Returns the current value of ccp
  * @param device ccp device number
@@ -850,46 +868,46 @@ uint32_t ccp_getValue(rt_dev_t device)
     switch (ccp)
     {
         case 0:
-            value = ((uint32_t)CCP1TMRH << 16) + CCP1TMRL;
+            value = ccp_readTimer32(&CCP1TMRH, &CCP1TMRL);
             break;
 #    if CCP_COUNT >= 2
         case 1:
-            value = ((uint32_t)CCP2TMRH << 16) + CCP2TMRL;
+            value = ccp_readTimer32(&CCP2TMRH, &CCP2TMRL);
             break;
 #    endif
 #    if CCP_COUNT >= 3
         case 2:
-            value = ((uint32_t)CCP3TMRH << 16) + CCP3TMRL;
+            value = ccp_readTimer32(&CCP3TMRH, &CCP3TMRL);
             break;
 #    endif
 #    if CCP_COUNT >= 4
         case 3:
-            value = ((uint32_t)CCP4TMRH << 16) + CCP4TMRL;
+            value = ccp_readTimer32(&CCP4TMRH, &CCP4TMRL);
             break;
 #    endif
 #    if CCP_COUNT >= 5
         case 4:
-            value = ((uint32_t)CCP5TMRH << 16) + CCP5TMRL;
+            value = ccp_readTimer32(&CCP5TMRH, &CCP5TMRL);
             break;
 #    endif
 #    if CCP_COUNT >= 6
         case 5:
-            value = ((uint32_t)CCP6TMRH << 16) + CCP6TMRL;
+            value = ccp_readTimer32(&CCP6TMRH, &CCP6TMRL);
             break;
 #    endif
 #    if CCP_COUNT >= 7
         case 6:
-            value = ((uint32_t)CCP7TMRH << 16) + CCP7TMRL;
+            value = ccp_readTimer32(&CCP7TMRH, &CCP7TMRL);
             break;
 #    endif
 #    if CCP_COUNT >= 8
         case 7:
-            value = ((uint32_t)CCP8TMRH << 16) + CCP8TMRL;
+            value = ccp_readTimer32(&CCP8TMRH, &CCP8TMRL);
             break;
 #    endif
 #    if CCP_COUNT >= 9
         case 8:
-            value = ((uint32_t)CCP9TMRH << 16) + CCP9TMRL;
+            value = ccp_readTimer32(&CCP9TMRH, &CCP9TMRL);
             break;
 #    endif
     }
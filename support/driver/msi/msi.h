@@ -20,6 +20,10 @@
 #    warning Unsuported ARCHI
 #endif
 
+#ifdef SIMULATOR
+#    include "msi_sim.h"
+#endif
+
 typedef enum
 {
     MSI_CORE_STATUS_RESETED,
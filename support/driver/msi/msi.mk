@@ -21,5 +21,8 @@ ifeq ($(ARCHI),$(filter $(ARCHI),dspic33ch))
 endif
 
 SIM_SRC += msi_sim.c
+ifneq ($(OS),Windows_NT)
+ LIBS_SIM += -lrt
+endif
 
 endif
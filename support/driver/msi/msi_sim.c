@@ -6,116 +6,500 @@
  * @date March 20 2019, 19:45 PM
  *
  * @brief MSI udevkit simulator support for simulation purpose
+ *
+ * Master and slave run as two simulator processes sharing mailboxes and
+ * _DTRDYx handshake flags in a POSIX shared memory. The master starts the
+ * slave executable given by UDK_SIM_MSI_SLAVE env variable with
+ * msi_slave_start and passes the shared memory name with UDK_SIM_MSI_SHM.
+ * A slave executable started alone uses a private memory.
+ *
+ * Mailboxes follow dsPIC33CH driver mapping : protocol A (M2S) uses
+ * mailboxes 0 to 4, B (S2M) 5 to 9, C (M2S2) 10 to 12 and D (S2M2) 13 to 15.
+ * Transfer counters, full mailbox writes and latencies are printed at the end
+ * of the master simulation.
  */
 
+#define _GNU_SOURCE
+
 #include "msi.h"
+#include "simulator.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifdef SIM_UNIX
+#    include <fcntl.h>
+#    include <signal.h>
+#    include <sys/mman.h>
+#    include <sys/wait.h>
+#    include <unistd.h>
+#    ifdef __linux__
+#        include <sys/prctl.h>
+#    endif
+#endif
+
+#define MSI_SIM_PROTOCOL_USED 4
 
-// TODO : dummy implementation, please implement me
+typedef struct
+{
+    uint32_t writes;
+    uint32_t writesFull;  // write attempts while mailbox not yet read
+    uint32_t reads;
+    uint64_t writeTimeNs;
+    uint64_t latencySumNs;
+    uint64_t latencyMaxNs;
+} msi_sim_stats;
+
+typedef struct
+{
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    uint16_t mailboxes[MSI_MAILBOX_COUNT];
+    uint8_t dataReady[MSI_SIM_PROTOCOL_USED];  // _DTRDYA to _DTRDYD
+    uint32_t sequence[MSI_SIM_PROTOCOL_USED];  // increments on each write, wakes up receiver handler
+    uint8_t masterStatus;
+    msi_sim_stats stats[MSI_SIM_PROTOCOL_USED];
+} msi_sim_shared;
+
+static const uint8_t msi_sim_mailboxFirst[MSI_SIM_PROTOCOL_USED] = {0, 5, 10, 13};
+static const uint8_t msi_sim_mailboxCount[MSI_SIM_PROTOCOL_USED] = {5, 5, 3, 3};
+
+static msi_sim_shared *msi_sim_mem = NULL;
+static void (*msi_sim_handlers[MSI_SIM_PROTOCOL_USED])(void);
+static uint32_t msi_sim_handledSequence[MSI_SIM_PROTOCOL_USED];
+static pthread_t msi_sim_handlerThreadId;
+static int msi_sim_handlerThreadStarted = 0;
 
 #ifdef MSI_HAVE_MASTER_INTERFACE
-int msi_slave_start(const uint8_t slave_id)
+#    define MSI_SIM_IS_MASTER 1
+static char msi_sim_shmName[32];
+static void msi_sim_end(void);
+#    ifdef SIM_UNIX
+static pid_t msi_sim_slavePid = -1;
+#    endif
+#else
+#    define MSI_SIM_IS_MASTER 0
+#endif
+
+static uint64_t msi_sim_timeNs(void)
 {
-    UDK_UNUSED(slave_id);
-    return 0;
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000 + now.tv_nsec;
 }
 
-int msi_slave_stop(const uint8_t slave_id)
+// even protocols go from master to slave, odd ones from slave to master
+static int msi_sim_isReceiver(uint8_t protocol)
 {
-    UDK_UNUSED(slave_id);
-    return 0;
+    return (protocol & 1) == MSI_SIM_IS_MASTER;
 }
 
-int msi_slave_reset(const uint8_t slave_id)
+static void msi_sim_initShared(msi_sim_shared *mem, int processShared)
 {
-    UDK_UNUSED(slave_id);
-    return 0;
+    pthread_mutexattr_t mutexAttr;
+    pthread_condattr_t condAttr;
+
+    memset(mem, 0, sizeof(msi_sim_shared));
+    pthread_mutexattr_init(&mutexAttr);
+    pthread_condattr_init(&condAttr);
+    if (processShared)
+    {
+        pthread_mutexattr_setpshared(&mutexAttr, PTHREAD_PROCESS_SHARED);
+        pthread_condattr_setpshared(&condAttr, PTHREAD_PROCESS_SHARED);
+    }
+    pthread_mutex_init(&mem->mutex, &mutexAttr);
+    pthread_cond_init(&mem->cond, &condAttr);
+    pthread_mutexattr_destroy(&mutexAttr);
+    pthread_condattr_destroy(&condAttr);
+    mem->masterStatus = MSI_CORE_STATUS_STARTED;
 }
 
-MSI_CORE_STATUS msi_slave_status(const uint8_t slave_id)
+/**
+ * @brief Maps the shared memory at first use
+ */
+static msi_sim_shared *msi_sim_sharedMem(void)
 {
-    UDK_UNUSED(slave_id);
-    return 0;
+    if (msi_sim_mem != NULL)
+    {
+        return msi_sim_mem;
+    }
+
+#ifdef SIM_UNIX
+    int fd;
+#    ifdef MSI_HAVE_MASTER_INTERFACE
+    snprintf(msi_sim_shmName, sizeof(msi_sim_shmName), "/udk-msi-%d", (int)getpid());
+    fd = shm_open(msi_sim_shmName, O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd >= 0 && ftruncate(fd, sizeof(msi_sim_shared)) == 0)
+    {
+        msi_sim_mem = mmap(NULL, sizeof(msi_sim_shared), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (msi_sim_mem == MAP_FAILED)
+        {
+            msi_sim_mem = NULL;
+        }
+        else
+        {
+            msi_sim_initShared(msi_sim_mem, 1);
+            setenv("UDK_SIM_MSI_SHM", msi_sim_shmName, 1);
+            atexit(msi_sim_end);
+        }
+    }
+#    else
+    const char *name = getenv("UDK_SIM_MSI_SHM");
+    fd = (name != NULL) ? shm_open(name, O_RDWR, 0600) : -1;
+    if (fd >= 0)
+    {
+        msi_sim_mem = mmap(NULL, sizeof(msi_sim_shared), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (msi_sim_mem == MAP_FAILED)
+        {
+            msi_sim_mem = NULL;
+        }
+    }
+#    endif
+    if (fd >= 0)
+    {
+        close(fd);
+    }
+#endif
+
+    if (msi_sim_mem == NULL)
+    {
+        msi_sim_mem = malloc(sizeof(msi_sim_shared));
+        msi_sim_initShared(msi_sim_mem, 0);
+    }
+    return msi_sim_mem;
 }
 
-int msi_slave_program(const uint8_t slave_id, __eds__ unsigned char *program)
+/**
+ * @brief Plays the role of MSI interrupts, calls the handler of each received protocol
+ */
+static void *msi_sim_handlerThread(void *arg)
 {
-    UDK_UNUSED(slave_id);
-    UDK_UNUSED(program);
-    return 0;
+    msi_sim_shared *mem = msi_sim_sharedMem();
+    void (*handlers[MSI_SIM_PROTOCOL_USED])(void);
+    uint8_t protocol;
+    int pending;
+
+    UDK_UNUSED(arg);
+
+    while (1)
+    {
+        pthread_mutex_lock(&mem->mutex);
+        do
+        {
+            pending = 0;
+            for (protocol = 0; protocol < MSI_SIM_PROTOCOL_USED; protocol++)
+            {
+                handlers[protocol] = NULL;
+                if (msi_sim_isReceiver(protocol) && msi_sim_handlers[protocol] != NULL
+                    && mem->sequence[protocol] != msi_sim_handledSequence[protocol])
+                {
+                    msi_sim_handledSequence[protocol] = mem->sequence[protocol];
+                    handlers[protocol] = msi_sim_handlers[protocol];
+                    pending = 1;
+                }
+            }
+            if (!pending)
+            {
+                pthread_cond_wait(&mem->cond, &mem->mutex);
+            }
+        } while (!pending);
+        pthread_mutex_unlock(&mem->mutex);
+
+        for (protocol = 0; protocol < MSI_SIM_PROTOCOL_USED; protocol++)
+        {
+            if (handlers[protocol] != NULL)
+            {
+                handlers[protocol]();
+            }
+        }
+    }
+
+    return NULL;
 }
 
-int msi_slave_verify_program(const uint8_t slave_id, __eds__ unsigned char *program)
+/**
+ * @brief Sets the handler called when a mail is received on protocol, as MSI interrupt
+ * @param protocol protocol id received by this core
+ * @param handler function pointer or NULL to disable
+ * @return 0 if ok, -1 if protocol is not valid
+ */
+int msi_sim_setHandler(const uint8_t protocol, void (*handler)(void))
 {
-    UDK_UNUSED(slave_id);
-    UDK_UNUSED(program);
+    msi_sim_shared *mem = msi_sim_sharedMem();
+
+    if (protocol >= MSI_SIM_PROTOCOL_USED || !msi_sim_isReceiver(protocol))
+    {
+        return -1;
+    }
+
+    pthread_mutex_lock(&mem->mutex);
+    msi_sim_handlers[protocol] = handler;
+    msi_sim_handledSequence[protocol] = mem->sequence[protocol] - mem->dataReady[protocol];  // mail already there
+    if (!msi_sim_handlerThreadStarted)
+    {
+        msi_sim_handlerThreadStarted = 1;
+        pthread_create(&msi_sim_handlerThreadId, NULL, msi_sim_handlerThread, NULL);
+    }
+    pthread_cond_broadcast(&mem->cond);
+    pthread_mutex_unlock(&mem->mutex);
+
     return 0;
 }
 
-#endif
+#ifdef MSI_HAVE_MASTER_INTERFACE
+/**
+ * @brief Stops slave and prints transfers statistics
+ */
+static void msi_sim_end(void)
+{
+    uint8_t protocol;
+    msi_sim_shared *mem = msi_sim_mem;
 
-#ifndef MSI_HAVE_MASTER_INTERFACE
-MSI_CORE_STATUS msi_master_status(void)
+    msi_slave_stop(1);
+    for (protocol = 0; protocol < MSI_SIM_PROTOCOL_USED; protocol++)
+    {
+        const msi_sim_stats *stats = &mem->stats[protocol];
+        if (stats->writes == 0 && stats->writesFull == 0)
+        {
+            continue;
+        }
+        printf("msi protocol %c: %u writes, %u full, %u reads, latency avg %llu us max %llu us\n",
+               'A' + protocol,
+               stats->writes,
+               stats->writesFull,
+               stats->reads,
+               (unsigned long long)(stats->reads ? stats->latencySumNs / stats->reads / 1000 : 0),
+               (unsigned long long)(stats->latencyMaxNs / 1000));
+    }
+#    ifdef SIM_UNIX
+    shm_unlink(msi_sim_shmName);
+#    endif
+}
+
+/**
+ * @brief Starts the slave with id `slave_id`, in simulation the executable given by UDK_SIM_MSI_SLAVE
+ * @param slave_id slave id, first one is 1
+ * @return 0 if ok, -1 in case of error
+ */
+int msi_slave_start(const uint8_t slave_id)
 {
-    return 0;
+    if (slave_id != 1)
+    {
+        return -1;
+    }
+
+#    ifdef SIM_UNIX
+    const char *path = getenv("UDK_SIM_MSI_SLAVE");
+    if (path == NULL || msi_sim_slavePid > 0)
+    {
+        return -1;
+    }
+
+    msi_sim_sharedMem();
+    msi_sim_slavePid = fork();
+    if (msi_sim_slavePid == 0)
+    {
+#        ifdef __linux__
+        prctl(PR_SET_PDEATHSIG, SIGTERM);
+#        endif
+        execl(path, path, (char *)NULL);
+        perror(path);
+        _exit(1);
+    }
+    return (msi_sim_slavePid > 0) ? 0 : -1;
+#    else
+    return -1;
+#    endif
 }
-#endif
 
-#ifdef MSI_HAVE_MASTER_INTERFACE
-int msi_protocol_write(const uint8_t protocol, const unsigned char *data, uint8_t size)
+/**
+ * @brief Stops the slave with id `slave_id`
+ * @param slave_id slave id, first one is 1
+ * @return 0 if ok, -1 in case of error
+ */
+int msi_slave_stop(const uint8_t slave_id)
 {
-    UDK_UNUSED(protocol);
-    UDK_UNUSED(data);
-    UDK_UNUSED(size);
+    if (slave_id != 1)
+    {
+        return -1;
+    }
+
+#    ifdef SIM_UNIX
+    if (msi_sim_slavePid > 0)
+    {
+        kill(msi_sim_slavePid, SIGTERM);
+        waitpid(msi_sim_slavePid, NULL, 0);
+        msi_sim_slavePid = -1;
+    }
+#    endif
     return 0;
 }
 
-int msi_protocol_canWrite(const uint8_t protocol)
+/**
+ * @brief Resets the slave with id `slave_id`
+ * @param slave_id slave id, first one is 1
+ * @return 0 if ok, -1 in case of error
+ */
+int msi_slave_reset(const uint8_t slave_id)
 {
-    UDK_UNUSED(protocol);
-    return 1;
+    if (msi_slave_stop(slave_id) != 0)
+    {
+        return -1;
+    }
+    return msi_slave_start(slave_id);
 }
 
-int msi_protocol_read(const uint8_t protocol, unsigned char *data, uint8_t max_size)
+/**
+ * @brief Gives the status of the slave with id `slave_id`
+ * @param slave_id slave id, first one is 1
+ * @return MSI_CORE_STATUS status enum
+ */
+MSI_CORE_STATUS msi_slave_status(const uint8_t slave_id)
 {
-    UDK_UNUSED(protocol);
-    UDK_UNUSED(data);
-    UDK_UNUSED(max_size);
+    if (slave_id != 1)
+    {
+        return -1;
+    }
+
+#    ifdef SIM_UNIX
+    if (msi_sim_slavePid > 0 && waitpid(msi_sim_slavePid, NULL, WNOHANG) == 0)
+    {
+        return MSI_CORE_STATUS_STARTED;
+    }
+    msi_sim_slavePid = -1;
+#    endif
+    return MSI_CORE_STATUS_RESETED;
+}
+
+/**
+ * @brief Program the PRAM of slave, in simulation checks that UDK_SIM_MSI_SLAVE is set
+ * @param slave_id slave id, first one is 1
+ * @return 0 if ok, -1 in case of error
+ */
+int msi_slave_program(const uint8_t slave_id, __eds__ unsigned char *program)
+{
+    UDK_UNUSED(program);
+
+    if (slave_id != 1)
+    {
+        return -1;
+    }
+    if (getenv("UDK_SIM_MSI_SLAVE") == NULL)
+    {
+        puts("msi: UDK_SIM_MSI_SLAVE is not set, slave will not run");
+        return -1;
+    }
     return 0;
 }
 
-int msi_protocol_canRead(const uint8_t protocol)
+int msi_slave_verify_program(const uint8_t slave_id, __eds__ unsigned char *program)
 {
-    UDK_UNUSED(protocol);
-    return 1;
+    UDK_UNUSED(program);
+
+    if (slave_id != 1 || getenv("UDK_SIM_MSI_SLAVE") == NULL)
+    {
+        return -1;
+    }
+    return 0;
+}
+#else
+MSI_CORE_STATUS msi_master_status(void)
+{
+    return msi_sim_sharedMem()->masterStatus;
 }
 #endif
 
-#ifndef MSI_HAVE_MASTER_INTERFACE
 int msi_protocol_write(const uint8_t protocol, const unsigned char *data, uint8_t size)
 {
-    UDK_UNUSED(protocol);
-    UDK_UNUSED(data);
+    msi_sim_shared *mem = msi_sim_sharedMem();
     UDK_UNUSED(size);
+
+    if (protocol >= MSI_SIM_PROTOCOL_USED || msi_sim_isReceiver(protocol))
+    {
+        return -1;
+    }
+
+    pthread_mutex_lock(&mem->mutex);
+    if (mem->dataReady[protocol] == 1)
+    {
+        mem->stats[protocol].writesFull++;
+        pthread_mutex_unlock(&mem->mutex);
+        return -1;
+    }
+    memcpy(&mem->mailboxes[msi_sim_mailboxFirst[protocol]], data, msi_sim_mailboxCount[protocol] * sizeof(uint16_t));
+    mem->dataReady[protocol] = 1;
+    mem->sequence[protocol]++;
+    mem->stats[protocol].writes++;
+    mem->stats[protocol].writeTimeNs = msi_sim_timeNs();
+    pthread_cond_broadcast(&mem->cond);
+    pthread_mutex_unlock(&mem->mutex);
+
     return 0;
 }
 
+/**
+ * @brief Gets number of data that could be read (in sw buffer)
+ * @param protocol protocol id
+ * @return 0 if mail is full and can not be written, 1 if OK, -1 if protocol is not valid
+ */
 int msi_protocol_canWrite(const uint8_t protocol)
 {
-    UDK_UNUSED(protocol);
-    return 1;
+    if (protocol >= MSI_SIM_PROTOCOL_USED || msi_sim_isReceiver(protocol))
+    {
+        return -1;
+    }
+
+    return (msi_sim_sharedMem()->dataReady[protocol] == 1) ? 0 : 1;
 }
 
 int msi_protocol_read(const uint8_t protocol, unsigned char *data, uint8_t max_size)
 {
-    UDK_UNUSED(protocol);
-    UDK_UNUSED(data);
+    msi_sim_shared *mem = msi_sim_sharedMem();
+    msi_sim_stats *stats;
+    uint64_t latencyNs;
     UDK_UNUSED(max_size);
+
+    if (protocol >= MSI_SIM_PROTOCOL_USED || !msi_sim_isReceiver(protocol))
+    {
+        return -1;
+    }
+
+    pthread_mutex_lock(&mem->mutex);
+    if (mem->dataReady[protocol] == 0)
+    {
+        pthread_mutex_unlock(&mem->mutex);
+        return -1;
+    }
+    memcpy(data, &mem->mailboxes[msi_sim_mailboxFirst[protocol]], msi_sim_mailboxCount[protocol] * sizeof(uint16_t));
+    mem->dataReady[protocol] = 0;  // cleared by hardware on last mailbox read
+
+    stats = &mem->stats[protocol];
+    latencyNs = msi_sim_timeNs() - stats->writeTimeNs;
+    stats->reads++;
+    stats->latencySumNs += latencyNs;
+    if (latencyNs > stats->latencyMaxNs)
+    {
+        stats->latencyMaxNs = latencyNs;
+    }
+    pthread_cond_broadcast(&mem->cond);
+    pthread_mutex_unlock(&mem->mutex);
+
     return 0;
 }
 
+/**
+ * @brief Gets number of data that could be read (in sw buffer)
+ * @param protocol protocol id
+ * @return 0 if mail is empty, 1 if OK to be read, -1 if protocol is not valid
+ */
 int msi_protocol_canRead(const uint8_t protocol)
 {
-    UDK_UNUSED(protocol);
-    return 1;
+    if (protocol >= MSI_SIM_PROTOCOL_USED || !msi_sim_isReceiver(protocol))
+    {
+        return -1;
+    }
+
+    return (msi_sim_sharedMem()->dataReady[protocol] == 0) ? 0 : 1;
 }
-#endif
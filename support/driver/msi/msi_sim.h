@@ -0,0 +1,29 @@
+/**
+ * @file msi_sim.h
+ * @author agent
+ * @copyright UniSwarm 2026
+ *
+ * @date October 19, 2026, 04:20 PM
+ *
+ * @brief MSI udevkit simulator support for simulation purpose
+ */
+
+#ifndef MSI_SIM_H
+#define MSI_SIM_H
+
+#include <stdint.h>
+
+#ifndef MSI_MAILBOX_COUNT
+#    define MSI_MAILBOX_COUNT 16
+#endif
+#ifndef MSI_PROTOCOL_COUNT
+#    define MSI_PROTOCOL_COUNT 8
+#endif
+
+#ifndef SIMULATOR
+#    define msi_sim_setHandler(protocol, handler) 0
+#else
+int msi_sim_setHandler(const uint8_t protocol, void (*handler)(void));
+#endif
+
+#endif  // MSI_SIM_H
@@ -47,4 +47,11 @@ int sysclock_setSourceFreq(SYSCLOCK_SOURCE source, uint32_t freq);
 SYSCLOCK_SOURCE sysclock_source(void);
 int sysclock_switchSourceTo(SYSCLOCK_SOURCE source);
 
+// ===== simulated cpu cycles =====
+#ifdef SIMULATOR
+#    include "simulator_cycles.h"
+#else
+#    define sim_consume_cycles(cycles)
+#endif
+
 #endif  // SYSCLOCK_H
@@ -12,6 +12,9 @@
 #include <stdint.h>
 
 #include "sysclock.h"
+#ifdef SIMULATOR
+#    include "simulator_cycles.h"
+#endif
 
 /****************************************************************************************/
 /*          Privates functions                                                          */
@@ -29,6 +32,9 @@ static uint32_t pllfreq;
 int sysclock_setClock(uint32_t fosc)
 {
     sysfreq = fosc;
+#ifdef SIMULATOR
+    simulator_cycles_setFreq(sysclock_getCPUSystemClock());
+#endif
     return 0;
 }
 
@@ -10,6 +10,7 @@
  */
 
 #include "simulator.h"
+#include "simulator_cycles.h"
 #include "timer.h"
 
 #include "driver/sysclock.h"
@@ -71,17 +72,27 @@ static struct timer_dev timers[] = {
 #endif
 };
 
+static void timer_sim_sleepUs(uint32_t periodUs)
+{
+#ifdef SIM_UNIX
+    struct timespec period = {periodUs / 1000000, (periodUs % 1000000) * 1000L};
+    nanosleep(&period, NULL);
+#else
+    Sleep((periodUs + 999) / 1000);
+#endif
+}
+
 #if TIMER_COUNT >= 1
 static void *timer1_handler(void *p_data)
 {
     UDK_UNUSED(p_data);
     while (1)
     {
-        usleep(timers[0].periodUs);
+        timer_sim_sleepUs(timers[0].periodUs);
         timers[0].value++;
         if (timers[0].handler)
         {
-            (*timers[0].handler)();
+            simulator_cycles_call("timer1", timers[0].handler, timers[0].periodUs);
         }
     }
     return NULL;
@@ -94,11 +105,11 @@ static void *timer2_handler(void *p_data)
     UDK_UNUSED(p_data);
     while (1)
     {
-        psleep(timers[1].periodUs);
+        timer_sim_sleepUs(timers[1].periodUs);
         timers[1].value++;
         if (timers[1].handler)
         {
-            (*timers[1].handler)();
+            simulator_cycles_call("timer2", timers[1].handler, timers[1].periodUs);
         }
     }
     return NULL;
@@ -111,11 +122,11 @@ static void *timer3_handler(void *p_data)
     UDK_UNUSED(p_data);
     while (1)
     {
-        psleep(timers[2].periodUs);
+        timer_sim_sleepUs(timers[2].periodUs);
         timers[2].value++;
         if (timers[2].handler)
         {
-            (*timers[2].handler)();
+            simulator_cycles_call("timer3", timers[2].handler, timers[2].periodUs);
         }
     }
     return NULL;
@@ -128,11 +139,11 @@ static void *timer4_handler(void *p_data)
     UDK_UNUSED(p_data);
     while (1)
     {
-        psleep(timers[3].periodUs);
+        timer_sim_sleepUs(timers[3].periodUs);
         timers[3].value++;
         if (timers[3].handler)
         {
-            (*timers[3].handler)();
+            simulator_cycles_call("timer4", timers[3].handler, timers[3].periodUs);
         }
     }
     return NULL;
@@ -145,11 +156,11 @@ static void *timer5_handler(void *p_data)
     UDK_UNUSED(p_data);
     while (1)
     {
-        psleep(timers[4].periodUs);
+        timer_sim_sleepUs(timers[4].periodUs);
         timers[4].value++;
         if (timers[4].handler)
         {
-            (*timers[4].handler)();
+            simulator_cycles_call("timer5", timers[4].handler, timers[4].periodUs);
         }
     }
     return NULL;
@@ -162,11 +173,11 @@ static void *timer6_handler(void *p_data)
     UDK_UNUSED(p_data);
     while (1)
     {
-        psleep(timers[5].periodUs);
+        timer_sim_sleepUs(timers[5].periodUs);
         timers[5].value++;
         if (timers[5].handler)
         {
-            (*timers[5].handler)();
+            simulator_cycles_call("timer6", timers[5].handler, timers[5].periodUs);
         }
     }
     return NULL;
@@ -179,11 +190,11 @@ static void *timer7_handler(void *p_data)
     UDK_UNUSED(p_data);
     while (1)
     {
-        psleep(timers[6].periodUs);
+        timer_sim_sleepUs(timers[6].periodUs);
         timers[6].value++;
         if (timers[6].handler)
         {
-            (*timers[6].handler)();
+            simulator_cycles_call("timer7", timers[6].handler, timers[6].periodUs);
         }
     }
     return NULL;
@@ -196,11 +207,11 @@ static void *timer8_handler(void *p_data)
     UDK_UNUSED(p_data);
     while (1)
     {
-        psleep(timers[7].periodUs);
+        timer_sim_sleepUs(timers[7].periodUs);
         timers[7].value++;
         if (timers[7].handler)
         {
-            (*timers[7].handler)();
+            simulator_cycles_call("timer8", timers[7].handler, timers[7].periodUs);
         }
     }
     return NULL;
@@ -213,11 +224,11 @@ static void *timer9_handler(void *p_data)
     UDK_UNUSED(p_data);
     while (1)
     {
-        psleep(timers[8].periodUs);
+        timer_sim_sleepUs(timers[8].periodUs);
         timers[8].value++;
         if (timers[8].handler)
         {
-            (*timers[8].handler)();
+            simulator_cycles_call("timer9", timers[8].handler, timers[8].periodUs);
         }
     }
     return NULL;
@@ -46,6 +46,20 @@ int uart_transmitFinished(rt_dev_t device);
 ssize_t uart_read(rt_dev_t device, char *data, size_t size_max);
 ssize_t uart_datardy(rt_dev_t device);
 
+// ========= rx handler ==========
+typedef enum
+{
+    UART_RX_HANDLER_SIZE = 0x0,       ///< handler called each time param bytes are received
+    UART_RX_HANDLER_DELIMITER = 0x1,  ///< handler called with data up to and including the param delimiter char
+    UART_RX_HANDLER_IDLE = 0x2        ///< handler called when the line is idle for param bit times, needs softtimer
+} UART_RX_HANDLER_MODE;
+int uart_setRxHandler(rt_dev_t device,
+                      UART_RX_HANDLER_MODE mode,
+                      uint16_t param,
+                      void (*handler)(rt_dev_t device, const char *data, size_t size));
+struct SchedulerTask;
+int uart_setRxTask(rt_dev_t device, struct SchedulerTask *task, uint16_t events);
+
 // ======= specific include =======
 #if defined(ARCHI_pic24ep) || defined(ARCHI_pic24f) || defined(ARCHI_pic24fj) || defined(ARCHI_pic24hj)                \
     || defined(ARCHI_dspic33fj) || defined(ARCHI_dspic33ep) || defined(ARCHI_dspic33ev)
@@ -61,4 +75,8 @@ ssize_t uart_datardy(rt_dev_t device);
 #    include "uart_pic32mz_mm_mk.h"
 #endif
 
+#ifdef SIMULATOR
+#    include "uart_sim.h"
+#endif
+
 #endif  // UART_H
@@ -8,6 +8,13 @@ DRIVERS += sysclock
 
 HEADER += uart.h
 
+# rx handlers shared by drivers, only built with SYS += uart_rx
+HEADER += uart_rx.h
+ifneq ($(filter uart_rx,$(SYS)),)
+ SRC += uart_rx.c
+ $(OUT_PWD)/uart_rx.o: $(OUT_PWD)/modules.h
+endif
+
 ifeq ($(ARCHI),$(filter $(ARCHI),pic24f pic24fj pic24ep pic24hj dspic33fj dspic33ep dspic33ev))
  ARCHI_SRC += uart_pic24_dspic33.c
  HEADER += uart_pic24_dspic33.h
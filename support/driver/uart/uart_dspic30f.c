@@ -13,6 +13,7 @@
  */
 
 #include "uart.h"
+#include "uart_rx.h"
 
 #include <archi.h>
 #include <driver/sysclock.h>
@@ -50,6 +51,7 @@ struct uart_dev
 
     STATIC_FIFO(buffRx, UART_BUFFRX_SIZE);
     STATIC_FIFO(buffTx, UART_BUFFTX_SIZE);
+    uart_rx_handler rxHandler;
 };
 
 struct uart_dev uarts[] = {
@@ -270,6 +272,7 @@ int uart_setBaudSpeed(rt_dev_t device, uint32_t baudSpeed)
     }
 
     uarts[uart].baudSpeed = baudSpeed;
+    uart_rx_setBaudSpeed(&uarts[uart].rxHandler, baudSpeed);
 
     // baud rate computation
     systemClockPeriph = sysclock_periphFreq(SYSCLOCK_CLOCK_UART);
@@ -523,6 +526,7 @@ void __attribute__((interrupt, no_auto_psv)) _U1RXInterrupt(void)
     rec[0] = U1RXREG;
 
     fifo_push(&uarts[0].buffRx, rec, 1);
+    uart_rx_received(&uarts[0].rxHandler, rec[0]);
 
     _U1RXIF = 0;
 }
@@ -545,6 +549,7 @@ void __attribute__((interrupt, no_auto_psv)) _U2RXInterrupt(void)
     rec[0] = U2RXREG;
 
     fifo_push(&uarts[1].buffRx, rec, 1);
+    uart_rx_received(&uarts[1].rxHandler, rec[0]);
 
     _U2RXIF = 0;
 }
@@ -682,3 +687,49 @@ ssize_t uart_read(rt_dev_t device, char *data, size_t size_max)
     return -1;
 #endif
 }
+
+/**
+ * @brief Sets a handler called from rx interrupt with received data instead of polling uart_read
+ * @param device uart device number
+ * @param mode handler call condition
+ * @param param byte count, delimiter char or idle bit times depending on mode
+ * @param handler handler getting a contiguous span of rx fifo, NULL to get back to uart_read
+ * @return 0 if ok, -1 in case of error
+ */
+int uart_setRxHandler(rt_dev_t device,
+                      UART_RX_HANDLER_MODE mode,
+                      uint16_t param,
+                      void (*handler)(rt_dev_t device, const char *data, size_t size))
+{
+    uint8_t uart = MINOR(device);
+    if (uart >= UART_COUNT)
+    {
+        return -1;
+    }
+
+    return uart_rx_setHandler(&uarts[uart].rxHandler,
+                              device,
+                              &uarts[uart].buffRx,
+                              uart_effectiveBaudSpeed(device),
+                              mode,
+                              param,
+                              handler);
+}
+
+/**
+ * @brief Signals a scheduler task from rx interrupt on each received byte, the task reads them with uart_read
+ * @param device uart device number
+ * @param task task to signal, replaces the rx handler, NULL to stop signaling
+ * @param events events given to scheduler_signal
+ * @return 0 if ok, -1 in case of error
+ */
+int uart_setRxTask(rt_dev_t device, struct SchedulerTask *task, uint16_t events)
+{
+    uint8_t uart = MINOR(device);
+    if (uart >= UART_COUNT)
+    {
+        return -1;
+    }
+
+    return uart_rx_setTask(&uarts[uart].rxHandler, device, &uarts[uart].buffRx, task, events);
+}
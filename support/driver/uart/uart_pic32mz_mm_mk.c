@@ -14,6 +14,7 @@
  */
 
 #include "uart.h"
+#include "uart_rx.h"
 
 #include <archi.h>
 #include <driver/sysclock.h>
@@ -51,6 +52,7 @@ struct uart_dev
 
     STATIC_FIFO(buffRx, UART_BUFFRX_SIZE);
     STATIC_FIFO(buffTx, UART_BUFFTX_SIZE);
+    uart_rx_handler rxHandler;
 };
 
 struct uart_dev uarts[] = {
@@ -397,6 +399,7 @@ int uart_setBaudSpeed(rt_dev_t device, uint32_t baudSpeed)
     }
 
     uarts[uart].baudSpeed = baudSpeed;
+    uart_rx_setBaudSpeed(&uarts[uart].rxHandler, baudSpeed);
 
     // baud rate computation
     systemClockPeriph = uart_getClock(device);
@@ -728,6 +731,7 @@ void __ISR(_UART1_RX_VECTOR, UIPR) U1RXInterrupt(void)
     {
         rec[0] = U1RXREG;
         fifo_push(&uarts[0].buffRx, rec, 1);
+        uart_rx_received(&uarts[0].rxHandler, rec[0]);
     }
 
     _U1RXIF = 0;
@@ -761,6 +765,7 @@ void __ISR(_UART2_RX_VECTOR, UIPR) U2RXInterrupt(void)
     {
         rec[0] = U2RXREG;
         fifo_push(&uarts[1].buffRx, rec, 1);
+        uart_rx_received(&uarts[1].rxHandler, rec[0]);
     }
 
     _U2RXIF = 0;
@@ -794,6 +799,7 @@ void __ISR(_UART3_RX_VECTOR, UIPR) U3RXInterrupt(void)
     {
         rec[0] = U3RXREG;
         fifo_push(&uarts[2].buffRx, rec, 1);
+        uart_rx_received(&uarts[2].rxHandler, rec[0]);
     }
 
     _U3RXIF = 0;
@@ -833,6 +839,7 @@ void __ISR(_UART4_RX_VECTOR, UIPR) U4RXInterrupt(void)
     {
         rec[0] = U4RXREG;
         fifo_push(&uarts[3].buffRx, rec, 1);
+        uart_rx_received(&uarts[3].rxHandler, rec[0]);
     }
 
     _U4RXIF = 0;
@@ -866,6 +873,7 @@ void __ISR(_UART5_RX_VECTOR, UIPR) U5RXInterrupt(void)
     {
         rec[0] = U5RXREG;
         fifo_push(&uarts[4].buffRx, rec, 1);
+        uart_rx_received(&uarts[4].rxHandler, rec[0]);
     }
 
     _U5RXIF = 0;
@@ -899,6 +907,7 @@ void __ISR(_UART6_RX_VECTOR, UIPR) U6RXInterrupt(void)
     {
         rec[0] = U6RXREG;
         fifo_push(&uarts[5].buffRx, rec, 1);
+        uart_rx_received(&uarts[5].rxHandler, rec[0]);
     }
 
     _U6RXIF = 0;
@@ -1072,3 +1081,49 @@ ssize_t uart_read(rt_dev_t device, char *data, size_t size_max)
 
     return size_read;
 }
+
+/**
+ * @brief Sets a handler called from rx interrupt with received data instead of polling uart_read
+ * @param device uart device number
+ * @param mode handler call condition
+ * @param param byte count, delimiter char or idle bit times depending on mode
+ * @param handler handler getting a contiguous span of rx fifo, NULL to get back to uart_read
+ * @return 0 if ok, -1 in case of error
+ */
+int uart_setRxHandler(rt_dev_t device,
+                      UART_RX_HANDLER_MODE mode,
+                      uint16_t param,
+                      void (*handler)(rt_dev_t device, const char *data, size_t size))
+{
+    uint8_t uart = MINOR(device);
+    if (uart >= UART_COUNT)
+    {
+        return -1;
+    }
+
+    return uart_rx_setHandler(&uarts[uart].rxHandler,
+                              device,
+                              &uarts[uart].buffRx,
+                              uart_effectiveBaudSpeed(device),
+                              mode,
+                              param,
+                              handler);
+}
+
+/**
+ * @brief Signals a scheduler task from rx interrupt on each received byte, the task reads them with uart_read
+ * @param device uart device number
+ * @param task task to signal, replaces the rx handler, NULL to stop signaling
+ * @param events events given to scheduler_signal
+ * @return 0 if ok, -1 in case of error
+ */
+int uart_setRxTask(rt_dev_t device, struct SchedulerTask *task, uint16_t events)
+{
+    uint8_t uart = MINOR(device);
+    if (uart >= UART_COUNT)
+    {
+        return -1;
+    }
+
+    return uart_rx_setTask(&uarts[uart].rxHandler, device, &uarts[uart].buffRx, task, events);
+}
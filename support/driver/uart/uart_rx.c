@@ -0,0 +1,359 @@
+/**
+ * @file uart_rx.c
+ * @author agent
+ * @copyright UniSwarm 2026
+ *
+ * @date October 19, 2026, 09:40 PM
+ *
+ * @brief Uart rx handlers shared by uart drivers
+ *
+ * Size and delimiter modes are checked on each received byte in the rx
+ * interrupt. Idle mode uses one periodic soft timer for all uarts : the line
+ * is idle when no byte was received during a whole period, handlers are
+ * called between one and two idle times after the last byte. All modes flush
+ * the fifo to the handler when it is full. A scheduler task set instead of a
+ * handler is signaled on each byte, bytes stay in the fifo for uart_read.
+ */
+
+#include "uart_rx.h"
+
+#include "modules.h"
+#include <archi.h>
+
+#ifdef SIMULATOR
+#    include "uart_sim.h"
+// handlers are called with the uart mutex held in simulation, like from the rx interrupt
+#    define uart_rx_lock(state)                                                                                        \
+        do                                                                                                             \
+        {                                                                                                              \
+            disable_interrupt_save(state);                                                                             \
+            uart_sim_rxLock();                                                                                         \
+        } while (0)
+#    define uart_rx_unlock(state)                                                                                      \
+        do                                                                                                             \
+        {                                                                                                              \
+            uart_sim_rxUnlock();                                                                                       \
+            restore_interrupt(state);                                                                                  \
+        } while (0)
+#else
+#    define uart_rx_lock(state)   disable_interrupt_save(state)
+#    define uart_rx_unlock(state) restore_interrupt(state)
+#endif
+
+#ifdef USE_SYS_scheduler
+#    include <sys/scheduler.h>
+#endif
+
+#ifdef USE_SYS_softtimer
+#    include <sys/softtimer.h>
+
+static uart_rx_handler *uart_rx_idleHandlers[UART_COUNT];
+static uint32_t uart_rx_idleUs[UART_COUNT];
+static SoftTimer uart_rx_idleTimer;
+
+static void uart_rx_idleTask(void);
+#endif
+
+// copy of small frames wrapping at the end of a fifo, shared by all uarts
+static char uart_rx_bounce[UART_RX_BOUNCE_SIZE];
+static volatile uint8_t uart_rx_bounceBusy = 0;
+
+static int uart_rx_bounceClaim(void)
+{
+    rt_reg_t irqState;
+    int claimed = 0;
+
+    uart_rx_lock(irqState);
+    if (!uart_rx_bounceBusy)
+    {
+        uart_rx_bounceBusy = 1;
+        claimed = 1;
+    }
+    uart_rx_unlock(irqState);
+    return claimed;
+}
+
+static void uart_rx_deliver(uart_rx_handler *rxHandler, size_t size)
+{
+    const char *data;
+    size_t span;
+
+    rxHandler->busy = 1;
+    span = fifo_span(rxHandler->fifo, &data);
+    if (span >= size)
+    {
+        rxHandler->handler(rxHandler->device, data, size);
+        fifo_drop(rxHandler->fifo, size);
+    }
+    else if (size <= UART_RX_BOUNCE_SIZE && uart_rx_bounceClaim())
+    {
+        // frame wraps at the end of the fifo
+        fifo_pop(rxHandler->fifo, uart_rx_bounce, size);
+        rxHandler->handler(rxHandler->device, uart_rx_bounce, size);
+        uart_rx_bounceBusy = 0;
+    }
+    else
+    {
+        // too long to be copied, given in two spans
+        rxHandler->handler(rxHandler->device, data, span);
+        fifo_drop(rxHandler->fifo, span);
+        fifo_span(rxHandler->fifo, &data);
+        rxHandler->handler(rxHandler->device, data, size - span);
+        fifo_drop(rxHandler->fifo, size - span);
+    }
+    rxHandler->busy = 0;
+}
+
+#ifdef USE_SYS_softtimer
+static uint32_t uart_rx_idleTime(uint16_t param, uint32_t baudSpeed)
+{
+    uint64_t idleUs = ((uint64_t)param * 1000000 + baudSpeed - 1) / baudSpeed;
+    if (idleUs > UINT32_MAX)
+    {
+        return UINT32_MAX;
+    }
+    return idleUs;
+}
+
+/**
+ * @brief Restarts the idle timer with the shortest requested idle time, stops it if none
+ */
+static void uart_rx_idleRestart(void)
+{
+    uint32_t idleUs = 0;
+    uint8_t i;
+
+    for (i = 0; i < UART_COUNT; i++)
+    {
+        if (uart_rx_idleUs[i] != 0 && (idleUs == 0 || uart_rx_idleUs[i] < idleUs))
+        {
+            idleUs = uart_rx_idleUs[i];
+        }
+    }
+    if (idleUs == 0)
+    {
+        softtimer_stop(&uart_rx_idleTimer);
+    }
+    else
+    {
+        softtimer_start(&uart_rx_idleTimer, uart_rx_idleTask, idleUs, idleUs);
+    }
+}
+#endif
+
+/**
+ * @brief Sets the rx handler of a uart, called by the driver uart_setRxHandler
+ * @param rxHandler driver handler storage of the uart
+ * @param device uart device number
+ * @param fifo driver rx fifo of the uart
+ * @param baudSpeed uart baud speed, used in idle mode
+ * @param mode handler call condition
+ * @param param byte count, delimiter char or idle bit times depending on mode
+ * @param handler handler called from interrupt, NULL to get back to uart_read
+ * @return 0 if ok, -1 in case of error
+ */
+int uart_rx_setHandler(uart_rx_handler *rxHandler,
+                       rt_dev_t device,
+                       Fifo *fifo,
+                       uint32_t baudSpeed,
+                       UART_RX_HANDLER_MODE mode,
+                       uint16_t param,
+                       void (*handler)(rt_dev_t device, const char *data, size_t size))
+{
+#ifdef USE_SYS_softtimer
+    uint8_t uart = MINOR(device);
+    uint32_t idleUs = 0;
+#endif
+
+    if (handler != NULL)
+    {
+        if (mode == UART_RX_HANDLER_SIZE && (param == 0 || param >= fifo->size))
+        {
+            return -1;
+        }
+        if (mode == UART_RX_HANDLER_IDLE)
+        {
+#ifdef USE_SYS_softtimer
+            if (param == 0 || baudSpeed == 0)
+            {
+                return -1;
+            }
+            idleUs = uart_rx_idleTime(param, baudSpeed);
+#else
+            return -1;  // needs softtimer
+#endif
+        }
+    }
+
+    rxHandler->handler = NULL;
+    rxHandler->fifo = fifo;
+    rxHandler->device = device;
+    rxHandler->param = param;
+    rxHandler->mode = mode;
+    rxHandler->activity = 0;
+    rxHandler->busy = 0;
+    rxHandler->task = NULL;
+    rxHandler->handler = handler;
+
+#ifdef USE_SYS_softtimer
+    if (handler != NULL && mode == UART_RX_HANDLER_IDLE)
+    {
+        uart_rx_idleHandlers[uart] = rxHandler;
+        uart_rx_idleUs[uart] = idleUs;
+    }
+    else
+    {
+        uart_rx_idleHandlers[uart] = NULL;
+        uart_rx_idleUs[uart] = 0;
+    }
+
+    uart_rx_idleRestart();
+#endif
+
+    return 0;
+}
+
+#ifdef USE_SYS_scheduler
+/**
+ * @brief Sets a scheduler task signaled on each received byte, called by the driver uart_setRxTask
+ * @param rxHandler driver handler storage of the uart
+ * @param device uart device number
+ * @param fifo driver rx fifo of the uart
+ * @param task task signaled from rx interrupt, replaces the handler, NULL to get back to uart_read only
+ * @param events events given to scheduler_signal
+ * @return 0 if ok, -1 in case of error
+ */
+int uart_rx_setTask(uart_rx_handler *rxHandler,
+                    rt_dev_t device,
+                    Fifo *fifo,
+                    struct SchedulerTask *task,
+                    uint16_t events)
+{
+    if (task != NULL && events == 0)
+    {
+        return -1;
+    }
+
+    // removes the handler and its idle timer
+    uart_rx_setHandler(rxHandler, device, fifo, 0, UART_RX_HANDLER_SIZE, 0, NULL);
+    rxHandler->events = events;
+    rxHandler->task = task;
+
+    return 0;
+}
+#endif
+
+/**
+ * @brief Updates the idle time of a uart after a baud speed change, called by the driver uart_setBaudSpeed
+ * @param rxHandler driver handler storage of the uart
+ * @param baudSpeed new uart baud speed
+ */
+void uart_rx_setBaudSpeed(uart_rx_handler *rxHandler, uint32_t baudSpeed)
+{
+#ifdef USE_SYS_softtimer
+    uint8_t uart = MINOR(rxHandler->device);
+
+    if (rxHandler->handler == NULL || rxHandler->mode != UART_RX_HANDLER_IDLE || baudSpeed == 0)
+    {
+        return;
+    }
+    uart_rx_idleUs[uart] = uart_rx_idleTime(rxHandler->param, baudSpeed);
+    uart_rx_idleRestart();
+#else
+    UDK_UNUSED(rxHandler);
+    UDK_UNUSED(baudSpeed);
+#endif
+}
+
+/**
+ * @brief Checks handler condition after a received byte, use uart_rx_received in rx interrupt
+ * @param rxHandler driver handler storage of the uart
+ * @param byte last byte pushed in the fifo
+ */
+void uart_rx_dispatch(uart_rx_handler *rxHandler, char byte)
+{
+    size_t len;
+
+    if (rxHandler->handler == NULL)
+    {
+#ifdef USE_SYS_scheduler
+        if (rxHandler->task != NULL)
+        {
+            scheduler_signal(rxHandler->task, rxHandler->events);
+        }
+#endif
+        return;
+    }
+
+    len = fifo_len(rxHandler->fifo);
+    switch (rxHandler->mode)
+    {
+        case UART_RX_HANDLER_SIZE:
+            while (len >= rxHandler->param)
+            {
+                uart_rx_deliver(rxHandler, rxHandler->param);
+                len -= rxHandler->param;
+            }
+            break;
+
+        case UART_RX_HANDLER_DELIMITER:
+            if (byte == (char)rxHandler->param || fifo_avail(rxHandler->fifo) == 0)
+            {
+                uart_rx_deliver(rxHandler, len);
+            }
+            break;
+
+        case UART_RX_HANDLER_IDLE:
+            rxHandler->activity = 1;
+            if (fifo_avail(rxHandler->fifo) == 0 && !rxHandler->busy)
+            {
+                uart_rx_deliver(rxHandler, len);
+            }
+            break;
+    }
+}
+
+#ifdef USE_SYS_softtimer
+static void uart_rx_idleTask(void)
+{
+    uart_rx_handler *rxHandler;
+    rt_reg_t irqState;
+    size_t len;
+    uint8_t i;
+
+    for (i = 0; i < UART_COUNT; i++)
+    {
+        len = 0;
+        uart_rx_lock(irqState);
+        rxHandler = uart_rx_idleHandlers[i];
+        if (rxHandler != NULL && !rxHandler->busy)
+        {
+            if (rxHandler->activity)
+            {
+                rxHandler->activity = 0;
+            }
+            else
+            {
+                len = fifo_len(rxHandler->fifo);
+                if (len > 0)
+                {
+                    rxHandler->busy = 1;  // holds off delivery from the rx interrupt
+                }
+            }
+        }
+#    ifdef SIMULATOR
+        if (len > 0)
+        {
+            uart_rx_deliver(rxHandler, len);
+        }
+        uart_rx_unlock(irqState);
+#    else
+        uart_rx_unlock(irqState);
+        if (len > 0)
+        {
+            uart_rx_deliver(rxHandler, len);
+        }
+#    endif
+    }
+}
+#endif
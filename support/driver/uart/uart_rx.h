@@ -0,0 +1,85 @@
+/**
+ * @file uart_rx.h
+ * @author agent
+ * @copyright UniSwarm 2026
+ *
+ * @date October 19, 2026, 09:40 PM
+ *
+ * @brief Uart rx handlers shared by uart drivers
+ *
+ * Drivers keep one uart_rx_handler per uart and call uart_rx_received from
+ * the rx interrupt after each byte pushed in the rx fifo. Handlers get a
+ * contiguous span of the rx fifo, popped when they return. Only built with
+ * SYS += uart_rx, uart_setRxHandler returns -1 otherwise.
+ *
+ * Instead of a handler, a scheduler task can be signaled on each received
+ * byte and read them with uart_read out of interrupt, this also needs
+ * SYS += scheduler, uart_setRxTask returns -1 otherwise.
+ */
+
+#ifndef UART_RX_H
+#define UART_RX_H
+
+#include "uart.h"
+
+#include "modules.h"
+#include <sys/fifo.h>
+
+// wrapped frames up to this size are copied to give one span, larger ones are given in two calls
+#ifndef UART_RX_BOUNCE_SIZE
+#    define UART_RX_BOUNCE_SIZE 64
+#endif
+
+struct SchedulerTask;
+
+typedef struct
+{
+    void (*handler)(rt_dev_t device, const char *data, size_t size);
+    Fifo *fifo;
+    rt_dev_t device;
+    uint16_t param;
+    uint8_t mode;
+    volatile uint8_t activity;   // byte received since the last idle check
+    volatile uint8_t busy;       // handler running
+    struct SchedulerTask *task;  // signaled on each byte when no handler is set
+    uint16_t events;
+} uart_rx_handler;
+
+#ifdef USE_SYS_uart_rx
+int uart_rx_setHandler(uart_rx_handler *rxHandler,
+                       rt_dev_t device,
+                       Fifo *fifo,
+                       uint32_t baudSpeed,
+                       UART_RX_HANDLER_MODE mode,
+                       uint16_t param,
+                       void (*handler)(rt_dev_t device, const char *data, size_t size));
+void uart_rx_setBaudSpeed(uart_rx_handler *rxHandler, uint32_t baudSpeed);
+void uart_rx_dispatch(uart_rx_handler *rxHandler, char byte);
+
+#    define uart_rx_active(rxHandler) ((rxHandler)->handler != NULL || (rxHandler)->task != NULL)
+#    define uart_rx_received(rxHandler, byte)                                                                          \
+        do                                                                                                             \
+        {                                                                                                              \
+            if (uart_rx_active(rxHandler))                                                                             \
+            {                                                                                                          \
+                uart_rx_dispatch((rxHandler), (byte));                                                                 \
+            }                                                                                                          \
+        } while (0)
+#else
+#    define uart_rx_setHandler(rxHandler, device, fifo, baudSpeed, mode, param, handler) (-1)
+#    define uart_rx_setBaudSpeed(rxHandler, baudSpeed)
+#    define uart_rx_active(rxHandler) (0)
+#    define uart_rx_received(rxHandler, byte)
+#endif
+
+#if defined(USE_SYS_uart_rx) && defined(USE_SYS_scheduler)
+int uart_rx_setTask(uart_rx_handler *rxHandler,
+                    rt_dev_t device,
+                    Fifo *fifo,
+                    struct SchedulerTask *task,
+                    uint16_t events);
+#else
+#    define uart_rx_setTask(rxHandler, device, fifo, task, events) (-1)
+#endif
+
+#endif  // UART_RX_H
@@ -7,11 +7,23 @@
  * @date April 13, 2016, 11:49 AM
  *
  * @brief Uart simulator support for udevkit for simulation purpose
+ *
+ * By default, uart data are exchanged with udk-sim. An uart can instead be
+ * bridged to a host pty or serial device with uart_sim_setPort or with the
+ * UDK_SIM_UART<n> environment variable (n is the uart number as in uart(n)),
+ * set to UART_SIM_BRIDGE_PTY or to a device path like /dev/ttyUSB0.
+ * Bridged data are binary safe, received bytes are pushed to a fifo by an
+ * epoll thread which calls the uart rx handler, no polling is needed. Once an
+ * rx handler is set on a udk-sim uart, udk-sim data are received by a thread
+ * too.
  */
 
+#define _GNU_SOURCE
+
 #include "uart_sim.h"
 #include "simulator.h"
 #include "uart.h"
+#include "uart_rx.h"
 
 #include "driver/sysclock.h"
 #include "sys/fifo.h"
@@ -21,11 +33,38 @@
 #endif
 
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef SIM_UNIX
+#    include <errno.h>
+#    include <fcntl.h>
+#    include <poll.h>
+#    include <sys/epoll.h>
+#    include <termios.h>
+#    include <time.h>
+#    include <unistd.h>
+#endif
+
+#define UART_SIM_BRIDGE_BUFF_SIZE 4096
+#define UART_SIM_PACKET_SIZE      2048  // udk-sim packets size limit
+#define UART_SIM_RX_WAIT_MS       10
+#define UART_SIM_BRIDGE_RETRY_MS  100
 
 /****************************************************************************************/
 /*          Privates functions                                                          */
 void uart_sendconfig(uint8_t uart);
 void uart_closeDevice(rt_dev_t device);
+#ifdef SIM_UNIX
+static int uart_sim_bridgeOpen(uint8_t uart, const char *port);
+static void uart_sim_bridgeClose(uint8_t uart);
+static void uart_sim_bridgeConfig(uint8_t uart);
+static void *uart_sim_bridgeThread(void *arg);
+static void uart_sim_bridgeArm(uint8_t uart);
+#endif
+static void uart_sim_rxPush(uint8_t uart, const char *data, size_t size);
+static void *uart_sim_rxThread(void *arg);
+static void uart_sim_rxThreadStart(void);
 
 /****************************************************************************************/
 /*          External variable                                                           */
@@ -52,9 +91,492 @@ uart_dev uarts[] = {
 #endif
 };
 
+typedef struct
+{
+    int fd;       // host device or pty master, -1 if not bridged
+    int slaveFd;  // pty slave kept open to keep raw mode, -1 otherwise
+    Fifo rxFifo;
+    char rxBuff[UART_SIM_BRIDGE_BUFF_SIZE];
+    uart_rx_handler rxHandler;
+    uint8_t rxArmed;  // fd watched by the rx thread, cleared when the rx fifo is full
+} uart_sim_bridge;
+
+static uart_sim_bridge uart_sim_bridges[] = {
+    {.fd = -1, .slaveFd = -1},
+#if UART_COUNT >= 2
+    {.fd = -1, .slaveFd = -1},
+#endif
+#if UART_COUNT >= 3
+    {.fd = -1, .slaveFd = -1},
+#endif
+#if UART_COUNT >= 4
+    {.fd = -1, .slaveFd = -1},
+#endif
+#if UART_COUNT >= 5
+    {.fd = -1, .slaveFd = -1},
+#endif
+#if UART_COUNT >= 6
+    {.fd = -1, .slaveFd = -1},
+#endif
+};
+// rx handlers are called with the mutex held, like an rx interrupt, and may call uart functions
+static pthread_mutex_t uart_sim_bridgeMutex;
+static pthread_once_t uart_sim_bridgeMutexOnce = PTHREAD_ONCE_INIT;
+#ifdef SIM_UNIX
+static int uart_sim_epollFd = -1;
+static pthread_t uart_sim_bridgeThreadId;
+#endif
+static pthread_t uart_sim_rxThreadId;
+static uint8_t uart_sim_rxThreadStarted = 0;
+
+static void uart_sim_mutexInit(void)
+{
+    pthread_mutexattr_t attr;
+
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&uart_sim_bridgeMutex, &attr);
+    pthread_mutexattr_destroy(&attr);
+}
+
+/**
+ * @brief Locks uart rx, taken by uart_rx like an interrupt mask on target
+ */
+void uart_sim_rxLock(void)
+{
+    pthread_once(&uart_sim_bridgeMutexOnce, uart_sim_mutexInit);
+    pthread_mutex_lock(&uart_sim_bridgeMutex);
+}
+
+void uart_sim_rxUnlock(void)
+{
+    pthread_mutex_unlock(&uart_sim_bridgeMutex);
+}
+
+/**
+ * @brief Pushes received data to the rx fifo of a uart, byte per byte like rx interrupt when an rx handler is
+ * set, called with the mutex held
+ */
+static void uart_sim_rxPush(uint8_t uart, const char *data, size_t size)
+{
+    uart_sim_bridge *bridge = &uart_sim_bridges[uart];
+    size_t id;
+
+    if (!uart_rx_active(&bridge->rxHandler))
+    {
+        fifo_push(&bridge->rxFifo, data, size);
+        return;
+    }
+    for (id = 0; id < size && uart_rx_active(&bridge->rxHandler); id++)
+    {
+        fifo_push(&bridge->rxFifo, data + id, 1);
+        uart_rx_received(&bridge->rxHandler, data[id]);
+    }
+}
+
+/**
+ * @brief Rx thread of udk-sim uarts with an rx handler, plays the role of uart rx interrupt
+ */
+static void *uart_sim_rxThread(void *arg)
+{
+    char buff[UART_SIM_PACKET_SIZE];
+    int size;
+    uint8_t uart;
+
+    UDK_UNUSED(arg);
+
+    while (1)
+    {
+        simulator_socket_wait(UART_SIM_RX_WAIT_MS);
+        simulator_rec_task();
+
+        uart_sim_rxLock();
+        for (uart = 0; uart < UART_COUNT; uart++)
+        {
+            if (uart_sim_bridges[uart].fd >= 0 || !uart_rx_active(&uart_sim_bridges[uart].rxHandler))
+            {
+                continue;
+            }
+            while ((size = simulator_recv(UART_SIM_MODULE, uart, UART_SIM_READ, buff, sizeof(buff))) > 0)
+            {
+                uart_sim_rxPush(uart, buff, size);
+            }
+        }
+        uart_sim_rxUnlock();
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Starts the rx thread at the first rx handler or task, called with the mutex held
+ */
+static void uart_sim_rxThreadStart(void)
+{
+    if (!uart_sim_rxThreadStarted)
+    {
+        if (pthread_create(&uart_sim_rxThreadId, NULL, uart_sim_rxThread, NULL) == 0)
+        {
+            uart_sim_rxThreadStarted = 1;
+        }
+    }
+}
+
 void uart_sendconfig(uint8_t uart)
 {
     simulator_send(UART_SIM_MODULE, uart, UART_SIM_CONFIG, (char *)&uarts[uart], sizeof(uart_dev));
+#ifdef SIM_UNIX
+    uart_sim_bridgeConfig(uart);
+#endif
+}
+
+#ifdef SIM_UNIX
+static speed_t uart_sim_speed(uint32_t baudSpeed)
+{
+    static const struct
+    {
+        uint32_t baudSpeed;
+        speed_t speed;
+    } speeds[] = {
+        {1200, B1200},       {2400, B2400},       {4800, B4800},       {9600, B9600},       {19200, B19200},
+        {38400, B38400},     {57600, B57600},     {115200, B115200},   {230400, B230400},   {460800, B460800},
+        {500000, B500000},   {576000, B576000},   {921600, B921600},   {1000000, B1000000}, {1152000, B1152000},
+        {1500000, B1500000}, {2000000, B2000000}, {2500000, B2500000}, {3000000, B3000000}, {4000000, B4000000},
+    };
+    unsigned i;
+
+    for (i = 0; i < sizeof(speeds) / sizeof(speeds[0]) - 1; i++)
+    {
+        if (baudSpeed <= speeds[i].baudSpeed)
+        {
+            break;
+        }
+    }
+    return speeds[i].speed;
+}
+
+/**
+ * @brief Applies uart settings to a bridged host serial device, nothing to do for a pty
+ */
+static void uart_sim_bridgeConfig(uint8_t uart)
+{
+    struct termios tio;
+    uart_sim_bridge *bridge = &uart_sim_bridges[uart];
+
+    if (bridge->fd < 0 || bridge->slaveFd >= 0 || uarts[uart].baudSpeed == 0)
+    {
+        return;
+    }
+    if (tcgetattr(bridge->fd, &tio) != 0)
+    {
+        return;
+    }
+
+    cfmakeraw(&tio);
+    cfsetspeed(&tio, uart_sim_speed(uarts[uart].baudSpeed));
+    tio.c_cflag |= CLOCAL | CREAD;
+    tio.c_cflag &= ~(CSIZE | PARENB | PARODD | CSTOPB);
+    switch (uarts[uart].bitLength)
+    {
+        case 7:
+            tio.c_cflag |= CS7;
+            break;
+        default:
+            tio.c_cflag |= CS8;
+            break;
+    }
+    if (uarts[uart].bitParity == UART_BIT_PARITY_EVEN)
+    {
+        tio.c_cflag |= PARENB;
+    }
+    else if (uarts[uart].bitParity == UART_BIT_PARITY_ODD)
+    {
+        tio.c_cflag |= PARENB | PARODD;
+    }
+    if (uarts[uart].bitStop == 2)
+    {
+        tio.c_cflag |= CSTOPB;
+    }
+    tcsetattr(bridge->fd, TCSANOW, &tio);
+}
+
+static int uart_sim_bridgeOpen(uint8_t uart, const char *port)
+{
+    struct epoll_event event;
+    struct termios tio;
+    uart_sim_bridge *bridge = &uart_sim_bridges[uart];
+    int fd;
+
+    uart_sim_bridgeClose(uart);
+
+    if (strcmp(port, UART_SIM_BRIDGE_PTY) == 0)
+    {
+        fd = posix_openpt(O_RDWR | O_NOCTTY | O_NONBLOCK);
+        if (fd < 0 || grantpt(fd) != 0 || unlockpt(fd) != 0)
+        {
+            perror("uart_sim: posix_openpt");
+            if (fd >= 0)
+            {
+                close(fd);
+            }
+            return -1;
+        }
+        bridge->slaveFd = open(ptsname(fd), O_RDWR | O_NOCTTY);
+        if (bridge->slaveFd >= 0 && tcgetattr(bridge->slaveFd, &tio) == 0)
+        {
+            cfmakeraw(&tio);
+            tcsetattr(bridge->slaveFd, TCSANOW, &tio);
+        }
+        printf("uart%d: %s\n", uart + 1, ptsname(fd));
+    }
+    else
+    {
+        fd = open(port, O_RDWR | O_NOCTTY | O_NONBLOCK);
+        if (fd < 0)
+        {
+            perror(port);
+            return -1;
+        }
+    }
+
+    uart_sim_rxLock();
+    fifo_init(&bridge->rxFifo, bridge->rxBuff, UART_SIM_BRIDGE_BUFF_SIZE);
+    bridge->fd = fd;
+    bridge->rxArmed = 1;
+    uart_sim_rxUnlock();
+    uart_sim_bridgeConfig(uart);
+
+    if (uart_sim_epollFd < 0)
+    {
+        uart_sim_epollFd = epoll_create1(EPOLL_CLOEXEC);
+        pthread_create(&uart_sim_bridgeThreadId, NULL, uart_sim_bridgeThread, NULL);
+    }
+    event.events = EPOLLIN | EPOLLONESHOT;
+    event.data.u32 = uart;
+    epoll_ctl(uart_sim_epollFd, EPOLL_CTL_ADD, fd, &event);
+
+    return 0;
+}
+
+/**
+ * @brief Watches again the bridge fd after a one shot event, called with the mutex held
+ */
+static void uart_sim_bridgeArm(uint8_t uart)
+{
+    struct epoll_event event;
+    uart_sim_bridge *bridge = &uart_sim_bridges[uart];
+
+    if (bridge->fd < 0 || bridge->rxArmed || fifo_avail(&bridge->rxFifo) == 0)
+    {
+        return;
+    }
+    event.events = EPOLLIN | EPOLLONESHOT;
+    event.data.u32 = uart;
+    if (epoll_ctl(uart_sim_epollFd, EPOLL_CTL_MOD, bridge->fd, &event) == 0)
+    {
+        bridge->rxArmed = 1;
+    }
+}
+
+static void uart_sim_bridgeClose(uint8_t uart)
+{
+    uart_sim_bridge *bridge = &uart_sim_bridges[uart];
+
+    if (bridge->fd < 0)
+    {
+        return;
+    }
+
+    epoll_ctl(uart_sim_epollFd, EPOLL_CTL_DEL, bridge->fd, NULL);
+    uart_sim_rxLock();
+    close(bridge->fd);
+    bridge->fd = -1;
+    if (bridge->slaveFd >= 0)
+    {
+        close(bridge->slaveFd);
+        bridge->slaveFd = -1;
+    }
+    uart_sim_rxUnlock();
+}
+
+/**
+ * @brief Rx thread of bridged uarts, plays the role of uart rx interrupt
+ *
+ * Bridge fds are watched in one shot mode. When the fifo is full, the fd is
+ * not watched anymore and data are left in the host buffer until uart_read
+ * makes room, host flow control slows down the sender instead of losing
+ * bytes. A host side closed or in error, or a full fifo, is watched again
+ * every UART_SIM_BRIDGE_RETRY_MS or at the next uart_read.
+ */
+static void *uart_sim_bridgeThread(void *arg)
+{
+    struct epoll_event events[UART_COUNT];
+    char buff[UART_SIM_BRIDGE_BUFF_SIZE];
+    int count, i, timeout = -1;
+    ssize_t size;
+    uint8_t uart;
+    struct timespec now;
+    uint64_t nowMs, retryMs = 0;
+
+    UDK_UNUSED(arg);
+
+    while (1)
+    {
+        count = epoll_wait(uart_sim_epollFd, events, UART_COUNT, timeout);
+        for (i = 0; i < count; i++)
+        {
+            uart = events[i].data.u32;
+            uart_sim_bridge *bridge = &uart_sim_bridges[uart];
+
+            uart_sim_rxLock();
+            bridge->rxArmed = 0;
+            if (bridge->fd >= 0)
+            {
+                size = fifo_avail(&bridge->rxFifo);
+                if (size > 0)
+                {
+                    size = read(bridge->fd, buff, size);
+                }
+                if (size > 0)
+                {
+                    uart_sim_rxPush(uart, buff, size);
+                }
+                if (size > 0 || (size < 0 && errno == EAGAIN))
+                {
+                    uart_sim_bridgeArm(uart);
+                }
+            }
+            uart_sim_rxUnlock();
+        }
+
+        // fds not watched anymore are tried again later, handler users do not call uart_read
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        nowMs = (uint64_t)now.tv_sec * 1000 + now.tv_nsec / 1000000;
+        uart_sim_rxLock();
+        if (retryMs != 0 && nowMs >= retryMs)
+        {
+            retryMs = 0;
+            for (uart = 0; uart < UART_COUNT; uart++)
+            {
+                uart_sim_bridgeArm(uart);
+            }
+        }
+        for (uart = 0; uart < UART_COUNT && retryMs == 0; uart++)
+        {
+            if (uart_sim_bridges[uart].fd >= 0 && !uart_sim_bridges[uart].rxArmed)
+            {
+                retryMs = nowMs + UART_SIM_BRIDGE_RETRY_MS;
+            }
+        }
+        uart_sim_rxUnlock();
+        timeout = (retryMs != 0) ? UART_SIM_BRIDGE_RETRY_MS : -1;
+    }
+
+    return NULL;
+}
+#endif
+
+/**
+ * @brief Bridges uart to a host serial device or to a new pty instead of udk-sim
+ * @param device uart device number
+ * @param port host device path, UART_SIM_BRIDGE_PTY to create a pty or NULL to get back to udk-sim
+ * @return 0 if ok, -1 in case of error
+ */
+int uart_sim_setPort(rt_dev_t device, const char *port)
+{
+    uint8_t uart = MINOR(device);
+    if (uart >= UART_COUNT)
+    {
+        return -1;
+    }
+
+#ifdef SIM_UNIX
+    if (port == NULL)
+    {
+        uart_sim_bridgeClose(uart);
+        return 0;
+    }
+    return uart_sim_bridgeOpen(uart, port);
+#else
+    UDK_UNUSED(port);
+    return -1;
+#endif
+}
+
+/**
+ * @brief Sets a handler called from rx thread with received data instead of polling uart_read
+ *
+ * Bridged uarts (uart_sim_setPort) are received by the bridge thread, udk-sim
+ * uarts by a thread started with the first handler.
+ *
+ * @param device uart device number
+ * @param mode handler call condition
+ * @param param byte count, delimiter char or idle bit times depending on mode
+ * @param handler handler getting a contiguous span of rx fifo, NULL to get back to uart_read
+ * @return 0 if ok, -1 in case of error
+ */
+int uart_setRxHandler(rt_dev_t device,
+                      UART_RX_HANDLER_MODE mode,
+                      uint16_t param,
+                      void (*handler)(rt_dev_t device, const char *data, size_t size))
+{
+    int ret;
+    uint8_t uart = MINOR(device);
+    if (uart >= UART_COUNT)
+    {
+        return -1;
+    }
+
+    uart_sim_rxLock();
+    if (uart_sim_bridges[uart].rxFifo.size == 0)
+    {
+        fifo_init(&uart_sim_bridges[uart].rxFifo, uart_sim_bridges[uart].rxBuff, UART_SIM_BRIDGE_BUFF_SIZE);
+    }
+    ret = uart_rx_setHandler(&uart_sim_bridges[uart].rxHandler,
+                             device,
+                             &uart_sim_bridges[uart].rxFifo,
+                             uarts[uart].baudSpeed,
+                             mode,
+                             param,
+                             handler);
+    if (ret == 0 && handler != NULL)
+    {
+        uart_sim_rxThreadStart();
+    }
+    uart_sim_rxUnlock();
+
+    return ret;
+}
+
+/**
+ * @brief Signals a scheduler task from rx thread on each received byte, the task reads them with uart_read
+ * @param device uart device number
+ * @param task task to signal, replaces the rx handler, NULL to stop signaling
+ * @param events events given to scheduler_signal
+ * @return 0 if ok, -1 in case of error
+ */
+int uart_setRxTask(rt_dev_t device, struct SchedulerTask *task, uint16_t events)
+{
+    int ret;
+    uint8_t uart = MINOR(device);
+    if (uart >= UART_COUNT)
+    {
+        return -1;
+    }
+
+    uart_sim_rxLock();
+    if (uart_sim_bridges[uart].rxFifo.size == 0)
+    {
+        fifo_init(&uart_sim_bridges[uart].rxFifo, uart_sim_bridges[uart].rxBuff, UART_SIM_BRIDGE_BUFF_SIZE);
+    }
+    ret = uart_rx_setTask(&uart_sim_bridges[uart].rxHandler, device, &uart_sim_bridges[uart].rxFifo, task, events);
+    if (ret == 0 && task != NULL)
+    {
+        uart_sim_rxThreadStart();
+    }
+    uart_sim_rxUnlock();
+
+    return ret;
 }
 
 rt_dev_t uart_getFreeDevice(void)
@@ -83,6 +605,8 @@ rt_dev_t uart_getFreeDevice(void)
 
 int uart_open(rt_dev_t device)
 {
+    char envName[16];
+    const char *port;
     uint8_t uart = MINOR(device);
     if (uart >= UART_COUNT)
     {
@@ -95,6 +619,13 @@ int uart_open(rt_dev_t device)
     uarts[uart].bitParity = UART_BIT_PARITY_NONE;
     uart_sendconfig(uart);
 
+    snprintf(envName, sizeof(envName), "UDK_SIM_UART%d", uart + 1);
+    port = getenv(envName);
+    if (port != NULL && port[0] != '\0' && uart_sim_bridges[uart].fd < 0)
+    {
+        uart_sim_setPort(device, port);
+    }
+
     return 0;
 }
 
@@ -108,6 +639,9 @@ void uart_closeDevice(rt_dev_t device)
 
     uarts[uart].baudSpeed = 0;
     uart_sendconfig(uart);
+#ifdef SIM_UNIX
+    uart_sim_bridgeClose(uart);
+#endif
 }
 
 int uart_enable(rt_dev_t device)
@@ -148,6 +682,9 @@ int uart_setBaudSpeed(rt_dev_t device, uint32_t baudSpeed)
 
     uarts[uart].baudSpeed = baudSpeed;
     uart_sendconfig(uart);
+    uart_sim_rxLock();
+    uart_rx_setBaudSpeed(&uart_sim_bridges[uart].rxHandler, baudSpeed);
+    uart_sim_rxUnlock();
 
     return 0;
 }
@@ -246,9 +783,34 @@ ssize_t uart_write(rt_dev_t device, const char *data, size_t size)
         return -1;
     }
 
+#ifdef SIM_UNIX
+    if (uart_sim_bridges[uart].fd >= 0)
+    {
+        struct pollfd pfd;
+        size_t sizeWritten = 0;
+
+        // like a transmitter without listener, data are lost if the host does not read during 10ms
+        pfd.fd = uart_sim_bridges[uart].fd;
+        pfd.events = POLLOUT;
+        while (sizeWritten < size)
+        {
+            ssize_t sizeChunk = write(pfd.fd, data + sizeWritten, size - sizeWritten);
+            if (sizeChunk > 0)
+            {
+                sizeWritten += sizeChunk;
+            }
+            else if (poll(&pfd, 1, 10) <= 0)
+            {
+                break;
+            }
+        }
+        return sizeWritten;
+    }
+#endif
+
     simulator_send(UART_SIM_MODULE, uart, UART_SIM_WRITE, data, size);
 
-    return 0;
+    return size;
 }
 
 ssize_t uart_read(rt_dev_t device, char *data, size_t size_max)
@@ -260,7 +822,18 @@ ssize_t uart_read(rt_dev_t device, char *data, size_t size_max)
         return -1;
     }
 
-    // TODO
+    // rx fifo is fed by the bridge or rx thread
+    if (uart_sim_bridges[uart].fd >= 0 || uart_rx_active(&uart_sim_bridges[uart].rxHandler))
+    {
+        uart_sim_rxLock();
+        size_read = fifo_pop(&uart_sim_bridges[uart].rxFifo, data, size_max);
+#ifdef SIM_UNIX
+        uart_sim_bridgeArm(uart);
+#endif
+        uart_sim_rxUnlock();
+        return size_read;
+    }
+
     simulator_rec_task();
     size_read = simulator_recv(UART_SIM_MODULE, uart, UART_SIM_READ, data, size_max);
     if (size_read < 0)
@@ -270,3 +843,24 @@ ssize_t uart_read(rt_dev_t device, char *data, size_t size_max)
 
     return size_read;
 }
+
+/**
+ * @brief Gets number of data that could be read, only known for bridged uarts or with an rx handler or task
+ * @param device uart device number
+ * @return number of data ready to read
+ */
+ssize_t uart_datardy(rt_dev_t device)
+{
+    ssize_t size;
+    uint8_t uart = MINOR(device);
+    if (uart >= UART_COUNT)
+    {
+        return -1;
+    }
+
+    uart_sim_rxLock();
+    size = fifo_len(&uart_sim_bridges[uart].rxFifo);
+    uart_sim_rxUnlock();
+
+    return size;
+}
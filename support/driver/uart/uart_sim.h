@@ -12,6 +12,8 @@
 #ifndef UART_SIM_H
 #define UART_SIM_H
 
+#include <driver/device.h>
+
 #include <stdint.h>
 
 typedef struct
@@ -29,4 +31,15 @@ typedef struct
 #define UART_SIM_WRITE  0x0002
 #define UART_SIM_READ   0x0003
 
+// port name creating a pty instead of opening a host serial device
+#define UART_SIM_BRIDGE_PTY "pty"
+
+#ifndef SIMULATOR
+#    define uart_sim_setPort(device, port) 0
+#else
+int uart_sim_setPort(rt_dev_t device, const char *port);
+void uart_sim_rxLock(void);
+void uart_sim_rxUnlock(void);
+#endif
+
 #endif  // UART_SIM_H
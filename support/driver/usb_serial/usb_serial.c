@@ -22,12 +22,18 @@
 STATIC_FIFO(usb_serial_buffrx, UARTSERIAL_BUFFRX_SIZE);
 uint8_t usb_serial_buffer[64];
 
+// writes are queued in tx fifo, usb_serial_task gives it to CDC one packet at a time
+#define UARTSERIAL_BUFFTX_SIZE 512
+STATIC_FIFO(usb_serial_bufftx, UARTSERIAL_BUFFTX_SIZE);
+uint8_t usb_serial_txPacket[CDC_DATA_IN_EP_SIZE];  // used by CDC until USBUSARTIsTxTrfReady
+
 void usb_serial_init(void)
 {
     SYSTEM_Initialize(SYSTEM_STATE_USB_START);
     USBDeviceInit();
     USBDeviceAttach();
     STATIC_FIFO_INIT(usb_serial_buffrx, UARTSERIAL_BUFFRX_SIZE);
+    STATIC_FIFO_INIT(usb_serial_bufftx, UARTSERIAL_BUFFTX_SIZE);
 }
 
 rt_dev_t usb_serial_getFreeDevice(void)
@@ -40,6 +46,7 @@ rt_dev_t usb_serial_getFreeDevice(void)
 void usb_serial_task(void)
 {
     uint16_t size_rec;
+    size_t size_send;
 
     if (USBGetDeviceState() < CONFIGURED_STATE)
     {
@@ -50,7 +57,15 @@ void usb_serial_task(void)
         return;
     }
 
-    // send service
+    // send service, next packet of tx fifo once the previous one is sent
+    if (USBUSARTIsTxTrfReady() == true)
+    {
+        size_send = fifo_pop(&usb_serial_bufftx, (char *)usb_serial_txPacket, sizeof(usb_serial_txPacket));
+        if (size_send > 0)
+        {
+            putUSBUSART(usb_serial_txPacket, size_send);
+        }
+    }
     CDCTxService();
 
     // receive service
@@ -61,10 +76,14 @@ void usb_serial_task(void)
     }
 }
 
+/**
+ * @brief Queues data to send to host without blocking
+ * @return number of bytes queued, lower than size when the tx fifo is full, 0 if not connected
+ */
 ssize_t usb_serial_write(rt_dev_t device, const char *data, size_t size)
 {
-    uint8_t *ptrData;
-    size_t sizeToWrite;
+    size_t sizeWritten;
+
     if (USBGetDeviceState() < CONFIGURED_STATE)
     {
         return 0;
@@ -74,24 +93,19 @@ ssize_t usb_serial_write(rt_dev_t device, const char *data, size_t size)
         return 0;
     }
 
-    sizeToWrite = size;
-    ptrData = (uint8_t *)data;
-    while (sizeToWrite > 0)
-    {
-        if (USBUSARTIsTxTrfReady() == true)
-        {
-            size_t size_packet = sizeToWrite;
-            if (size_packet > 255)
-            {
-                size_packet = 255;
-            }
-            putUSBUSART(ptrData, size);
-            sizeToWrite -= size_packet;
-            ptrData += size_packet;
-        }
-        usb_serial_task();
-    }
-    return size;
+    sizeWritten = fifo_push(&usb_serial_bufftx, data, size);
+    usb_serial_task();
+    return sizeWritten;
+}
+
+/**
+ * @brief Checks that all queued data were sent to host
+ * @return 1 if the tx fifo is empty and the CDC transmit is ready, 0 otherwise
+ */
+int usb_serial_transmitFinished(rt_dev_t device)
+{
+    usb_serial_task();
+    return (fifo_len(&usb_serial_bufftx) == 0 && USBUSARTIsTxTrfReady() == true) ? 1 : 0;
 }
 
 ssize_t usb_serial_read(rt_dev_t device, char *data, size_t max_size)
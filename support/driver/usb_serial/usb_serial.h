@@ -20,5 +20,6 @@ void usb_serial_task(void);
 
 ssize_t usb_serial_write(rt_dev_t device, const char *data, size_t size);
 ssize_t usb_serial_read(rt_dev_t device, char *data, size_t max_size);
+int usb_serial_transmitFinished(rt_dev_t device);
 
 #endif  // USB_SERIAL_H
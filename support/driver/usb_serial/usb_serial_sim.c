@@ -6,30 +6,253 @@
  *
  * @date November 28, 2016, 20:35 PM
  *
- * @brief USB serial support
+ * @brief USB serial support for simulation purpose, backed by a host pty
+ *
+ * The device appears as /dev/pts/N (printed at init, and symlinked to
+ * $UDK_SIM_USB_SERIAL if set). Data is moved by usb_serial_task in 64 bytes
+ * packets, at most USB_SERIAL_SIM_PACKETS_PER_MS packets per millisecond as
+ * full speed CDC bulk endpoints, IN and OUT packets share this bus budget.
  */
 
+#define _GNU_SOURCE
+
 #include "usb_serial_sim.h"
 #include "simulator.h"
 
+#include "sys/fifo.h"
+
+#if !defined(WIN32)
+#    include <fcntl.h>
+#    include <stdio.h>
+#    include <stdlib.h>
+#    include <termios.h>
+#    include <time.h>
+#    include <unistd.h>
+#endif
+
+#define USB_SERIAL_SIM_PACKET_SIZE    64
+#define USB_SERIAL_SIM_PACKETS_PER_MS 19  // full speed bulk, 1216 kB/s
+#define USB_SERIAL_SIM_BUFF_SIZE      32768
+
+STATIC_FIFO(usb_serial_sim_buffrx, USB_SERIAL_SIM_BUFF_SIZE);
+STATIC_FIFO(usb_serial_sim_bufftx, USB_SERIAL_SIM_BUFF_SIZE);
+
+static int usb_serial_sim_master = -1;
+static int usb_serial_sim_slave = -1;  // kept open to keep raw mode and avoid EIO when no host is connected
+static char usb_serial_sim_txPacket[USB_SERIAL_SIM_PACKET_SIZE];
+static size_t usb_serial_sim_txPacketLen = 0;
+static size_t usb_serial_sim_txPacketPos = 0;
+static uint64_t usb_serial_sim_lastUs = 0;
+static uint32_t usb_serial_sim_credit = 0;  // packets budget in 1/1000 packet, keeps the remainder between tasks
+
+#if !defined(WIN32)
+static uint64_t usb_serial_sim_timeUs(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000 + now.tv_nsec / 1000;
+}
+
+static int usb_serial_sim_open(void)
+{
+    struct termios tio;
+    const char *name;
+    const char *link;
+
+    usb_serial_sim_master = posix_openpt(O_RDWR | O_NOCTTY | O_NONBLOCK);
+    if (usb_serial_sim_master < 0)
+    {
+        perror("usb_serial_sim: posix_openpt");
+        return -1;
+    }
+    if (grantpt(usb_serial_sim_master) != 0 || unlockpt(usb_serial_sim_master) != 0)
+    {
+        perror("usb_serial_sim: grantpt");
+        close(usb_serial_sim_master);
+        usb_serial_sim_master = -1;
+        return -1;
+    }
+
+    name = ptsname(usb_serial_sim_master);
+    usb_serial_sim_slave = open(name, O_RDWR | O_NOCTTY);
+    if (usb_serial_sim_slave >= 0 && tcgetattr(usb_serial_sim_slave, &tio) == 0)
+    {
+        cfmakeraw(&tio);
+        tcsetattr(usb_serial_sim_slave, TCSANOW, &tio);
+    }
+
+    printf("usb_serial: %s\n", name);
+    link = getenv("UDK_SIM_USB_SERIAL");
+    if (link != NULL)
+    {
+        unlink(link);
+        if (symlink(name, link) != 0)
+        {
+            perror("usb_serial_sim: symlink");
+        }
+    }
+
+    usb_serial_sim_lastUs = usb_serial_sim_timeUs();
+    return 0;
+}
+#endif
+
 rt_dev_t usb_serial_getFreeDevice(void)
 {
-    // TODO SIM
+    if (usb_serial_sim_master < 0)
+    {
+        STATIC_FIFO_INIT(usb_serial_sim_buffrx, USB_SERIAL_SIM_BUFF_SIZE);
+        STATIC_FIFO_INIT(usb_serial_sim_bufftx, USB_SERIAL_SIM_BUFF_SIZE);
+#if !defined(WIN32)
+        usb_serial_sim_open();
+#endif
+    }
 
     return MKDEV(DEV_CLASS_USB_SERIAL, 0);
 }
 
+#if !defined(WIN32)
+/**
+ * @brief Sends one packet to host on the IN endpoint
+ * @return 1 if a packet was completed, 0 if nothing to send or if the host does not read
+ */
+static int usb_serial_sim_inPacket(void)
+{
+    ssize_t size;
+
+    if (usb_serial_sim_txPacketPos == usb_serial_sim_txPacketLen)
+    {
+        usb_serial_sim_txPacketLen = fifo_pop(&usb_serial_sim_bufftx, usb_serial_sim_txPacket, USB_SERIAL_SIM_PACKET_SIZE);
+        usb_serial_sim_txPacketPos = 0;
+        if (usb_serial_sim_txPacketLen == 0)
+        {
+            return 0;
+        }
+    }
+    size = write(usb_serial_sim_master,
+                 usb_serial_sim_txPacket + usb_serial_sim_txPacketPos,
+                 usb_serial_sim_txPacketLen - usb_serial_sim_txPacketPos);
+    if (size <= 0)
+    {
+        return 0;  // pty full, host does not read
+    }
+    usb_serial_sim_txPacketPos += size;
+    return (usb_serial_sim_txPacketPos == usb_serial_sim_txPacketLen) ? 1 : 0;
+}
+
+/**
+ * @brief Receives one packet from host on the OUT endpoint, only if it fits in rx buffer
+ * @return 1 if a packet was received, 0 otherwise
+ */
+static int usb_serial_sim_outPacket(void)
+{
+    char packet[USB_SERIAL_SIM_PACKET_SIZE];
+    ssize_t size;
+
+    if (fifo_avail(&usb_serial_sim_buffrx) < USB_SERIAL_SIM_PACKET_SIZE)
+    {
+        return 0;
+    }
+    size = read(usb_serial_sim_master, packet, USB_SERIAL_SIM_PACKET_SIZE);
+    if (size <= 0)
+    {
+        return 0;
+    }
+    fifo_push(&usb_serial_sim_buffrx, packet, size);
+    return 1;
+}
+#endif
+
 void usb_serial_task(void)
 {
-    // TODO SIM
+#if !defined(WIN32)
+    uint64_t nowUs, elapsedUs;
+    int sent, received;
+
+    if (usb_serial_sim_master < 0)
+    {
+        return;
+    }
+
+    // packets budget since last task, limited to one frame of backlog
+    nowUs = usb_serial_sim_timeUs();
+    elapsedUs = nowUs - usb_serial_sim_lastUs;
+    if (elapsedUs > 1000)
+    {
+        elapsedUs = 1000;
+    }
+    usb_serial_sim_lastUs = nowUs;
+    usb_serial_sim_credit += (uint32_t)elapsedUs * USB_SERIAL_SIM_PACKETS_PER_MS;
+    if (usb_serial_sim_credit > USB_SERIAL_SIM_PACKETS_PER_MS * 1000)
+    {
+        usb_serial_sim_credit = USB_SERIAL_SIM_PACKETS_PER_MS * 1000;
+    }
+
+    // IN and OUT endpoints served in turn
+    while (usb_serial_sim_credit >= 1000)
+    {
+        sent = usb_serial_sim_inPacket();
+        if (sent)
+        {
+            usb_serial_sim_credit -= 1000;
+        }
+        received = 0;
+        if (usb_serial_sim_credit >= 1000)
+        {
+            received = usb_serial_sim_outPacket();
+            if (received)
+            {
+                usb_serial_sim_credit -= 1000;
+            }
+        }
+        if (!sent && !received)
+        {
+            break;
+        }
+    }
+#endif
 }
 
+/**
+ * @brief Queues data to send to host, never blocks
+ * @return number of bytes queued, less than size if the host does not read fast enough
+ */
 ssize_t usb_serial_write(rt_dev_t device, const char *data, size_t size)
 {
-    return 0;
+    size_t sizeWritten;
+    UDK_UNUSED(device);
+
+    if (usb_serial_sim_master < 0)
+    {
+        return 0;
+    }
+
+    sizeWritten = fifo_push(&usb_serial_sim_bufftx, data, size);
+    usb_serial_task();
+    return sizeWritten;
+}
+
+/**
+ * @brief Checks that all queued data were sent to host
+ * @return 1 if the transmit fifo and the current packet are empty, 0 otherwise
+ */
+int usb_serial_transmitFinished(rt_dev_t device)
+{
+    UDK_UNUSED(device);
+
+    usb_serial_task();
+    return (fifo_len(&usb_serial_sim_bufftx) == 0 && usb_serial_sim_txPacketPos == usb_serial_sim_txPacketLen) ? 1 : 0;
 }
 
 ssize_t usb_serial_read(rt_dev_t device, char *data, size_t max_size)
 {
-    return 0;
+    UDK_UNUSED(device);
+
+    if (usb_serial_sim_master < 0)
+    {
+        return 0;
+    }
+
+    usb_serial_task();
+    return fifo_pop(&usb_serial_sim_buffrx, data, max_size);
 }
@@ -45,6 +45,9 @@ Cmd cmds[] = {
 #endif
 #ifdef USE_MODULE_mrobot
     {"mrobot", cmd_mrobot},
+#endif
+#ifdef USE_MODULE_prof
+    {"prof", cmd_prof},
 #endif
     {"reg", cmd_reg},
     {"led", cmd_led},
@@ -0,0 +1,92 @@
+
+#include "module/prof.h"
+
+#include "cmd_stdio.h"
+
+void cmd_prof_status(void)
+{
+    uint8_t id;
+    ProfRegion region;
+    unsigned long avg;
+
+    printf("counter: %lu Hz\r\n", (unsigned long)prof_freq());
+    for (id = 0; id < PROF_REGION_COUNT; id++)
+    {
+        prof_region(id, &region);
+        if (region.count == 0)
+        {
+            continue;
+        }
+        avg = prof_ticksToNs(region.sum / region.count);
+        printf("%d %s: %lu calls, min %lu avg %lu max %lu ns\r\n",
+               id,
+               region.name != NULL ? region.name : "-",
+               (unsigned long)region.count,
+               (unsigned long)prof_ticksToNs(region.min),
+               avg,
+               (unsigned long)prof_ticksToNs(region.max));
+    }
+}
+
+int cmd_prof_hist(uint8_t id)
+{
+    uint8_t bin;
+    ProfRegion region;
+
+    if (prof_region(id, &region) < 0)
+    {
+        return 1;
+    }
+    for (bin = 0; bin < PROF_HIST_BINS - 1; bin++)
+    {
+        printf("< %lu ns: %lu\r\n",
+               (unsigned long)prof_ticksToNs((uint32_t)1 << (PROF_HIST_SHIFT + bin)),
+               (unsigned long)region.hist[bin]);
+    }
+    printf(">= %lu ns: %lu\r\n",
+           (unsigned long)prof_ticksToNs((uint32_t)1 << (PROF_HIST_SHIFT + bin - 1)),
+           (unsigned long)region.hist[bin]);
+    return 0;
+}
+
+int cmd_prof(int argc, char **argv)
+{
+    // no args -> show status
+    if (argc == 1)
+    {
+        cmd_prof_status();
+        return 0;
+    }
+    if (strcmp(argv[1], "status") == 0)
+    {
+        cmd_prof_status();
+        return 0;
+    }
+
+    // > prof hist <region-id>
+    if (strcmp(argv[1], "hist") == 0)
+    {
+        if (argc < 3)
+        {
+            return 1;
+        }
+        return cmd_prof_hist(atoi(argv[2]));
+    }
+
+    if (strcmp(argv[1], "reset") == 0)
+    {
+        prof_reset();
+        return 0;
+    }
+
+    // help
+    if (strcmp(argv[1], "help") == 0)
+    {
+        puts("prof status");
+        puts("prof hist <region-id>");
+        puts("prof reset");
+        return 0;
+    }
+
+    return 1;
+}
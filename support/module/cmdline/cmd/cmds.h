@@ -22,5 +22,6 @@ int cmd_ax(int argc, char **argv);
 int cmd_led(int argc, char **argv);
 int cmd_sysclock(int argc, char **argv);
 int cmd_reg(int argc, char **argv);
+int cmd_prof(int argc, char **argv);
 
 #endif  // CMDS_H
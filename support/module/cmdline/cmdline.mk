@@ -30,5 +30,8 @@ endif
 ifneq (,$(findstring mrobot,$(MODULES)))
   SRC := $(SRC) cmd_mrobot.c
 endif
+ifneq (,$(findstring prof,$(MODULES)))
+  SRC := $(SRC) cmd_prof.c
+endif
 
 endif
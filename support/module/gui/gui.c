@@ -23,15 +23,63 @@ void gui_init(rt_dev_t dev)
 
 void gui_fillScreen(Color color)
 {
-    uint16_t i, j;
     gui_ctrl_setRectScreen(0, 0, GUI_WIDTH, GUI_HEIGHT);
+    gui_ctrl_write_dataRepeat(color, (uint32_t)GUI_WIDTH * GUI_HEIGHT);
+}
 
-    for (i = 0; i < GUI_WIDTH; i++)
+/**
+ * @brief Writes count palette indexes packed on bpp bits, starting on a byte boundary
+ * @return pointer to the byte following the last index
+ */
+static __prog__ const uint8_t *gui_dispPackedIndexes(__prog__ const uint16_t *palette,
+                                                   __prog__ const uint8_t *indexes,
+                                                   uint8_t bpp,
+                                                   uint32_t count)
+{
+    uint8_t mask = (uint8_t)((1 << bpp) - 1);
+    uint8_t bitsLeft = 0;
+    uint8_t byte = 0;
+
+    while (count > 0)
     {
-        for (j = 0; j < GUI_HEIGHT; j++)
+        if (bitsLeft == 0)
+        {
+            byte = *indexes++;
+            bitsLeft = 8;
+        }
+        bitsLeft -= bpp;
+        gui_ctrl_write_data(palette[(byte >> bitsLeft) & mask]);
+        count--;
+    }
+    return indexes;
+}
+
+/**
+ * @brief Decodes a run length encoded picture, repeated spans are sent as bulk writes
+ */
+static void gui_dispRleIndexes(const Picture *pic)
+{
+    __prog__ const uint8_t *indexes = pic->indexes;
+    uint32_t remaining = (uint32_t)pic->width * pic->height;
+
+    while (remaining > 0)
+    {
+        uint8_t header = *indexes++;
+        uint8_t span = (header & ~PICTURE_RLE_REPEAT) + 1;
+        if (span > remaining)
+        {
+            break;  // corrupted stream
+        }
+
+        if (header & PICTURE_RLE_REPEAT)
         {
-            gui_ctrl_write_data(color);
+            gui_ctrl_write_dataRepeat(pic->data[*indexes++], span);
         }
+        else
+        {
+            indexes = gui_dispPackedIndexes(pic->data, indexes, pic->bpp, span);
+        }
+        remaining -= span;
     }
 }
 
@@ -41,21 +89,30 @@ void gui_fillScreen(Color color)
  */
 void gui_dispImage(uint16_t x, uint16_t y, const Picture *pic)
 {
-    uint16_t i, j;
-    unsigned long addr = 0;
+    uint32_t addr, size;
 
     // TODO: create warning if the image is too big
 
     // set rect image area space address
     gui_ctrl_setRectScreen(x, y, pic->width, pic->height);
 
-    for (i = 0; i < pic->width; i++)
+    size = (uint32_t)pic->width * pic->height;
+    switch (pic->format)
     {
-        for (j = 0; j < pic->height; j++)
-        {
-            gui_ctrl_write_data(pic->data[addr]);
-            ++addr;
-        }
+        case PICTURE_FORMAT_PALETTE:
+            gui_dispPackedIndexes(pic->data, pic->indexes, pic->bpp, size);
+            break;
+
+        case PICTURE_FORMAT_RLE:
+            gui_dispRleIndexes(pic);
+            break;
+
+        default:
+            for (addr = 0; addr < size; addr++)
+            {
+                gui_ctrl_write_data(pic->data[addr]);
+            }
+            break;
     }
 
     // restore full draw screen
@@ -173,19 +230,11 @@ void gui_drawRect(uint16_t x, uint16_t y, uint16_t w, uint16_t h)
 
 void gui_drawFillRect(uint16_t x, uint16_t y, uint16_t w, uint16_t h)
 {
-    uint16_t i, j;
-
     // set rect image area space address
     gui_ctrl_setRectScreen(x, y, w, h);
 
     // fill this rect with brush color
-    for (i = 0; i < h; i++)
-    {
-        for (j = 0; j < w; j++)
-        {
-            gui_ctrl_write_data(_gui_brushColor);
-        }
-    }
+    gui_ctrl_write_dataRepeat(_gui_brushColor, (uint32_t)w * h);
 
     // restore full draw screen
     gui_ctrl_setRectScreen(0, 0, GUI_WIDTH, GUI_HEIGHT);
@@ -200,6 +249,160 @@ void gui_drawText(uint16_t x, uint16_t y, const char *txt)
         x, y, gui_getFontTextWidth(txt), gui_getFontHeight(), txt, GUI_FONT_ALIGN_VLEFT | GUI_FONT_ALIGN_HTOP);
 }
 
+// pending run of same color pixels, sent as one bulk write
+static Color _gui_runColor;
+static uint32_t _gui_runCount = 0;
+
+static void gui_runFlush(void)
+{
+    if (_gui_runCount != 0)
+    {
+        gui_ctrl_write_dataRepeat(_gui_runColor, _gui_runCount);
+        _gui_runCount = 0;
+    }
+}
+
+static void gui_runPush(Color color, uint32_t count)
+{
+    if (color != _gui_runColor)
+    {
+        gui_runFlush();
+        _gui_runColor = color;
+    }
+    _gui_runCount += count;
+}
+
+/**
+ * @brief Mixes two RGB565 colors, level / max of color to
+ */
+static Color gui_blendColor(Color from, Color to, uint8_t level, uint8_t max)
+{
+    uint16_t r, g, b;
+    uint8_t inv = max - level;
+
+    r = ((from >> 11) * inv + (to >> 11) * level + (max >> 1)) / max;
+    g = (((from >> 5) & 0x3F) * inv + ((to >> 5) & 0x3F) * level + (max >> 1)) / max;
+    b = ((from & 0x1F) * inv + (to & 0x1F) * level + (max >> 1)) / max;
+    return (r << 11) | (g << 5) | b;
+}
+
+/**
+ * @brief Glyph index of a character in the current packed font
+ * @return glyph index, -1 if the character is not in the font
+ */
+static int16_t gui_fontGlyph(uint8_t c)
+{
+    uint8_t i;
+    const FontRange *range = _gui_font->ranges;
+
+    for (i = 0; i < _gui_font->rangeCount; i++, range++)
+    {
+        if (c >= range->first && c <= range->last)
+        {
+            return range->glyph + (c - range->first);
+        }
+    }
+    return -1;
+}
+
+static int8_t gui_fontKerning(uint8_t left, uint8_t right)
+{
+    uint16_t key = ((uint16_t)left << 8) | right;
+    int16_t min = 0, max = (int16_t)_gui_font->kerningCount - 1;
+
+    while (min <= max)
+    {
+        int16_t mid = (min + max) >> 1;
+        const FontKerning *kerning = &_gui_font->kernings[mid];
+        uint16_t midKey = ((uint16_t)kerning->left << 8) | kerning->right;
+        if (midKey == key)
+        {
+            return kerning->offset;
+        }
+        if (midKey < key)
+        {
+            min = mid + 1;
+        }
+        else
+        {
+            max = mid - 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Advance in pixels of the first character of txt with packed font, kerning with next one included
+ */
+static uint8_t gui_fontAdvance(const char *txt, int16_t glyph)
+{
+    int16_t advance = _gui_font->widths[glyph];
+    if (txt[1] != '\0' && _gui_font->kerningCount != 0)
+    {
+        advance += gui_fontKerning((uint8_t)txt[0], (uint8_t)txt[1]);
+    }
+    return (advance > 0) ? advance : 0;
+}
+
+/**
+ * @brief Writes text columns with the current packed font, pixels are mixed
+ * between brush and pen colors depending on their coverage
+ */
+static void gui_drawPackedText(const char *txt, uint16_t text_width, uint16_t ystartmargin, uint16_t yendmargin)
+{
+    Color colors[16];
+    uint8_t bpp = _gui_font->bpp;
+    uint8_t mask = (1 << bpp) - 1;
+    uint8_t level, byte, bitsLeft, advance, column, width;
+    uint16_t i, wcurrent = 0;
+    int16_t glyph;
+    const uint8_t *data;
+    const char *c;
+
+    for (level = 0; level <= mask; level++)
+    {
+        colors[level] = gui_blendColor(_gui_brushColor, _gui_penColor, level, mask);
+    }
+
+    for (c = txt; *c != '\0' && wcurrent < text_width; c++)
+    {
+        glyph = gui_fontGlyph((uint8_t)*c);
+        if (glyph < 0)
+        {
+            continue;
+        }
+
+        width = _gui_font->widths[glyph];
+        advance = gui_fontAdvance(c, glyph);
+        data = _gui_font->glyphs + _gui_font->offsets[glyph];
+        bitsLeft = 0;
+        byte = 0;
+        for (column = 0; column < advance && wcurrent < text_width; column++, wcurrent++)
+        {
+            gui_runPush(_gui_brushColor, ystartmargin);
+            if (column < width)
+            {
+                for (i = 0; i < _gui_font->height; i++)
+                {
+                    if (bitsLeft == 0)
+                    {
+                        byte = *data++;
+                        bitsLeft = 8;
+                    }
+                    bitsLeft -= bpp;
+                    gui_runPush(colors[(byte >> bitsLeft) & mask], 1);
+                }
+            }
+            else
+            {
+                // positive kerning
+                gui_runPush(_gui_brushColor, _gui_font->height);
+            }
+            gui_runPush(_gui_brushColor, yendmargin);
+        }
+    }
+}
+
 void gui_drawTextRect(uint16_t x, uint16_t y, uint16_t w, uint16_t h, const char *txt, uint8_t flags)
 {
     int16_t octet;
@@ -276,72 +479,63 @@ void gui_drawTextRect(uint16_t x, uint16_t y, uint16_t w, uint16_t h, const char
     gui_ctrl_setRectScreen(x, y, w, h);
 
     // xstartmargin
-    for (j = 0; j < xstartmargin; j++)
+    _gui_runColor = _gui_brushColor;
+    gui_runPush(_gui_brushColor, (uint32_t)xstartmargin * h);
+
+    if (_gui_font->letters == NULL)
     {
-        for (i = 0; i < h; i++)
-        {
-            gui_ctrl_write_data(_gui_brushColor);
-        }
+        gui_drawPackedText(txt, text_width, ystartmargin, yendmargin);
     }
-
-    // writting pixels chars
-    c = txt;
-    wcurrent = 0;
-    while ((*c != '\0') && (out_of_rect != 1))
+    else
     {
-        if (*c >= _gui_font->first && *c <= _gui_font->last)
+        // writting pixels chars
+        c = txt;
+        wcurrent = 0;
+        while ((*c != '\0') && (out_of_rect != 1))
         {
-            octet = -1;
-            letter = _gui_font->letters[*c - _gui_font->first];
-            for (j = 0; j < letter->width; j++)
+            if ((uint8_t)*c >= _gui_font->first && (uint8_t)*c <= _gui_font->last)
             {
-                // verifying if wcurrent is out of rect
-                if (wcurrent >= text_width)
+                octet = -1;
+                letter = _gui_font->letters[(uint8_t)*c - _gui_font->first];
+                for (j = 0; j < letter->width; j++)
                 {
-                    out_of_rect = 1;
-                    break;
-                }
-
-                for (i = 0; i < ystartmargin; i++)
-                {
-                    gui_ctrl_write_data(_gui_brushColor);
-                }
-                for (i = 0; i < _gui_font->height; i++)
-                {
-                    if ((i & 0x0007) == 0)
-                    {
-                        bit = 1;
-                        octet++;
-                    }
-                    if ((letter->data[octet]) & bit)
+                    // verifying if wcurrent is out of rect
+                    if (wcurrent >= text_width)
                     {
-                        gui_ctrl_write_data(_gui_penColor);
+                        out_of_rect = 1;
+                        break;
                     }
-                    else
+
+                    gui_runPush(_gui_brushColor, ystartmargin);
+                    for (i = 0; i < _gui_font->height; i++)
                     {
-                        gui_ctrl_write_data(_gui_brushColor);
+                        if ((i & 0x0007) == 0)
+                        {
+                            bit = 1;
+                            octet++;
+                        }
+                        if ((letter->data[octet]) & bit)
+                        {
+                            gui_runPush(_gui_penColor, 1);
+                        }
+                        else
+                        {
+                            gui_runPush(_gui_brushColor, 1);
+                        }
+                        bit = bit << 1;
                     }
-                    bit = bit << 1;
-                }
-                for (i = 0; i < yendmargin; i++)
-                {
-                    gui_ctrl_write_data(_gui_brushColor);
-                }
+                    gui_runPush(_gui_brushColor, yendmargin);
 
-                wcurrent++;
+                    wcurrent++;
+                }
             }
+            c++;
         }
-        c++;
     }
 
     // xendmargin
-    for (j = 0; j < xendmargin; j++)
-    {
-        for (i = 0; i < h; i++)
-        {
-            gui_ctrl_write_data(_gui_brushColor);
-        }
-    }
+    gui_runPush(_gui_brushColor, (uint32_t)xendmargin * h);
+    gui_runFlush();
 
     // restore full draw screen
     gui_ctrl_setRectScreen(0, 0, GUI_WIDTH, GUI_HEIGHT);
@@ -368,20 +562,28 @@ uint8_t gui_getFontHeight(void)
 
 uint8_t gui_getFontWidth(const char c)
 {
+    int16_t glyph;
+
     if (_gui_font == NULL)
     {
         return 0;
     }
-    if (c < _gui_font->first || c > _gui_font->last)
+    if (_gui_font->letters == NULL)
+    {
+        glyph = gui_fontGlyph((uint8_t)c);
+        return (glyph < 0) ? 0 : _gui_font->widths[glyph];
+    }
+    if ((uint8_t)c < _gui_font->first || (uint8_t)c > _gui_font->last)
     {
         return 0;
     }
-    return _gui_font->letters[c - _gui_font->first]->width;
+    return _gui_font->letters[(uint8_t)c - _gui_font->first]->width;
 }
 
 uint16_t gui_getFontTextWidth(const char *txt)
 {
     uint16_t width = 0;
+    int16_t glyph;
     const char *c = txt;
     if (_gui_font == NULL)
     {
@@ -389,9 +591,17 @@ uint16_t gui_getFontTextWidth(const char *txt)
     }
     while (*c != '\0')
     {
-        if (*c >= _gui_font->first && *c <= _gui_font->last)
+        if (_gui_font->letters == NULL)
+        {
+            glyph = gui_fontGlyph((uint8_t)*c);
+            if (glyph >= 0)
+            {
+                width += gui_fontAdvance(c, glyph);
+            }
+        }
+        else if ((uint8_t)*c >= _gui_font->first && (uint8_t)*c <= _gui_font->last)
         {
-            width += _gui_font->letters[*c - _gui_font->first]->width;
+            width += _gui_font->letters[(uint8_t)*c - _gui_font->first]->width;
         }
         c++;
     }
@@ -83,6 +83,8 @@ $(OUT_PWD)/pictures.h: $(firstword $(MAKEFILE_LIST))
 CONFIG_HEADERS += $(OUT_PWD)/pictures.h
 
 ################ FONT SUPPORT ################
+# FONT_FLAGS: img2raw font options, ex: -b 4 -r latin1 for anti-aliased Latin-1 fonts
+FONT_FLAGS ?=
 FONTS_C := $(addprefix $(OUT_PWD)/, $(addsuffix .font.c, $(FONTS)))
 SRC += $(FONTS_C)
 
@@ -101,7 +103,7 @@ $(OUT_PWD)/%.font.o : $(OUT_PWD)/%.font.c
 $(OUT_PWD)/%.font.c : $(IMG2RAW_EXE)
 	@test -d $(OUT_PWD) || mkdir -p $(OUT_PWD)
 	@printf "$(GREEN)IMG %-35s => %s$(NORM)\n" $(notdir $*) $(OUT_PWD)/$(notdir $@)
-	$(VERB)$(IMG2RAW_EXE) -i $* -o  $(OUT_PWD)/$(notdir $@)
+	$(VERB)$(IMG2RAW_EXE) -i $* -o  $(OUT_PWD)/$(notdir $@) $(FONT_FLAGS)
 	
 .SECONDARY: $(PICTURES_C) $(FONTS_C)
 
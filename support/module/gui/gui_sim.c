@@ -57,6 +57,29 @@ void gui_ctrl_write_data(uint16_t data)
     }
 }
 
+void gui_ctrl_write_dataRepeat(uint16_t data, uint32_t count)
+{
+    while (count > 0)
+    {
+        uint32_t span = BUFFPIXSIZE - idPix;
+        if (span > count)
+        {
+            span = count;
+        }
+        count -= span;
+        while (span > 0)
+        {
+            buffPix[idPix++] = data;
+            span--;
+        }
+
+        if (idPix == BUFFPIXSIZE)
+        {
+            gui_ctrl_flush_data();
+        }
+    }
+}
+
 void gui_ctrl_drawPoint(uint16_t x, uint16_t y, uint16_t color)
 {
     gui_ctrl_setPos(x, y);
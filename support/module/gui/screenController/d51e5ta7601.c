@@ -72,6 +72,23 @@ void gui_ctrl_write_data(uint16_t data)
     SCREEN_CS = 1;
 }
 
+/**
+ * @brief Writes the same data count times, port and chip select are set once
+ */
+void gui_ctrl_write_dataRepeat(uint16_t data, uint32_t count)
+{
+    SCREEN_PORT_OUTPUT;
+    SCREEN_CS = 0;
+    SCREEN_PORT_OUT = data;
+    while (count > 0)
+    {
+        SCREEN_RW = 0;
+        SCREEN_RW = 1;
+        count--;
+    }
+    SCREEN_CS = 1;
+}
+
 uint16_t gui_ctrl_read_data(void)
 {
     uint16_t data;
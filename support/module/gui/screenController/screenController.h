@@ -25,6 +25,7 @@
 
 void gui_ctrl_init(rt_dev_t dev);
 void gui_ctrl_write_data(uint16_t data);
+void gui_ctrl_write_dataRepeat(uint16_t data, uint32_t count);
 // uint16_t gui_ctrl_read_data(void);
 void gui_ctrl_setRectScreen(uint16_t x, uint16_t y, uint16_t w, uint16_t h);
 void gui_ctrl_setPos(uint16_t x, uint16_t y);
@@ -53,6 +53,15 @@ void gui_ctrl_write_data(uint16_t data)
     ssd1306_increment();
 }
 
+void gui_ctrl_write_dataRepeat(uint16_t data, uint32_t count)
+{
+    while (count > 0)
+    {
+        gui_ctrl_write_data(data);
+        count--;
+    }
+}
+
 void gui_ctrl_update(void)
 {
     uint16_t i;
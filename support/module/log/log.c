@@ -0,0 +1,204 @@
+/**
+ * @file log.c
+ * @author agent
+ * @copyright UniSwarm 2026
+ *
+ * @date October 19, 2026, 07:50 PM
+ *
+ * @brief Deferred binary logging
+ *
+ * Producers, main code and interrupt handlers, push complete records under a
+ * short critical section, a record is dropped if it does not fit entirely.
+ * log_task is the only consumer and pops without lock.
+ */
+
+#include "log.h"
+
+#include <driver/uart.h>
+#include <sys/fifo.h>
+
+#include <archi.h>
+#include <stdarg.h>
+#include <string.h>
+
+#ifdef SIMULATOR
+#    include <pthread.h>
+static pthread_mutex_t log_mutex = PTHREAD_MUTEX_INITIALIZER;
+#    define log_lock(state)                                                                                            \
+        do                                                                                                             \
+        {                                                                                                              \
+            disable_interrupt_save(state);                                                                             \
+            pthread_mutex_lock(&log_mutex);                                                                            \
+        } while (0)
+#    define log_unlock(state)                                                                                          \
+        do                                                                                                             \
+        {                                                                                                              \
+            pthread_mutex_unlock(&log_mutex);                                                                          \
+            restore_interrupt(state);                                                                                  \
+        } while (0)
+#else
+#    define log_lock(state)   disable_interrupt_save(state)
+#    define log_unlock(state) restore_interrupt(state)
+#endif
+
+#define LOG_RECORD_SIZE(argCount) (2 + 4 + 4 * (argCount))
+
+const char LOG_SECTION log_base[] = "";
+
+static STATIC_FIFO(log_fifo, LOG_BUFFER_SIZE);
+static volatile uint16_t log_droppedCount = 0;
+static uint16_t log_droppedTotal = 0;
+
+static rt_dev_t log_device = NULLDEV;
+static char log_txBuff[64];
+static uint8_t log_txLen = 0;
+static uint8_t log_txPos = 0;
+
+/**
+ * @brief Initializes the log ring buffer and sets the uart used by log_task
+ * @param device uart device, opened and enabled by the caller, NULLDEV to read records with log_read
+ * @return 0
+ */
+int log_init(rt_dev_t device)
+{
+    STATIC_FIFO_INIT(log_fifo, LOG_BUFFER_SIZE);
+    log_droppedCount = 0;
+    log_droppedTotal = 0;
+    log_device = device;
+    log_txLen = 0;
+    log_txPos = 0;
+    return 0;
+}
+
+static uint8_t log_encode(char *record, uint32_t id, uint8_t argCount)
+{
+    record[0] = LOG_SYNC;
+    record[1] = argCount;
+    record[2] = id;
+    record[3] = id >> 8;
+    record[4] = id >> 16;
+    record[5] = id >> 24;
+    return LOG_RECORD_SIZE(0);
+}
+
+static void log_encodeArg(char *record, uint32_t arg)
+{
+    record[0] = arg;
+    record[1] = arg >> 8;
+    record[2] = arg >> 16;
+    record[3] = arg >> 24;
+}
+
+/**
+ * @brief Pushes a record, use the LOG macro instead
+ * @param id format string id
+ * @param argCount number of 32 bits arguments following
+ */
+void log_write(uint32_t id, uint8_t argCount, ...)
+{
+    char record[LOG_RECORD_SIZE(LOG_MAX_ARGS)];
+    char droppedRecord[LOG_RECORD_SIZE(1)];
+    uint8_t size, i;
+    va_list args;
+    rt_reg_t irqState;
+
+    if (argCount > LOG_MAX_ARGS)
+    {
+        argCount = LOG_MAX_ARGS;
+    }
+    size = log_encode(record, id, argCount);
+    va_start(args, argCount);
+    for (i = 0; i < argCount; i++)
+    {
+        log_encodeArg(record + size, va_arg(args, int32_t));
+        size += 4;
+    }
+    va_end(args);
+
+    log_lock(irqState);
+    if (log_droppedCount != 0)
+    {
+        // reports dropped records before the next one that fits
+        if (fifo_avail(&log_fifo) < (size_t)(LOG_RECORD_SIZE(1) + size))
+        {
+            log_droppedCount++;
+            log_droppedTotal++;
+            log_unlock(irqState);
+            return;
+        }
+        log_encode(droppedRecord, LOG_ID_DROPPED, 1);
+        log_encodeArg(droppedRecord + LOG_RECORD_SIZE(0), log_droppedCount);
+        fifo_push(&log_fifo, droppedRecord, LOG_RECORD_SIZE(1));
+        log_droppedCount = 0;
+    }
+    if (fifo_avail(&log_fifo) < size)
+    {
+        log_droppedCount++;
+        log_droppedTotal++;
+        log_unlock(irqState);
+        return;
+    }
+    fifo_push(&log_fifo, record, size);
+    log_unlock(irqState);
+}
+
+/**
+ * @brief Gives the raw bits of a float to pass it as a LOG argument
+ */
+uint32_t log_float(float value)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+/**
+ * @brief Pops raw records bytes, to send the log on another transport than log_task uart
+ * @param data destination buffer
+ * @param size destination buffer size
+ * @return number of bytes read
+ */
+size_t log_read(char *data, size_t size)
+{
+    return fifo_pop(&log_fifo, data, size);
+}
+
+/**
+ * @brief Sends pending records to the log uart without blocking, to call in the main loop or a scheduler task
+ */
+void log_task(void)
+{
+    ssize_t written;
+
+    if (log_device == NULLDEV)
+    {
+        return;
+    }
+
+    while (1)
+    {
+        if (log_txPos == log_txLen)
+        {
+            log_txLen = fifo_pop(&log_fifo, log_txBuff, sizeof(log_txBuff));
+            log_txPos = 0;
+            if (log_txLen == 0)
+            {
+                return;
+            }
+        }
+        written = uart_write(log_device, log_txBuff + log_txPos, log_txLen - log_txPos);
+        if (written <= 0)
+        {
+            return;
+        }
+        log_txPos += written;
+    }
+}
+
+/**
+ * @brief Total number of records dropped as the ring buffer was full
+ */
+uint16_t log_dropped(void)
+{
+    return log_droppedTotal;
+}
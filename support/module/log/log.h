@@ -0,0 +1,77 @@
+/**
+ * @file log.h
+ * @author agent
+ * @copyright UniSwarm 2026
+ *
+ * @date October 19, 2026, 07:50 PM
+ *
+ * @brief Deferred binary logging
+ *
+ * LOG("speed %d mm/s", speed) stores the format string in the .udklog section,
+ * which is kept in the ELF file but never loaded in the target, and pushes
+ * only a string id and the raw arguments in a ring buffer. log_task sends the
+ * ring content to the log uart, tool/udk-log decodes the stream with the ELF.
+ *
+ * Arguments are sent as 32 bits integers, floats must be passed with
+ * log_float(value) and printed with %f, %e or %g. %s is not supported.
+ *
+ * Record : LOG_SYNC, argument count, 32 bits id, 32 bits arguments, little endian
+ */
+
+#ifndef LOG_H
+#define LOG_H
+
+#include <driver/device.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+// ring buffer size, must be a power of two
+#ifndef LOG_BUFFER_SIZE
+#    define LOG_BUFFER_SIZE 512
+#endif
+
+#define LOG_SYNC       0xA5
+#define LOG_MAX_ARGS   6
+#define LOG_ID_DROPPED 0xFFFFFFFF  // one argument, count of records dropped as the ring was full
+
+// non loaded section, the assembler comment character hides section flags added by the compiler
+#if defined(__XC16)
+#    define LOG_SECTION __attribute__((section(".udklog, info ;"), used))
+#elif defined(_WIN32)
+#    define LOG_SECTION __attribute__((section(".udklog"), used))
+#else
+#    define LOG_SECTION __attribute__((section(".udklog,\"\",@progbits #"), used))
+#endif
+
+int log_init(rt_dev_t device);
+void log_task(void);
+size_t log_read(char *data, size_t size);
+uint16_t log_dropped(void);
+
+void log_write(uint32_t id, uint8_t argCount, ...);
+uint32_t log_float(float value);
+
+// string ids are offsets from log_base in the .udklog section
+extern const char log_base[];
+
+#define LOG(fmt, ...)                                                                                                  \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        static const char LOG_SECTION log_fmt[] = fmt;                                                                 \
+        log_write((uint32_t)(int32_t)(log_fmt - log_base), LOG_NARGS(__VA_ARGS__) LOG_ARGS(__VA_ARGS__));            \
+    } while (0)
+
+#define LOG_NARGS(...)                                      LOG_NARGS_(0, ##__VA_ARGS__, 6, 5, 4, 3, 2, 1, 0)
+#define LOG_NARGS_(_0, _1, _2, _3, _4, _5, _6, count, ...) count
+#define LOG_CAT(a, b)                                       LOG_CAT_(a, b)
+#define LOG_CAT_(a, b)                                      a##b
+#define LOG_ARGS(...)                                       LOG_CAT(LOG_ARGS_, LOG_NARGS(__VA_ARGS__))(__VA_ARGS__)
+#define LOG_ARGS_0(...)
+#define LOG_ARGS_1(a)                , (int32_t)(a)
+#define LOG_ARGS_2(a, b)             LOG_ARGS_1(a), (int32_t)(b)
+#define LOG_ARGS_3(a, b, c)          LOG_ARGS_2(a, b), (int32_t)(c)
+#define LOG_ARGS_4(a, b, c, d)       LOG_ARGS_3(a, b, c), (int32_t)(d)
+#define LOG_ARGS_5(a, b, c, d, e)    LOG_ARGS_4(a, b, c, d), (int32_t)(e)
+#define LOG_ARGS_6(a, b, c, d, e, f) LOG_ARGS_5(a, b, c, d, e), (int32_t)(f)
+
+#endif  // LOG_H
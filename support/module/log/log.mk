@@ -0,0 +1,22 @@
+ifndef LOG_MODULE
+LOG_MODULE=
+
+vpath %.c $(MODULEPATH)
+vpath %.h $(MODULEPATH)
+
+DRIVERS += uart
+
+SRC += log.c
+HEADER += log.h
+
+# UDKLOG_EXE host decoder
+ifeq ($(OS),Windows_NT)
+ UDKLOG_EXE := $(UDEVKIT)/bin/udk-log.exe
+else
+ UDKLOG_EXE := $(UDEVKIT)/bin/udk-log
+endif
+$(UDKLOG_EXE): $(UDEVKIT)/tool/udk-log/main.cpp $(UDEVKIT)/tool/udk-log/udk-log.pro
+	@echo "Building udk-log..."
+	cd $(UDEVKIT)/tool/udk-log/ && make
+
+endif
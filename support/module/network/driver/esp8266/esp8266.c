@@ -15,10 +15,15 @@
 #include <stdlib.h>
 #include <string.h>
 
-#include <board.h>
+#ifndef TEST_ESP8266
+#    include <board.h>
+#else
+#    define ESP8266_UART 1
+#endif
 
 #include "driver/uart.h"
 #include "sys/buffer.h"
+#include "sys/softtimer.h"
 
 // data receive from esp
 uint8_t esp8266_socket = 0;
@@ -26,75 +31,11 @@ uint16_t esp8266_sizePacket = 0;
 uint16_t esp8266_idPacket = 0;
 uint8_t esp8266_flagPacket = 0;
 char /*__attribute__((far))*/ esp8266_dataPacket[2049];
+uint8_t esp8266_linkStatus = 0;  // bit field of connected sockets
 
 // station IP
 char esp8266_ip[16] = "";
-uint8_t esp8266_ipid = 0;
 char esp8266_mac[18] = "";
-uint8_t esp8266_macid = 0;
-
-typedef enum
-{
-    FSM_UNKNOW = 0,
-    FSM_WAITING_VALIDATE,
-    FSM_START,
-
-    FSM_ready_r,
-    FSM_ready_e,
-    FSM_ready_a,
-    FSM_ready_d,
-    FSM_ready_y,
-
-    FSM_OK_O,
-    FSM_OK_K,
-
-    FSM_SENDOK_S,
-    FSM_SENDOK_E,
-    FSM_SENDOK_N,
-    FSM_SENDOK_D,
-    FSM_SENDOK_Sp,
-    FSM_SENDOK_O,
-    FSM_SENDOK_K,
-
-    FSM_ERROR_E,
-    FSM_ERROR_R1,
-    FSM_ERROR_R2,
-    FSM_ERROR_O,
-    FSM_ERROR_R3,
-
-    FSM_FAIL_F,
-    FSM_FAIL_A,
-    FSM_FAIL_I,
-    FSM_FAIL_L,
-
-    FSM_PLUS,
-
-    FSM_IP_C,
-    FSM_IP_I,
-    FSM_IP_F,
-    FSM_IP_S,
-    FSM_IP_R,
-    FSM_IP_dP,
-    FSM_IP_S2,
-    FSM_IP_T,
-    FSM_IP_A,
-    FSM_IP_WIP,
-    FSM_IP_IP,
-    FSM_IP_WMAC,
-    FSM_IP_MAC,
-
-    FSM_IPD_I,
-    FSM_IPD_P,
-    FSM_IPD_D,
-    FSM_IPD_COMMA_1,
-    FSM_IPD_SOCKET_DIGIT,
-    FSM_IPD_COMMA_2,
-    FSM_IPD_SIZE_DIGITS,
-    FSM_PACKET_RX,
-    FSM_RX_COMPLETE
-
-} ESP8266_FSMSTATE;
-volatile ESP8266_FSMSTATE esp8266_fsmState = FSM_START;
 
 typedef enum
 {
@@ -107,7 +48,6 @@ typedef enum
     ESP8266_STATE_SEND_DATA,
     ESP8266_STATE_SEND_OK
 } ESP8266_STATE;
-volatile ESP8266_STATE esp8266_pendingState = ESP8266_STATE_NONE;
 volatile ESP8266_STATE esp8266_state = ESP8266_STATE_NONE;
 
 typedef enum
@@ -130,11 +70,94 @@ volatile ESP8266_CMD esp8266_currentCmd = ESP8266_CMD_NONE;
 
 uint8_t esp8266_config = 0;
 
-void esp8266_parse(char rec);
+// sockets transmission queues
+#define ESP8266_TXQUEUE_SIZE 8  // must be a power of 2
+#define ESP8266_SEND_MAX_SIZE 2048
+typedef struct
+{
+    const char *data;   ///< data to send, NULL to close the socket
+    unsigned int size;  ///< size of data in bytes
+} Esp8266_TxSegment;
+
+typedef struct
+{
+    Esp8266_TxSegment segments[ESP8266_TXQUEUE_SIZE];
+    volatile uint8_t head;
+    volatile uint8_t tail;
+    unsigned int sent;  ///< bytes of the tail segment already sent
+} Esp8266_TxQueue;
+Esp8266_TxQueue esp8266_txQueues[ESP8266_SOCKET_COUNT];
+
+typedef enum
+{
+    ESP8266_TX_IDLE = 0,
+    ESP8266_TX_WAIT_PROMPT,  ///< CIPSEND header sent, waiting for '>'
+    ESP8266_TX_WAIT_SENDOK,  ///< data sent, waiting for SEND OK
+    ESP8266_TX_WAIT_CLOSE    ///< CIPCLOSE sent, waiting for OK
+} ESP8266_TXSTATE;
+ESP8266_TXSTATE esp8266_txState = ESP8266_TX_IDLE;
+uint8_t esp8266_txSocket = 0;       // socket currently in transmission
+uint16_t esp8266_txChunkSize = 0;   // size of the chunk currently in transmission
+uint8_t esp8266_txNextSocket = 0xFF;  // socket of the prepared header, 0xFF if none
+uint16_t esp8266_txNextSize = 0;
+SoftTimer esp8266_txTimer;              // response timeout of the current tx state
+volatile uint8_t esp8266_txExpired = 0;
+
+// AT responses parser
+typedef enum
+{
+    ESP8266_RESP_STATE = 0,  ///< whole line response, sets driver state
+    ESP8266_RESP_CONNECT,    ///< "<link id>,CONNECT" response
+    ESP8266_RESP_CLOSED,     ///< "<link id>,CLOSED" response
+    ESP8266_RESP_STAIP,      ///< station IP, line prefix
+    ESP8266_RESP_STAMAC      ///< station MAC, line prefix
+} ESP8266_RESP_TYPE;
+
+typedef struct
+{
+    const char *keyword;
+    uint8_t size;
+    ESP8266_RESP_TYPE type;
+    ESP8266_STATE state;
+} Esp8266_Response;
+
+#define ESP8266_RESPONSE(keyword, type, state)                                                                         \
+    {                                                                                                                  \
+        (keyword), sizeof(keyword) - 1, (type), (state)                                                                \
+    }
+// to handle a new AT response, simply add it to this table
+static const Esp8266_Response esp8266_responses[] = {
+    ESP8266_RESPONSE("OK", ESP8266_RESP_STATE, ESP8266_STATE_OK),
+    ESP8266_RESPONSE("SEND OK", ESP8266_RESP_STATE, ESP8266_STATE_SEND_OK),
+    ESP8266_RESPONSE("ERROR", ESP8266_RESP_STATE, ESP8266_STATE_ERROR),
+    ESP8266_RESPONSE("FAIL", ESP8266_RESP_STATE, ESP8266_STATE_FAIL),
+    ESP8266_RESPONSE("SEND FAIL", ESP8266_RESP_STATE, ESP8266_STATE_FAIL),
+    ESP8266_RESPONSE("ready", ESP8266_RESP_STATE, ESP8266_STATE_READY),
+    ESP8266_RESPONSE(",CONNECT", ESP8266_RESP_CONNECT, ESP8266_STATE_NONE),
+    ESP8266_RESPONSE(",CLOSED", ESP8266_RESP_CLOSED, ESP8266_STATE_NONE),
+    ESP8266_RESPONSE("+CIFSR:STAIP,\"", ESP8266_RESP_STAIP, ESP8266_STATE_NONE),
+    ESP8266_RESPONSE("+CIFSR:STAMAC,\"", ESP8266_RESP_STAMAC, ESP8266_STATE_NONE),
+};
+#define ESP8266_RESPONSE_COUNT (sizeof(esp8266_responses) / sizeof(Esp8266_Response))
+
+#define ESP8266_LINE_SIZE 48
+char esp8266_line[ESP8266_LINE_SIZE];
+uint8_t esp8266_lineSize = 0;
+uint8_t esp8266_rxPayload = 0;  // 1 while +IPD payload is received
+
+// received data not parsed yet, a new +IPD payload waits for the previous packet to be read
+char esp8266_rxBuff[200];
+uint8_t esp8266_rxPos = 0;
+uint8_t esp8266_rxLen = 0;
+
+size_t esp8266_parse(const char *data, size_t size);
+void esp8266_tx_task(void);
+int esp8266_tx_push(uint8_t sock, const char *data, unsigned int size);
 
 rt_dev_t esp8266_uart;
 
 STATIC_BUFFER(esp8266_txBuff, 100);
+STATIC_BUFFER(esp8266_txHeader, 24);
 
 /**
  * @brief Internal function to initailise UART to ESP8266
@@ -158,6 +181,9 @@ void esp8266_init(void)
 
     // buffer cmd construction init
     STATIC_BUFFER_INIT(esp8266_txBuff, 100);
+    STATIC_BUFFER_INIT(esp8266_txHeader, 24);
+
+    memset(esp8266_txQueues, 0, sizeof(esp8266_txQueues));
 }
 
 /**
@@ -165,22 +191,18 @@ void esp8266_init(void)
  */
 void esp8266_task(void)
 {
-    char esp8266_rxBuff[200];
     ssize_t read_size;
 
     // read esp uart response and parse it
-    read_size = uart_read(esp8266_uart, esp8266_rxBuff, 200);
-    if (read_size > 0)
+    if (esp8266_rxPos == esp8266_rxLen)
     {
-        int i;
-        char *esp8266_txBuffPtr;
-        // parse it
-        esp8266_txBuffPtr = esp8266_rxBuff;
-        for (i = 0; i < read_size; i++)
-        {
-            esp8266_parse(*esp8266_txBuffPtr);
-            esp8266_txBuffPtr++;
-        }
+        read_size = uart_read(esp8266_uart, esp8266_rxBuff, sizeof(esp8266_rxBuff));
+        esp8266_rxPos = 0;
+        esp8266_rxLen = (read_size > 0) ? read_size : 0;
+    }
+    if (esp8266_rxPos < esp8266_rxLen)
+    {
+        esp8266_rxPos += esp8266_parse(esp8266_rxBuff + esp8266_rxPos, esp8266_rxLen - esp8266_rxPos);
     }
 
     // send base configuration (begining only)
@@ -222,393 +244,455 @@ void esp8266_task(void)
             }
             esp8266_config++;
         }
+        return;
     }
+
+    // sockets transmission
+    esp8266_tx_task();
 }
 
 /**
- * @brief Internal function to parse response of AT commands
- * @param rec new char to parse
+ * @brief Internal function to know if a socket has data to send or to be closed
+ * @param sock id of the socket
+ * @return number of segments waiting in socket queue
  */
-void esp8266_parse(char rec)
+uint8_t esp8266_tx_queueLen(uint8_t sock)
 {
-    switch (esp8266_fsmState)
-    {
-        case FSM_UNKNOW:
-            if (rec == '\n')
-                esp8266_fsmState = FSM_START;
-            else
-                esp8266_fsmState = FSM_UNKNOW;
-            break;
-        case FSM_WAITING_VALIDATE:
-            if (rec == '\n')
-            {
-                // validate
-                if (esp8266_pendingState != ESP8266_STATE_NONE)
-                    esp8266_state = esp8266_pendingState;
-                esp8266_pendingState = ESP8266_STATE_NONE;
+    Esp8266_TxQueue *queue = &esp8266_txQueues[sock];
+    return (queue->head - queue->tail) & (ESP8266_TXQUEUE_SIZE - 1);
+}
 
-                esp8266_fsmState = FSM_START;
-            }
-            else
-                esp8266_fsmState = FSM_UNKNOW;
-            break;
-        case FSM_START:
-            if (rec == '\r')
-                esp8266_fsmState = FSM_WAITING_VALIDATE;
-            else if (rec == '+')
-                esp8266_fsmState = FSM_PLUS;
-            else if (rec == 'S')
-                esp8266_fsmState = FSM_SENDOK_S;
-            else if (rec == 'E')
-                esp8266_fsmState = FSM_ERROR_E;
-            else if (rec == 'r')
-                esp8266_fsmState = FSM_ready_r;
-            else if (rec == 'F')
-                esp8266_fsmState = FSM_FAIL_F;
-            else if (rec == '>')
-            {
-                esp8266_state = ESP8266_STATE_SEND_DATA;
-                esp8266_fsmState = FSM_UNKNOW;
-            }
-            else if (rec == 'O')
-                esp8266_fsmState = FSM_OK_O;
-            else
-                esp8266_fsmState = FSM_UNKNOW;
-            break;
+/**
+ * @brief Internal function to drop the tail segment of a socket queue
+ * @param sock id of the socket
+ */
+void esp8266_tx_pop(uint8_t sock)
+{
+    Esp8266_TxQueue *queue = &esp8266_txQueues[sock];
+    queue->tail = (queue->tail + 1) & (ESP8266_TXQUEUE_SIZE - 1);
+    queue->sent = 0;
+}
 
-        case FSM_SENDOK_S:
-            if (rec == 'E')
-                esp8266_fsmState = FSM_SENDOK_E;
-            else
-                esp8266_fsmState = FSM_UNKNOW;
-            break;
-        case FSM_SENDOK_E:
-            if (rec == 'N')
-                esp8266_fsmState = FSM_SENDOK_N;
-            else
-                esp8266_fsmState = FSM_UNKNOW;
-            break;
-        case FSM_SENDOK_N:
-            if (rec == 'D')
-                esp8266_fsmState = FSM_SENDOK_D;
-            else
-                esp8266_fsmState = FSM_UNKNOW;
-            break;
-        case FSM_SENDOK_D:
-            if (rec == ' ')
-                esp8266_fsmState = FSM_SENDOK_Sp;
-            else
-                esp8266_fsmState = FSM_UNKNOW;
-            break;
-        case FSM_SENDOK_Sp:
-            if (rec == 'O')
-                esp8266_fsmState = FSM_SENDOK_O;
-            else
-                esp8266_fsmState = FSM_UNKNOW;
-            break;
-        case FSM_SENDOK_O:
-            if (rec == 'K')
-                esp8266_fsmState = FSM_SENDOK_K;
-            else
-                esp8266_fsmState = FSM_UNKNOW;
-            break;
-        case FSM_SENDOK_K:
-            if (rec == '\r')
-            {
-                esp8266_pendingState = ESP8266_STATE_SEND_OK;
-                esp8266_fsmState = FSM_WAITING_VALIDATE;
-            }
-            else
-                esp8266_fsmState = FSM_UNKNOW;
-            break;
+/**
+ * @brief Internal function to prepare the CIPSEND header of the next chunk to send,
+ * sockets are served in round robin
+ */
+void esp8266_tx_prepare(void)
+{
+    uint8_t i, sock;
 
-        case FSM_ERROR_E:
-            if (rec == 'R')
-                esp8266_fsmState = FSM_ERROR_R1;
-            else
-                esp8266_fsmState = FSM_UNKNOW;
-            break;
-        case FSM_ERROR_R1:
-            if (rec == 'R')
-                esp8266_fsmState = FSM_ERROR_R2;
-            else
-                esp8266_fsmState = FSM_UNKNOW;
-            break;
-        case FSM_ERROR_R2:
-            if (rec == 'O')
-                esp8266_fsmState = FSM_ERROR_O;
-            else
-                esp8266_fsmState = FSM_UNKNOW;
-            break;
-        case FSM_ERROR_O:
-            if (rec == 'R')
-                esp8266_fsmState = FSM_ERROR_R3;
-            else
-                esp8266_fsmState = FSM_UNKNOW;
-            break;
-        case FSM_ERROR_R3:
-            if (rec == '\r')
+    esp8266_txNextSocket = 0xFF;
+    for (i = 1; i <= ESP8266_SOCKET_COUNT; i++)
+    {
+        Esp8266_TxQueue *queue;
+        Esp8266_TxSegment *segment;
+        uint8_t id, len;
+        unsigned int remaining, sent;
+
+        sock = (esp8266_txSocket + i) % ESP8266_SOCKET_COUNT;
+        queue = &esp8266_txQueues[sock];
+        len = esp8266_tx_queueLen(sock);
+        id = queue->tail;
+        sent = queue->sent;
+
+        // skip the chunk currently in transmission, it will be acknowledged by SEND OK
+        if (len != 0 && sock == esp8266_txSocket && esp8266_txState == ESP8266_TX_WAIT_SENDOK)
+        {
+            sent += esp8266_txChunkSize;
+            if (sent >= queue->segments[id].size)
             {
-                esp8266_pendingState = ESP8266_STATE_ERROR;
-                esp8266_fsmState = FSM_WAITING_VALIDATE;
+                id = (id + 1) & (ESP8266_TXQUEUE_SIZE - 1);
+                sent = 0;
+                len--;
             }
-            else
-                esp8266_fsmState = FSM_UNKNOW;
-            break;
+        }
+        if (len == 0)
+        {
+            continue;
+        }
 
-        case FSM_FAIL_F:
-            if (rec == 'A')
-                esp8266_fsmState = FSM_FAIL_A;
-            else
-                esp8266_fsmState = FSM_UNKNOW;
-            break;
-        case FSM_FAIL_A:
-            if (rec == 'I')
-                esp8266_fsmState = FSM_FAIL_I;
-            else
-                esp8266_fsmState = FSM_UNKNOW;
-            break;
-        case FSM_FAIL_I:
-            if (rec == 'L')
-                esp8266_fsmState = FSM_FAIL_L;
-            else
-                esp8266_fsmState = FSM_UNKNOW;
-            break;
-        case FSM_FAIL_L:
-            if (rec == '\r')
-            {
-                esp8266_pendingState = ESP8266_STATE_FAIL;
-                esp8266_fsmState = FSM_WAITING_VALIDATE;
-            }
-            else
-                esp8266_fsmState = FSM_UNKNOW;
-            break;
+        segment = &queue->segments[id];
+        if (segment->data == NULL)  // close request
+        {
+            esp8266_txNextSocket = sock;
+            esp8266_txNextSize = 0;
+            return;
+        }
 
-        case FSM_ready_r:
-            if (rec == 'e')
-                esp8266_fsmState = FSM_ready_e;
-            else
-                esp8266_fsmState = FSM_UNKNOW;
-            break;
-        case FSM_ready_e:
-            if (rec == 'a')
-                esp8266_fsmState = FSM_ready_a;
-            else
-                esp8266_fsmState = FSM_UNKNOW;
-            break;
-        case FSM_ready_a:
-            if (rec == 'd')
-                esp8266_fsmState = FSM_ready_d;
-            else
-                esp8266_fsmState = FSM_UNKNOW;
-            break;
-        case FSM_ready_d:
-            if (rec == 'y')
-                esp8266_fsmState = FSM_ready_y;
-            else
-                esp8266_fsmState = FSM_UNKNOW;
-            break;
-        case FSM_ready_y:
-            if (rec == '\r')
+        // chunk is the remaining of the segment, limited by AT+CIPSEND size
+        remaining = segment->size - sent;
+        if (remaining > ESP8266_SEND_MAX_SIZE)
+        {
+            remaining = ESP8266_SEND_MAX_SIZE;
+        }
+
+        buffer_clear(&esp8266_txHeader);
+        buffer_astring(&esp8266_txHeader, "AT+CIPSEND=");
+        buffer_aint(&esp8266_txHeader, (int)sock);
+        buffer_achar(&esp8266_txHeader, ',');
+        buffer_aint(&esp8266_txHeader, (int)remaining);
+        buffer_astring(&esp8266_txHeader, "\r\n");
+
+        esp8266_txNextSocket = sock;
+        esp8266_txNextSize = remaining;
+        return;
+    }
+}
+
+static void esp8266_tx_timeout(void)
+{
+    esp8266_txExpired = 1;
+}
+
+/**
+ * @brief Internal function to change the transmission state, and to restart the
+ * timeout of the response it waits for
+ * @param state new state
+ */
+void esp8266_tx_setState(ESP8266_TXSTATE state)
+{
+    esp8266_txState = state;
+    esp8266_txExpired = 0;
+    if (state == ESP8266_TX_IDLE)
+    {
+        softtimer_stop(&esp8266_txTimer);
+    }
+    else
+    {
+        softtimer_start(&esp8266_txTimer, esp8266_tx_timeout, ESP8266_TX_TIMEOUT_US, 0);
+    }
+}
+
+/**
+ * @brief Internal function to drop the queue of the socket in transmission, after
+ * an error or a timeout
+ * @param closeLink 1 to queue a close of the socket, as the state of the link is unknown
+ */
+void esp8266_tx_drop(uint8_t closeLink)
+{
+    Esp8266_TxQueue *queue = &esp8266_txQueues[esp8266_txSocket];
+
+    queue->tail = queue->head;
+    queue->sent = 0;
+    esp8266_txNextSocket = 0xFF;
+    if (closeLink)
+    {
+        esp8266_tx_push(esp8266_txSocket, NULL, 0);
+    }
+    esp8266_tx_setState(ESP8266_TX_IDLE);
+}
+
+/**
+ * @brief Internal function to drain sockets transmission queues
+ */
+void esp8266_tx_task(void)
+{
+    Esp8266_TxQueue *queue;
+    Esp8266_TxSegment *segment;
+
+    // no response from the module, the socket is dropped to not block the others
+    if (esp8266_txExpired && esp8266_txState != ESP8266_TX_IDLE)
+    {
+        if (esp8266_txState == ESP8266_TX_WAIT_CLOSE)
+        {
+            esp8266_tx_pop(esp8266_txSocket);
+            esp8266_tx_setState(ESP8266_TX_IDLE);
+        }
+        else
+        {
+            esp8266_tx_drop(1);
+        }
+        return;
+    }
+
+    switch (esp8266_txState)
+    {
+        case ESP8266_TX_IDLE:
+            if (esp8266_txNextSocket == 0xFF)
             {
-                esp8266_pendingState = ESP8266_STATE_READY;
-                esp8266_fsmState = FSM_WAITING_VALIDATE;
+                esp8266_tx_prepare();
+                if (esp8266_txNextSocket == 0xFF)
+                {
+                    return;  // nothing to send
+                }
             }
-            else
-                esp8266_fsmState = FSM_UNKNOW;
-            break;
 
-        case FSM_OK_O:
-            if (rec == 'K')
-                esp8266_fsmState = FSM_OK_K;
-            else
-                esp8266_fsmState = FSM_UNKNOW;
-            break;
-        case FSM_OK_K:
-            if (rec == '\r')
+            esp8266_txSocket = esp8266_txNextSocket;
+            esp8266_txChunkSize = esp8266_txNextSize;
+            esp8266_txNextSocket = 0xFF;
+            esp8266_state = ESP8266_STATE_NONE;
+            if (esp8266_txChunkSize == 0)
             {
-                esp8266_pendingState = ESP8266_STATE_OK;
-                esp8266_fsmState = FSM_WAITING_VALIDATE;
+                buffer_clear(&esp8266_txBuff);
+                buffer_astring(&esp8266_txBuff, "AT+CIPCLOSE=");
+                buffer_aint(&esp8266_txBuff, esp8266_txSocket);
+                buffer_astring(&esp8266_txBuff, "\r\n");
+                esp8266_send_cmddat(esp8266_txBuff.data, esp8266_txBuff.size);
+                esp8266_currentCmd = ESP8266_CMD_CLOSESOCKET;
+                esp8266_tx_setState(ESP8266_TX_WAIT_CLOSE);
             }
             else
-                esp8266_fsmState = FSM_UNKNOW;
-            break;
-
-        case FSM_PLUS:
-            if (rec == 'I')
-                esp8266_fsmState = FSM_IPD_I;
-            else if (rec == 'C')
-                esp8266_fsmState = FSM_IP_C;  // wait IP
-            else
-                esp8266_fsmState = FSM_UNKNOW;
-            break;
-        case FSM_IP_C:
-            if (rec == 'I')
-                esp8266_fsmState = FSM_IP_I;
-            else
-                esp8266_fsmState = FSM_UNKNOW;
-            break;
-        case FSM_IP_I:
-            if (rec == 'F')
-                esp8266_fsmState = FSM_IP_F;
-            else
-                esp8266_fsmState = FSM_UNKNOW;
-            break;
-        case FSM_IP_F:
-            if (rec == 'S')
-                esp8266_fsmState = FSM_IP_S;
-            else
-                esp8266_fsmState = FSM_UNKNOW;
-            break;
-        case FSM_IP_S:
-            if (rec == 'R')
-                esp8266_fsmState = FSM_IP_R;
-            else
-                esp8266_fsmState = FSM_UNKNOW;
-            break;
-        case FSM_IP_R:
-            if (rec == ':')
-                esp8266_fsmState = FSM_IP_dP;
-            else
-                esp8266_fsmState = FSM_UNKNOW;
-            break;
-        case FSM_IP_dP:
-            if (rec == 'S')
-                esp8266_fsmState = FSM_IP_S2;
-            else
-                esp8266_fsmState = FSM_UNKNOW;
-            break;
-        case FSM_IP_S2:
-            if (rec == 'T')
-                esp8266_fsmState = FSM_IP_T;
-            else
-                esp8266_fsmState = FSM_UNKNOW;
-            break;
-        case FSM_IP_T:
-            if (rec == 'A')
-                esp8266_fsmState = FSM_IP_A;
-            else
-                esp8266_fsmState = FSM_UNKNOW;
-            break;
-        case FSM_IP_A:
-            if (rec == 'I')
-                esp8266_fsmState = FSM_IP_WIP;
-            else if (rec == 'M')
-                esp8266_fsmState = FSM_IP_WMAC;
-            else
-                esp8266_fsmState = FSM_UNKNOW;
-            break;
-        case FSM_IP_WIP:
-            if (rec == '"')
             {
-                esp8266_fsmState = FSM_IP_IP;
-                esp8266_ipid = 0;
+                // header was already prepared
+                esp8266_send_cmddat(esp8266_txHeader.data, esp8266_txHeader.size);
+                esp8266_currentCmd = ESP8266_CMD_WRITESOCK_REQ;
+                esp8266_tx_setState(ESP8266_TX_WAIT_PROMPT);
             }
-            else if (rec == '\r')
-                esp8266_fsmState = FSM_UNKNOW;
-            else
-                esp8266_fsmState = FSM_IP_WIP;  // wait IP
             break;
-        case FSM_IP_IP:
-            if ((rec >= '0' && rec <= '9') || rec == '.')
-                esp8266_ip[esp8266_ipid++] = rec;
-            else
+
+        case ESP8266_TX_WAIT_PROMPT:
+            if (esp8266_state == ESP8266_STATE_SEND_DATA)
             {
-                esp8266_ip[esp8266_ipid] = 0;
-                esp8266_fsmState = FSM_UNKNOW;
+                esp8266_state = ESP8266_STATE_NONE;
+                queue = &esp8266_txQueues[esp8266_txSocket];
+                segment = &queue->segments[queue->tail];
+
+                uart_write(esp8266_uart, (char *)segment->data + queue->sent, esp8266_txChunkSize);
+                esp8266_currentCmd = ESP8266_CMD_WRITESOCK_DATA;
+                esp8266_tx_setState(ESP8266_TX_WAIT_SENDOK);
+
+                // prepare next header while SEND OK is pending
+                esp8266_tx_prepare();
             }
-            break;
-        case FSM_IP_WMAC:
-            if (rec == '"')
+            else if (esp8266_state == ESP8266_STATE_ERROR || esp8266_state == ESP8266_STATE_FAIL)
             {
-                esp8266_fsmState = FSM_IP_MAC;
-                esp8266_macid = 0;
+                esp8266_tx_drop(0);  // link is not valid
             }
-            else if (rec == '\r')
-                esp8266_fsmState = FSM_UNKNOW;
-            else
-                esp8266_fsmState = FSM_IP_WMAC;  // wait IP
             break;
-        case FSM_IP_MAC:
-            if ((rec >= '0' && rec <= '9') || rec == ':' || (rec >= 'a' && rec <= 'f'))
-                esp8266_mac[esp8266_macid++] = rec;
-            else
+
+        case ESP8266_TX_WAIT_SENDOK:
+            if (esp8266_state == ESP8266_STATE_SEND_OK)
             {
-                esp8266_mac[esp8266_macid] = 0;
-                esp8266_fsmState = FSM_UNKNOW;
+                queue = &esp8266_txQueues[esp8266_txSocket];
+                segment = &queue->segments[queue->tail];
+                queue->sent += esp8266_txChunkSize;
+                if (queue->sent >= segment->size)
+                {
+                    esp8266_tx_pop(esp8266_txSocket);
+                }
+                esp8266_tx_setState(ESP8266_TX_IDLE);
+                esp8266_tx_task();  // send the prepared header immediately
             }
-            break;
-        case FSM_IPD_I:
-            if (rec == 'P')
-                esp8266_fsmState = FSM_IPD_P;
-            else
-                esp8266_fsmState = FSM_UNKNOW;
-            break;
-        case FSM_IPD_P:
-            if (rec == 'D')
-                esp8266_fsmState = FSM_IPD_D;
-            else
-                esp8266_fsmState = FSM_UNKNOW;
-            break;
-        case FSM_IPD_D:
-            if (rec == ',')
-                esp8266_fsmState = FSM_IPD_COMMA_1;
-            else
-                esp8266_fsmState = FSM_UNKNOW;
-            break;
-        case FSM_IPD_COMMA_1:
-            if (rec >= '0' && rec <= '9')
+            else if (esp8266_state == ESP8266_STATE_ERROR || esp8266_state == ESP8266_STATE_FAIL)
             {
-                esp8266_fsmState = FSM_IPD_SOCKET_DIGIT;
-                esp8266_socket = rec - '0';
+                esp8266_tx_drop(0);
             }
-            else
-                esp8266_fsmState = FSM_UNKNOW;
-            break;
-        case FSM_IPD_SOCKET_DIGIT:
-            if (rec == ',')
-                esp8266_fsmState = FSM_IPD_COMMA_2;
-            else
-                esp8266_fsmState = FSM_UNKNOW;
             break;
-        case FSM_IPD_COMMA_2:
-            if (rec >= '0' && rec <= '9')
+
+        case ESP8266_TX_WAIT_CLOSE:
+            if (esp8266_state == ESP8266_STATE_OK || esp8266_state == ESP8266_STATE_ERROR)
             {
-                esp8266_fsmState = FSM_IPD_SIZE_DIGITS;
-                esp8266_sizePacket = (rec - '0');
+                esp8266_tx_pop(esp8266_txSocket);
+                esp8266_tx_setState(ESP8266_TX_IDLE);
             }
-            else
-                esp8266_fsmState = FSM_UNKNOW;
             break;
-        case FSM_IPD_SIZE_DIGITS:
-            if (rec == ':')
+    }
+}
+
+/**
+ * @brief Internal function to copy a quoted string from an AT response
+ * @param destination destination string
+ * @param source start of the string in the response line
+ * @param size max size of the destination, including 0 terminator
+ */
+void esp8266_parse_quoted(char *destination, const char *source, size_t size)
+{
+    size_t i;
+    for (i = 0; i < size - 1 && source[i] != '"' && source[i] != 0; i++)
+    {
+        destination[i] = source[i];
+    }
+    destination[i] = 0;
+}
+
+/**
+ * @brief Internal function to decode a +IPD header (+IPD,<link id>,<size> or +IPD,<size>)
+ * @return 0 if valid header
+ */
+int esp8266_parse_ipd(void)
+{
+    uint16_t values[2] = {0, 0};
+    uint8_t count = 0;
+    uint8_t i;
+
+    for (i = 5; i < esp8266_lineSize; i++)
+    {
+        char c = esp8266_line[i];
+        if (c >= '0' && c <= '9')
+        {
+            values[count] = values[count] * 10 + (c - '0');
+        }
+        else if (c == ',' && count == 0)
+        {
+            count++;
+        }
+        else
+        {
+            return -1;
+        }
+    }
+
+    if (count == 1)
+    {
+        esp8266_socket = values[0];
+        esp8266_sizePacket = values[1];
+    }
+    else
+    {
+        esp8266_socket = 0;
+        esp8266_sizePacket = values[0];
+    }
+    esp8266_idPacket = 0;
+    return 0;
+}
+
+/**
+ * @brief Internal function to match a complete response line with the responses table
+ */
+void esp8266_parse_line(void)
+{
+    uint8_t i;
+    const char *line = esp8266_line;
+    uint8_t lineSize = esp8266_lineSize;
+    uint8_t link = 0xFF;
+
+    // "<link id>,..." responses
+    if (lineSize >= 2 && line[0] >= '0' && line[0] <= '9' && line[1] == ',')
+    {
+        link = line[0] - '0';
+        line++;
+        lineSize--;
+    }
+
+    for (i = 0; i < ESP8266_RESPONSE_COUNT; i++)
+    {
+        const Esp8266_Response *response = &esp8266_responses[i];
+        if (lineSize < response->size || memcmp(line, response->keyword, response->size) != 0)
+        {
+            continue;
+        }
+
+        switch (response->type)
+        {
+            case ESP8266_RESP_STATE:
+                if (lineSize == response->size && link == 0xFF)
+                {
+                    esp8266_state = response->state;
+                    return;
+                }
+                break;
+
+            case ESP8266_RESP_CONNECT:
+                if (lineSize == response->size && link < ESP8266_SOCKET_COUNT)
+                {
+                    esp8266_linkStatus |= (1 << link);
+                    return;
+                }
+                break;
+
+            case ESP8266_RESP_CLOSED:
+                if (lineSize == response->size && link < ESP8266_SOCKET_COUNT)
+                {
+                    esp8266_linkStatus &= ~(1 << link);
+                    return;
+                }
+                break;
+
+            case ESP8266_RESP_STAIP:
+                esp8266_line[esp8266_lineSize] = 0;
+                esp8266_parse_quoted(esp8266_ip, line + response->size, sizeof(esp8266_ip));
+                return;
+
+            case ESP8266_RESP_STAMAC:
+                esp8266_line[esp8266_lineSize] = 0;
+                esp8266_parse_quoted(esp8266_mac, line + response->size, sizeof(esp8266_mac));
+                return;
+        }
+    }
+}
+
+/**
+ * @brief Internal function to parse response of AT commands
+ * @param data received data
+ * @param size size of received data
+ * @return number of bytes parsed, parsing stops before a new +IPD payload if
+ * the previous packet was not read with esp8266_getRec
+ */
+size_t esp8266_parse(const char *data, size_t size)
+{
+    const char *start = data;
+    const char *end = data + size;
+
+    while (data < end)
+    {
+        // +IPD payload, copied in bulk
+        if (esp8266_rxPayload)
+        {
+            size_t toCopy = esp8266_sizePacket - esp8266_idPacket;
+            if (toCopy > (size_t)(end - data))
             {
-                esp8266_idPacket = 0;
-                esp8266_fsmState = FSM_PACKET_RX;
+                toCopy = end - data;
             }
-            else
+            if (esp8266_idPacket < sizeof(esp8266_dataPacket) - 1)
             {
-                if (rec >= '0' && rec <= '9')
+                size_t toStore = toCopy;
+                if (esp8266_idPacket + toStore > sizeof(esp8266_dataPacket) - 1)
                 {
-                    esp8266_fsmState = FSM_IPD_SIZE_DIGITS;
-                    esp8266_sizePacket = esp8266_sizePacket * 10 + (rec - '0');
+                    toStore = sizeof(esp8266_dataPacket) - 1 - esp8266_idPacket;
                 }
-                else
-                    esp8266_fsmState = FSM_UNKNOW;
+                memcpy(esp8266_dataPacket + esp8266_idPacket, data, toStore);
             }
-            break;
-        case FSM_PACKET_RX:
-            esp8266_dataPacket[esp8266_idPacket++] = rec;
+            esp8266_idPacket += toCopy;
+            data += toCopy;
+
             if (esp8266_idPacket >= esp8266_sizePacket)
             {
+                if (esp8266_sizePacket > sizeof(esp8266_dataPacket) - 1)
+                {
+                    esp8266_sizePacket = sizeof(esp8266_dataPacket) - 1;  // truncated packet
+                }
+                // reception is notified by flag to not overwrite a pending send state
                 esp8266_flagPacket = 1;
-                esp8266_state = ESP8266_STATE_RECEIVE_DATA;
-                esp8266_fsmState = FSM_UNKNOW;
+                esp8266_rxPayload = 0;
             }
-            break;
-        default:
-            esp8266_fsmState = FSM_UNKNOW;
+            continue;
+        }
+
+        char c = *data;
+        if (c == ':' && esp8266_flagPacket == 1 && esp8266_lineSize >= 5 && memcmp(esp8266_line, "+IPD,", 5) == 0)
+        {
+            break;  // previous packet not read yet, its header and data are still in use
+        }
+        data++;
+        if (c == '\n')
+        {
+            if (esp8266_lineSize > 0 && esp8266_line[esp8266_lineSize - 1] == '\r')
+            {
+                esp8266_lineSize--;
+            }
+            esp8266_parse_line();
+            esp8266_lineSize = 0;
+        }
+        else if (c == '>' && esp8266_lineSize == 0)
+        {
+            // CIPSEND prompt, not followed by end of line
+            esp8266_state = ESP8266_STATE_SEND_DATA;
+        }
+        else if (c == ':' && esp8266_lineSize >= 5 && memcmp(esp8266_line, "+IPD,", 5) == 0)
+        {
+            // payload follows +IPD header, without end of line
+            if (esp8266_parse_ipd() == 0)
+            {
+                esp8266_rxPayload = 1;
+            }
+            esp8266_lineSize = 0;
+        }
+        else if (esp8266_lineSize < ESP8266_LINE_SIZE - 1)
+        {
+            esp8266_line[esp8266_lineSize++] = c;
+        }
     }
+    return data - start;
 }
 
 /**
@@ -643,6 +727,18 @@ ESP8266_STATUS esp8266_getStatus(void)
     return esp8266_state;
 }
 
+/**
+ * @brief Gives the connection status of a socket
+ * @param sock id of the socket
+ * @return 1 if socket is connected, 0 else
+ */
+uint8_t esp8266_socket_isConnected(uint8_t sock)
+{
+    if (sock >= ESP8266_SOCKET_COUNT)
+        return 0;
+    return (esp8266_linkStatus >> sock) & 0x01;
+}
+
 /**
  * @brief Give the id of the last socket received
  * @return socket id
@@ -843,50 +939,77 @@ int esp8266_disconnect_ap(void)
 }
 
 /**
- * @brief Closes a socket
+ * @brief Internal function to append a segment to a socket queue
+ * @param sock id of the socket
+ * @param data pointer of data to send, NULL to close the socket
+ * @param size size of data in bytes
+ * @return 0 if OK, -1 if the socket is invalid or its queue is full
+ */
+int esp8266_tx_push(uint8_t sock, const char *data, unsigned int size)
+{
+    Esp8266_TxQueue *queue;
+
+    if (sock >= ESP8266_SOCKET_COUNT)
+        return -1;
+
+    queue = &esp8266_txQueues[sock];
+    if (esp8266_tx_queueLen(sock) >= ESP8266_TXQUEUE_SIZE - 1)
+        return -1;
+
+    queue->segments[queue->head].data = data;
+    queue->segments[queue->head].size = size;
+    queue->head = (queue->head + 1) & (ESP8266_TXQUEUE_SIZE - 1);
+    return 0;
+}
+
+/**
+ * @brief Closes a socket, after all its queued data are sent
  * @param sock id of the socket to close
  */
 void esp8266_close_socket(uint8_t sock)
 {
-    if (sock > 4)
-        return;
+    esp8266_tx_push(sock, NULL, 0);
+}
 
-    buffer_clear(&esp8266_txBuff);
-    buffer_astring(&esp8266_txBuff, "AT+CIPCLOSE=");
-    buffer_aint(&esp8266_txBuff, sock);
-    buffer_astring(&esp8266_txBuff, "\r\n");
+/**
+ * @brief Queues data to send to a socket without blocking. Data are not copied,
+ * they have to stay valid until esp8266_socket_txPending returns 0 for this socket
+ * @param sock id of the socket
+ * @param data pointer of data to send
+ * @param size size of data in bytes
+ * @return 0 if OK, -1 if the socket is invalid or its queue is full
+ */
+int esp8266_queue_socket(uint8_t sock, const char *data, unsigned int size)
+{
+    if (size == 0)
+        return 0;
+    return esp8266_tx_push(sock, data, size);
+}
 
-    esp8266_send_cmddat(esp8266_txBuff.data, esp8266_txBuff.size);
-    esp8266_currentCmd = ESP8266_CMD_CLOSESOCKET;
+/**
+ * @brief Gives the transmission status of a socket
+ * @param sock id of the socket
+ * @return 1 if data are waiting to be sent or socket to be closed, 0 else
+ */
+uint8_t esp8266_socket_txPending(uint8_t sock)
+{
+    if (sock >= ESP8266_SOCKET_COUNT)
+        return 0;
+    return (esp8266_tx_queueLen(sock) != 0) ? 1 : 0;
 }
 
 /**
- * @brief Writes data to a socket
+ * @brief Writes data to a socket, blocks until data are sent
  * @param sock id of the socket
  * @param data pointer of data to send
  * @param size size of data in bytes
  */
 void esp8266_write_socket(uint8_t sock, char *data, uint16_t size)
 {
-    buffer_clear(&esp8266_txBuff);
-    buffer_astring(&esp8266_txBuff, "AT+CIPSEND=");
-    buffer_aint(&esp8266_txBuff, (int)sock);
-    buffer_achar(&esp8266_txBuff, ',');
-    buffer_aint(&esp8266_txBuff, (int)size);
-    buffer_astring(&esp8266_txBuff, "\r\n");
-
-    // send request
-    esp8266_send_cmddat(esp8266_txBuff.data, esp8266_txBuff.size);
-    esp8266_currentCmd = ESP8266_CMD_WRITESOCK_REQ;
-
-    while (esp8266_state != ESP8266_STATE_SEND_DATA)
-        esp8266_task();  // TODO FIXME
-    esp8266_state = ESP8266_STATE_NONE;
-
-    esp8266_send_cmddat(data, size);
-    esp8266_currentCmd = ESP8266_CMD_WRITESOCK_DATA;
-    while (esp8266_state != ESP8266_STATE_SEND_OK)
-        esp8266_task();  // TODO FIXME
+    while (esp8266_queue_socket(sock, data, size) != 0 && sock < ESP8266_SOCKET_COUNT)
+        esp8266_task();
+    while (esp8266_socket_txPending(sock))
+        esp8266_task();
 }
 
 /**
@@ -939,3 +1062,214 @@ char *esp8266_getMac(void)
 {
     return esp8266_mac;
 }
+
+#ifdef TEST_ESP8266
+#    include <assert.h>
+
+// AT emulator on the uart, answers to commands and collects socket data
+typedef enum
+{
+    TEST_AT_NORMAL = 0,
+    TEST_AT_SILENT,  ///< no answer to CIPSEND
+    TEST_AT_ERROR    ///< ERROR answer to CIPSEND
+} TEST_AT_MODE;
+static TEST_AT_MODE test_atMode = TEST_AT_NORMAL;
+static char test_rx[512];
+static size_t test_rxSize = 0;
+static char test_socketData[ESP8266_SOCKET_COUNT][8192];
+static size_t test_socketSize[ESP8266_SOCKET_COUNT];
+static uint8_t test_closed[ESP8266_SOCKET_COUNT];
+static unsigned int test_dataSocket, test_dataSize = 0;
+static unsigned int test_maxChunk = 0;
+
+static void test_answer(const char *answer)
+{
+    size_t size = strlen(answer);
+    assert(test_rxSize + size <= sizeof(test_rx));
+    memcpy(test_rx + test_rxSize, answer, size);
+    test_rxSize += size;
+}
+
+int uart_open(rt_dev_t device)
+{
+    (void)device;
+    return 0;
+}
+
+int uart_enable(rt_dev_t device)
+{
+    (void)device;
+    return 0;
+}
+
+int uart_setBaudSpeed(rt_dev_t device, uint32_t baudSpeed)
+{
+    (void)device;
+    (void)baudSpeed;
+    return 0;
+}
+
+int uart_setBitConfig(rt_dev_t device, uint8_t bitLength, uint8_t bitParity, uint8_t bitStop)
+{
+    (void)device;
+    (void)bitLength;
+    (void)bitParity;
+    (void)bitStop;
+    return 0;
+}
+
+ssize_t uart_write(rt_dev_t device, const char *data, size_t size)
+{
+    char answer[32];
+    unsigned int sock;
+    (void)device;
+
+    if (test_dataSize > 0)
+    {
+        // CIPSEND payload
+        assert(size == test_dataSize);
+        memcpy(test_socketData[test_dataSocket] + test_socketSize[test_dataSocket], data, size);
+        test_socketSize[test_dataSocket] += size;
+        test_dataSize = 0;
+        test_answer("\r\nRecv bytes\r\n\r\nSEND OK\r\n");
+    }
+    else if (strncmp(data, "AT+CIPSEND=", 11) == 0)
+    {
+        assert(sscanf(data + 11, "%u,%u", &sock, &test_dataSize) == 2);
+        if (test_atMode == TEST_AT_SILENT)
+        {
+            test_dataSize = 0;
+        }
+        else if (test_atMode == TEST_AT_ERROR)
+        {
+            test_dataSize = 0;
+            test_answer("\r\nERROR\r\n");
+        }
+        else
+        {
+            if (test_dataSize > test_maxChunk)
+            {
+                test_maxChunk = test_dataSize;
+            }
+            test_dataSocket = sock;
+            test_answer("\r\nOK\r\n> ");
+        }
+    }
+    else if (strncmp(data, "AT+CIPCLOSE=", 12) == 0)
+    {
+        sock = data[12] - '0';
+        test_closed[sock]++;
+        sprintf(answer, "%u,CLOSED\r\n\r\nOK\r\n", sock);
+        test_answer(answer);
+    }
+    else
+    {
+        test_answer("\r\nOK\r\n");
+    }
+    return size;
+}
+
+ssize_t uart_read(rt_dev_t device, char *data, size_t size_max)
+{
+    size_t size = (test_rxSize < size_max) ? test_rxSize : size_max;
+    (void)device;
+
+    memcpy(data, test_rx, size);
+    memmove(test_rx, test_rx + size, test_rxSize - size);
+    test_rxSize -= size;
+    return size;
+}
+
+// one shot soft timer, expired by the test
+static void (*test_timerHandler)(void) = NULL;
+
+int softtimer_start(SoftTimer *softTimer, void (*handler)(void), uint32_t delayUs, uint32_t periodUs)
+{
+    (void)softTimer;
+    (void)delayUs;
+    (void)periodUs;
+    test_timerHandler = handler;
+    return 0;
+}
+
+int softtimer_stop(SoftTimer *softTimer)
+{
+    (void)softTimer;
+    test_timerHandler = NULL;
+    return 0;
+}
+
+static void test_expire(void)
+{
+    void (*handler)(void) = test_timerHandler;
+    test_timerHandler = NULL;
+    if (handler != NULL)
+    {
+        handler();
+    }
+}
+
+static void test_run(void)
+{
+    int i;
+    for (i = 0; i < 200; i++)
+    {
+        esp8266_task();
+    }
+}
+
+int main(void)
+{
+    static char big[5000];
+    size_t i;
+
+    for (i = 0; i < sizeof(big); i++)
+    {
+        big[i] = 'a' + i % 26;
+    }
+
+    esp8266_init();
+    test_run();  // base configuration
+
+    // round robin of sockets, chunks limited to CIPSEND max size, close after data
+    assert(esp8266_queue_socket(0, big, sizeof(big)) == 0);
+    assert(esp8266_queue_socket(1, "hello", 5) == 0);
+    esp8266_close_socket(0);
+    esp8266_close_socket(1);
+    assert(esp8266_socket_txPending(0) && esp8266_socket_txPending(1));
+    test_run();
+    assert(!esp8266_socket_txPending(0) && !esp8266_socket_txPending(1));
+    assert(test_socketSize[0] == sizeof(big) && memcmp(test_socketData[0], big, sizeof(big)) == 0);
+    assert(test_socketSize[1] == 5 && memcmp(test_socketData[1], "hello", 5) == 0);
+    assert(test_maxChunk == ESP8266_SEND_MAX_SIZE);
+    assert(test_closed[0] == 1 && test_closed[1] == 1);
+
+    // ERROR answer drops the socket queue
+    test_atMode = TEST_AT_ERROR;
+    esp8266_queue_socket(2, "lost", 4);
+    test_run();
+    assert(!esp8266_socket_txPending(2) && test_socketSize[2] == 0);
+
+    // no answer, the socket is dropped and closed on timeout, other sockets are served again
+    test_atMode = TEST_AT_SILENT;
+    esp8266_queue_socket(3, "lost", 4);
+    test_run();
+    assert(esp8266_socket_txPending(3));
+    test_atMode = TEST_AT_NORMAL;
+    esp8266_queue_socket(4, "after", 5);
+    test_expire();
+    test_run();
+    assert(!esp8266_socket_txPending(3) && test_socketSize[3] == 0 && test_closed[3] == 1);
+    assert(!esp8266_socket_txPending(4) && test_socketSize[4] == 5);
+
+    // two +IPD packets read together are both delivered
+    test_answer("+IPD,1,4:abcd+IPD,2,2:ef");
+    esp8266_task();
+    assert(esp8266_getRec() == 1 && esp8266_getRecSocket() == 1 && memcmp(esp8266_getRecData(), "abcd", 4) == 0);
+    esp8266_task();
+    assert(esp8266_getRec() == 1 && esp8266_getRecSocket() == 2 && memcmp(esp8266_getRecData(), "ef", 2) == 0);
+
+    printf("esp8266 tx test ok\n");
+    return 0;
+}
+#endif
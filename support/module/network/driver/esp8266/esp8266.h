@@ -14,6 +14,11 @@
 
 #include <stdint.h>
 
+// max time waiting for a module response to a socket transmission or close
+#ifndef ESP8266_TX_TIMEOUT_US
+#    define ESP8266_TX_TIMEOUT_US 5000000
+#endif
+
 void esp8266_init(void);
 
 void esp8266_task(void);
@@ -42,10 +47,14 @@ int esp8266_connect_ap(char *ssid, char *pw);
 int esp8266_disconnect_ap(void);
 
 // ======== tcp/ip layer =========
+#define ESP8266_SOCKET_COUNT 5
 uint8_t esp8266_open_tcp_socket(char *ip_domain, uint16_t port);
 uint8_t esp8266_open_udp_socket(char *ip_domain, uint16_t port, uint16_t localPort);
 void esp8266_write_socket(uint8_t sock, char *data, uint16_t size);
 void esp8266_write_socket_string(uint8_t sock, char *str);
+int esp8266_queue_socket(uint8_t sock, const char *data, unsigned int size);
+uint8_t esp8266_socket_txPending(uint8_t sock);
+uint8_t esp8266_socket_isConnected(uint8_t sock);
 void esp8266_close_socket(uint8_t sock);
 
 void esp8266_server_create(uint16_t port);
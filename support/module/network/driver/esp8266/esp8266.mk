@@ -2,7 +2,8 @@
 vpath %.c $(MODULEPATH)
 vpath %.h $(MODULEPATH)
 
-DRIVERS += uart
+DRIVERS += uart timer
+SYS += packet softtimer
 
 HEADER += esp8266.h
 SRC += esp8266.c
@@ -2,12 +2,19 @@
 #define __FS_DATA_HEADER__
 
 // ======== Struct declare ========
+typedef enum
+{
+    FS_FILE_ENCODING_IDENTITY = 0,  ///< data stored as is
+    FS_FILE_ENCODING_GZIP           ///< data precompressed with gzip
+} FS_FILE_ENCODING;
+
 typedef struct
 {
     const char *name;
     const char *type;
     const char *data;
     const unsigned int size;
+    const FS_FILE_ENCODING encoding;
 } Fs_File;
 
 typedef struct
@@ -12,6 +12,9 @@
 #ifndef HTTP_H
 #define HTTP_H
 
+#include <stddef.h>
+#include <stdint.h>
+
 // http querry parser
 typedef enum
 {
@@ -36,6 +39,67 @@ typedef struct
 void http_parse_init(HTTP_PARSER *parser, char *querry_str);
 HTTP_QUERRY_TYPE http_parse_querry(HTTP_PARSER *parser, char *url);
 int http_parse_field(HTTP_PARSER *parser, char *name, char *value);
+int http_parse_accept_encoding(HTTP_PARSER *parser, const char *encoding);
+
+// http incremental request parser
+typedef struct
+{
+    char *ptr;
+    uint16_t size;
+} HTTP_SLICE;
+
+typedef enum
+{
+    HTTP_REQUEST_METHOD = 0,
+    HTTP_REQUEST_PATH,
+    HTTP_REQUEST_QUERY,
+    HTTP_REQUEST_VERSION,
+    HTTP_REQUEST_HEADER_START,
+    HTTP_REQUEST_HEADER_NAME,
+    HTTP_REQUEST_HEADER_SPACE,
+    HTTP_REQUEST_HEADER_VALUE,
+    HTTP_REQUEST_HEADER_SKIP,
+    HTTP_REQUEST_BODY,
+    HTTP_REQUEST_COMPLETE,  ///< request completely parsed
+    HTTP_REQUEST_ERROR      ///< malformed request or buffer too small
+} HTTP_REQUEST_STATE;
+
+struct HTTP_REQUEST_s;
+typedef struct
+{
+    const char *name;  ///< header field name, case insensitive
+    void (*handler)(struct HTTP_REQUEST_s *request, const HTTP_SLICE *value);
+} HTTP_HEADER_HANDLER;
+
+typedef struct HTTP_REQUEST_s
+{
+    char *buffer;  ///< storage of request line, selected header values and body
+    uint16_t bufferSize;
+    uint16_t len;
+    uint16_t mark;  ///< start of the token in progress
+    HTTP_REQUEST_STATE state;
+    HTTP_QUERRY_TYPE type;
+    HTTP_SLICE method;
+    HTTP_SLICE path;
+    HTTP_SLICE query;
+    HTTP_SLICE body;
+    uint32_t contentLength;
+    uint8_t keepAlive;
+    const HTTP_HEADER_HANDLER *handlers;  ///< selected headers, other headers are skipped without storage
+    uint8_t handlerCount;
+    const HTTP_HEADER_HANDLER *currentHandler;
+    void *user;
+} HTTP_REQUEST;
+
+void http_request_init(HTTP_REQUEST *request, char *buffer, uint16_t bufferSize, const HTTP_HEADER_HANDLER *handlers,
+                       uint8_t handlerCount, void *user);
+void http_request_reset(HTTP_REQUEST *request);
+size_t http_request_feed(HTTP_REQUEST *request, const char *data, size_t size);
+
+char *http_slice_str(HTTP_SLICE *slice);
+void http_slice_urlDecode(HTTP_SLICE *slice);
+int http_slice_hasToken(const HTTP_SLICE *slice, const char *token);
+uint16_t http_slice_tokenQuality(const HTTP_SLICE *slice, const char *token);
 
 // http formater
 enum
@@ -57,6 +121,7 @@ enum
     HTTP_PAYMENT_REQUIRED = 402,
     HTTP_NOT_FOUND = 404,
     HTTP_FORBIDDEN = 403,
+    HTTP_NOT_ACCEPTABLE = 406,
     HTTP_REQUEST_TIMEOUT = 408,
     HTTP_INTERNAL_SERVER_ERROR = 500,
     HTTP_NOT_IMPLEMENTED = 501,  // used for unrecognized requests
@@ -66,6 +131,7 @@ enum
 
 void http_write_header_code(char *buffer, int result_code);
 void http_write_content_type(char *buffer, const char *content_type);
+void http_write_content_encoding(char *buffer, const char *content_encoding);
 void http_write_content_length(char *buffer, unsigned int content_length);
 void http_write_header_end(char *buffer);
 
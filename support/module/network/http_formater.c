@@ -31,6 +31,10 @@ void http_write_header_code(char *buffer, int result_code)
             strcat(buffer, "404 Not Found\r\n");
             break;
 
+        case HTTP_NOT_ACCEPTABLE:
+            strcat(buffer, "406 Not Acceptable\r\n");
+            break;
+
         default:
             break;
     }
@@ -43,10 +47,27 @@ void http_write_content_type(char *buffer, const char *content_type)
     strcat(buffer, "\r\n");
 }
 
+void http_write_content_encoding(char *buffer, const char *content_encoding)
+{
+    strcat(buffer, "Content-Encoding: ");
+    strcat(buffer, content_encoding);
+    strcat(buffer, "\r\n");
+}
+
 void http_write_content_length(char *buffer, unsigned int content_length)
 {
+    char digits[11];
+    char *ptr = digits + sizeof(digits) - 1;
+
+    *ptr = 0;
+    do
+    {
+        *(--ptr) = '0' + (content_length % 10);
+        content_length /= 10;
+    } while (content_length > 0);
+
     strcat(buffer, "Content-Length: ");
-    // strcat(buffer, content_length);
+    strcat(buffer, ptr);
     strcat(buffer, "\r\n");
 }
 
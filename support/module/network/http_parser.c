@@ -11,10 +11,26 @@
 
 #include "http.h"
 
+#include <ctype.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
+static int http_strncasecmp(const char *str1, const char *str2, size_t n)
+{
+    while (n-- > 0)
+    {
+        int diff = tolower((unsigned char)*str1) - tolower((unsigned char)*str2);
+        if (diff != 0 || *str1 == 0)
+        {
+            return diff;
+        }
+        str1++;
+        str2++;
+    }
+    return 0;
+}
+
 void http_parse_init(HTTP_PARSER *parser, char *querry_str)
 {
     parser->querry_str = querry_str;
@@ -117,7 +133,6 @@ HTTP_QUERRY_TYPE http_parse_querry(HTTP_PARSER *parser, char *url)
 
     parser->type = type;
     parser->ptr = pt_end_line + 2;
-    puts(parser->ptr);
     return type;
 }
 
@@ -158,9 +173,667 @@ int http_parse_field(HTTP_PARSER *parser, char *name, char *value)
     return 0;
 }
 
+int http_parse_accept_encoding(HTTP_PARSER *parser, const char *encoding)
+{
+    char *pt_line, *pt_end_line;
+    HTTP_SLICE value;
+
+    if (parser->ptr == parser->querry_str)
+    {
+        return 0;
+    }
+
+    // look for Accept-Encoding field in the remaining header lines
+    pt_line = parser->ptr;
+    while ((pt_end_line = strstr(pt_line, "\r\n")) != NULL && pt_end_line != pt_line)
+    {
+        if (http_strncasecmp(pt_line, "Accept-Encoding:", 16) == 0)
+        {
+            value.ptr = pt_line + 16;
+            value.size = pt_end_line - value.ptr;
+            return http_slice_tokenQuality(&value, encoding) > 0;
+        }
+        pt_line = pt_end_line + 2;
+    }
+    return 0;
+}
+
+// ======== incremental request parser ========
+static void http_request_contentLength(HTTP_REQUEST *request, const HTTP_SLICE *value)
+{
+    uint16_t i;
+    request->contentLength = 0;
+    for (i = 0; i < value->size; i++)
+    {
+        if (value->ptr[i] < '0' || value->ptr[i] > '9')
+        {
+            request->state = HTTP_REQUEST_ERROR;
+            return;
+        }
+        if (request->contentLength > request->bufferSize)
+        {
+            request->state = HTTP_REQUEST_ERROR;  // body too large, also prevents overflow
+            return;
+        }
+        request->contentLength = request->contentLength * 10 + (value->ptr[i] - '0');
+    }
+}
+
+static void http_request_connection(HTTP_REQUEST *request, const HTTP_SLICE *value)
+{
+    if (http_slice_hasToken(value, "close"))
+    {
+        request->keepAlive = 0;
+    }
+    else if (http_slice_hasToken(value, "keep-alive"))
+    {
+        request->keepAlive = 1;
+    }
+}
+
+static void http_request_transferEncoding(HTTP_REQUEST *request, const HTTP_SLICE *value)
+{
+    (void)value;
+    request->state = HTTP_REQUEST_ERROR;  // chunked body is not supported
+}
+
+static const HTTP_HEADER_HANDLER http_request_handlers[] = {
+    {"Content-Length", http_request_contentLength},
+    {"Connection", http_request_connection},
+    {"Transfer-Encoding", http_request_transferEncoding},
+};
+
+/**
+ * @brief Initialises an incremental HTTP request parser
+ * @param request parser to initialise
+ * @param buffer storage for request line, selected header values and body
+ * @param bufferSize size of buffer in bytes
+ * @param handlers table of header handlers, called when the header value is complete
+ * @param handlerCount number of handlers
+ * @param user user pointer, stored in request
+ */
+void http_request_init(HTTP_REQUEST *request, char *buffer, uint16_t bufferSize, const HTTP_HEADER_HANDLER *handlers,
+                       uint8_t handlerCount, void *user)
+{
+    request->buffer = buffer;
+    request->bufferSize = bufferSize;
+    request->handlers = handlers;
+    request->handlerCount = handlerCount;
+    request->user = user;
+    http_request_reset(request);
+}
+
+/**
+ * @brief Resets parser to receive a new request, on the same connection or a new one
+ * @param request parser to reset
+ */
+void http_request_reset(HTTP_REQUEST *request)
+{
+    request->len = 0;
+    request->mark = 0;
+    request->state = HTTP_REQUEST_METHOD;
+    request->type = HTTP_QUERRY_TYPE_ERROR;
+    request->method.ptr = NULL;
+    request->method.size = 0;
+    request->path = request->method;
+    request->query = request->method;
+    request->body = request->method;
+    request->contentLength = 0;
+    request->keepAlive = 0;
+    request->currentHandler = NULL;
+}
+
+static int http_request_store(HTTP_REQUEST *request, char c)
+{
+    // last byte is kept to allow 0 termination of any slice
+    if (request->len >= request->bufferSize - 1)
+    {
+        request->state = HTTP_REQUEST_ERROR;
+        return -1;
+    }
+    request->buffer[request->len++] = c;
+    return 0;
+}
+
+static void http_request_slice(HTTP_REQUEST *request, HTTP_SLICE *slice)
+{
+    slice->ptr = request->buffer + request->mark;
+    slice->size = request->len - request->mark;
+    http_request_store(request, 0);  // separator, keeps room for http_slice_str of this slice
+    request->mark = request->len;
+}
+
+static HTTP_QUERRY_TYPE http_request_type(const HTTP_SLICE *method)
+{
+    static const char *const methods[] = {"CONNECT", "DELETE", "GET", "HEAD", "OPTIONS", "POST", "PUT", "TRACE"};
+    uint8_t i;
+
+    for (i = 0; i < sizeof(methods) / sizeof(methods[0]); i++)
+    {
+        if (strlen(methods[i]) == method->size && strncmp(methods[i], method->ptr, method->size) == 0)
+        {
+            return (HTTP_QUERRY_TYPE)(HTTP_QUERRY_TYPE_CONNECT + i);
+        }
+    }
+    return HTTP_QUERRY_TYPE_ERROR;
+}
+
+static const HTTP_HEADER_HANDLER *http_request_findHandler(HTTP_REQUEST *request, const char *name, uint16_t size)
+{
+    uint8_t i;
+
+    for (i = 0; i < sizeof(http_request_handlers) / sizeof(HTTP_HEADER_HANDLER); i++)
+    {
+        if (strlen(http_request_handlers[i].name) == size && http_strncasecmp(http_request_handlers[i].name, name, size) == 0)
+        {
+            return &http_request_handlers[i];
+        }
+    }
+    for (i = 0; i < request->handlerCount; i++)
+    {
+        if (strlen(request->handlers[i].name) == size && http_strncasecmp(request->handlers[i].name, name, size) == 0)
+        {
+            return &request->handlers[i];
+        }
+    }
+    return NULL;
+}
+
+static void http_request_headersEnd(HTTP_REQUEST *request)
+{
+    request->mark = request->len;
+    request->body.ptr = request->buffer + request->len;
+    request->body.size = 0;
+    if (request->contentLength > 0)
+    {
+        if (request->contentLength > (uint32_t)(request->bufferSize - 1 - request->len))
+        {
+            request->state = HTTP_REQUEST_ERROR;  // body too large
+            return;
+        }
+        request->state = HTTP_REQUEST_BODY;
+    }
+    else
+    {
+        request->state = HTTP_REQUEST_COMPLETE;
+    }
+}
+
+static void http_request_parseChar(HTTP_REQUEST *request, char c)
+{
+    HTTP_SLICE version, value;
+
+    switch (request->state)
+    {
+        case HTTP_REQUEST_METHOD:
+            if (c == ' ')
+            {
+                http_request_slice(request, &request->method);
+                request->type = http_request_type(&request->method);
+                request->state = (request->type == HTTP_QUERRY_TYPE_ERROR) ? HTTP_REQUEST_ERROR : HTTP_REQUEST_PATH;
+            }
+            else if (c >= 'A' && c <= 'Z')
+            {
+                http_request_store(request, c);
+            }
+            else
+            {
+                request->state = HTTP_REQUEST_ERROR;
+            }
+            break;
+
+        case HTTP_REQUEST_PATH:
+        case HTTP_REQUEST_QUERY:
+            if (c == ' ')
+            {
+                http_request_slice(request, (request->state == HTTP_REQUEST_PATH) ? &request->path : &request->query);
+                request->state = HTTP_REQUEST_VERSION;
+            }
+            else if (c == '?' && request->state == HTTP_REQUEST_PATH)
+            {
+                http_request_slice(request, &request->path);
+                request->state = HTTP_REQUEST_QUERY;
+            }
+            else if ((unsigned char)c <= ' ' || c == 0x7F)
+            {
+                request->state = HTTP_REQUEST_ERROR;
+            }
+            else
+            {
+                http_request_store(request, c);
+            }
+            break;
+
+        case HTTP_REQUEST_VERSION:
+            if (c == '\r')
+            {
+                break;
+            }
+            if (c != '\n')
+            {
+                if (request->len - request->mark >= 8)
+                {
+                    request->state = HTTP_REQUEST_ERROR;
+                    break;
+                }
+                http_request_store(request, c);
+                break;
+            }
+            version.ptr = request->buffer + request->mark;
+            version.size = request->len - request->mark;
+            if (request->path.size == 0 || version.size != 8 || strncmp(version.ptr, "HTTP/1.", 7) != 0)
+            {
+                request->state = HTTP_REQUEST_ERROR;
+                break;
+            }
+            request->keepAlive = (version.ptr[7] != '0') ? 1 : 0;  // default persistence of HTTP/1.1
+            request->len = request->mark;                            // version is not kept
+            request->state = HTTP_REQUEST_HEADER_START;
+            break;
+
+        case HTTP_REQUEST_HEADER_START:
+            if (c == '\r')
+            {
+                break;
+            }
+            if (c == '\n')
+            {
+                http_request_headersEnd(request);
+                break;
+            }
+            request->mark = request->len;
+            request->state = HTTP_REQUEST_HEADER_NAME;
+            http_request_store(request, c);
+            break;
+
+        case HTTP_REQUEST_HEADER_NAME:
+            if (c == ':')
+            {
+                request->currentHandler
+                    = http_request_findHandler(request, request->buffer + request->mark, request->len - request->mark);
+                request->len = request->mark;  // name is not kept
+                request->state = (request->currentHandler != NULL) ? HTTP_REQUEST_HEADER_SPACE : HTTP_REQUEST_HEADER_SKIP;
+            }
+            else if (c == '\n')
+            {
+                request->len = request->mark;  // line without value, ignored
+                request->state = HTTP_REQUEST_HEADER_START;
+            }
+            else
+            {
+                http_request_store(request, c);
+            }
+            break;
+
+        case HTTP_REQUEST_HEADER_SPACE:
+            if (c == ' ' || c == '\t')
+            {
+                break;
+            }
+            request->state = HTTP_REQUEST_HEADER_VALUE;
+            // fall through
+
+        case HTTP_REQUEST_HEADER_VALUE:
+            if (c == '\r')
+            {
+                break;
+            }
+            if (c != '\n')
+            {
+                http_request_store(request, c);
+                break;
+            }
+            http_request_slice(request, &value);
+            while (value.size > 0 && (value.ptr[value.size - 1] == ' ' || value.ptr[value.size - 1] == '\t'))
+            {
+                value.size--;
+            }
+            request->state = HTTP_REQUEST_HEADER_START;
+            request->currentHandler->handler(request, &value);
+            if (request->currentHandler >= http_request_handlers
+                && request->currentHandler < http_request_handlers + sizeof(http_request_handlers) / sizeof(HTTP_HEADER_HANDLER))
+            {
+                request->len = request->mark = value.ptr - request->buffer;  // internal values are not kept
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief Feeds the parser with a new part of the request stream. Parsing is
+ * resumed where it stopped, data do not have to be kept by the caller.
+ * @param request parser
+ * @param data received data
+ * @param size size of data in bytes
+ * @return number of bytes consumed, remaining bytes belong to the next request
+ * if request->state is HTTP_REQUEST_COMPLETE
+ */
+size_t http_request_feed(HTTP_REQUEST *request, const char *data, size_t size)
+{
+    const char *ptr = data;
+    const char *end = data + size;
+
+    while (ptr < end && request->state < HTTP_REQUEST_COMPLETE)
+    {
+        if (request->state == HTTP_REQUEST_BODY)
+        {
+            // body copied in bulk, its size was checked against buffer size
+            size_t toCopy = request->contentLength - request->body.size;
+            if (toCopy > (size_t)(end - ptr))
+            {
+                toCopy = end - ptr;
+            }
+            memcpy(request->buffer + request->len, ptr, toCopy);
+            request->len += toCopy;
+            request->body.size += toCopy;
+            ptr += toCopy;
+            if (request->body.size >= request->contentLength)
+            {
+                request->mark = request->len;
+                request->state = HTTP_REQUEST_COMPLETE;
+            }
+        }
+        else if (request->state == HTTP_REQUEST_HEADER_SKIP)
+        {
+            // not selected header, skipped without storage
+            const char *endLine = memchr(ptr, '\n', end - ptr);
+            if (endLine == NULL)
+            {
+                ptr = end;
+            }
+            else
+            {
+                ptr = endLine + 1;
+                request->state = HTTP_REQUEST_HEADER_START;
+            }
+        }
+        else
+        {
+            http_request_parseChar(request, *(ptr++));
+        }
+    }
+
+    return ptr - data;
+}
+
+/**
+ * @brief Terminates in place a slice by 0 to use it as a string
+ * @param slice slice from a request
+ * @return string pointer
+ */
+char *http_slice_str(HTTP_SLICE *slice)
+{
+    if (slice->ptr == NULL)
+    {
+        return "";
+    }
+    slice->ptr[slice->size] = 0;
+    return slice->ptr;
+}
+
+/**
+ * @brief Decodes in place %XX escaped characters of an url slice
+ * @param slice slice from a request
+ */
+void http_slice_urlDecode(HTTP_SLICE *slice)
+{
+    uint16_t i, j;
+    for (i = 0, j = 0; i < slice->size; i++, j++)
+    {
+        char c = slice->ptr[i];
+        if (c == '%' && i + 2 < slice->size && isxdigit((unsigned char)slice->ptr[i + 1])
+            && isxdigit((unsigned char)slice->ptr[i + 2]))
+        {
+            char hex[3] = {slice->ptr[i + 1], slice->ptr[i + 2], 0};
+            c = (char)strtol(hex, NULL, 16);
+            i += 2;
+        }
+        slice->ptr[j] = c;
+    }
+    slice->size = j;
+}
+
+/**
+ * @brief Searches a token in a comma separated list header value, like
+ * Accept-Encoding or Connection
+ * @param slice header value
+ * @param token token to find, case insensitive
+ * @return 1 if token is in the list, 0 else
+ */
+int http_slice_hasToken(const HTTP_SLICE *slice, const char *token)
+{
+    const char *pt_value = slice->ptr;
+    const char *pt_end = slice->ptr + slice->size;
+    size_t size_token = strlen(token);
+
+    while (pt_value < pt_end)
+    {
+        while (pt_value < pt_end && (*pt_value == ' ' || *pt_value == ','))
+        {
+            pt_value++;
+        }
+        if ((size_t)(pt_end - pt_value) >= size_token && http_strncasecmp(pt_value, token, size_token) == 0
+            && (pt_value + size_token == pt_end || pt_value[size_token] == ',' || pt_value[size_token] == ';'
+                || pt_value[size_token] == ' '))
+        {
+            return 1;
+        }
+        while (pt_value < pt_end && *pt_value != ',')
+        {
+            pt_value++;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Parses a qvalue weight, "0" to "1" with up to 3 decimals
+ * @return weight in thousandths, 0 to 1000
+ */
+static uint16_t http_slice_qvalue(const char *pt_value, const char *pt_end)
+{
+    uint16_t quality, scale = 100;
+
+    if (pt_value >= pt_end || (*pt_value != '0' && *pt_value != '1'))
+    {
+        return 1000;  // malformed, ignored
+    }
+    quality = (*pt_value++ - '0') * 1000;
+    if (pt_value < pt_end && *pt_value == '.')
+    {
+        pt_value++;
+        while (pt_value < pt_end && *pt_value >= '0' && *pt_value <= '9' && scale > 0)
+        {
+            quality += (*pt_value++ - '0') * scale;
+            scale /= 10;
+        }
+    }
+    return (quality > 1000) ? 1000 : quality;
+}
+
+/**
+ * @brief Gives the weight of a token in a comma separated list header value
+ * with q parameters, like Accept-Encoding. A token without q has the weight
+ * 1, a token not listed gets the weight of "*" if present.
+ * @param slice header value
+ * @param token token to find, case insensitive
+ * @return weight in thousandths, 1000 for q=1, 0 if token is refused (q=0) or not listed
+ */
+uint16_t http_slice_tokenQuality(const HTTP_SLICE *slice, const char *token)
+{
+    const char *pt_value = slice->ptr;
+    const char *pt_end = slice->ptr + slice->size;
+    const char *pt_name;
+    size_t size_token = strlen(token);
+    size_t size_name;
+    uint16_t quality;
+    int32_t wildcard = -1;
+
+    while (pt_value < pt_end)
+    {
+        while (pt_value < pt_end && (*pt_value == ' ' || *pt_value == '\t' || *pt_value == ','))
+        {
+            pt_value++;
+        }
+        pt_name = pt_value;
+        while (pt_value < pt_end && *pt_value != ',' && *pt_value != ';' && *pt_value != ' ' && *pt_value != '\t')
+        {
+            pt_value++;
+        }
+        size_name = pt_value - pt_name;
+
+        // parameters, only q is used
+        quality = 1000;
+        while (pt_value < pt_end && *pt_value != ',')
+        {
+            if (*pt_value == ';')
+            {
+                pt_value++;
+                while (pt_value < pt_end && (*pt_value == ' ' || *pt_value == '\t'))
+                {
+                    pt_value++;
+                }
+                if (pt_end - pt_value >= 2 && (*pt_value == 'q' || *pt_value == 'Q') && pt_value[1] == '=')
+                {
+                    quality = http_slice_qvalue(pt_value + 2, pt_end);
+                }
+                continue;
+            }
+            pt_value++;
+        }
+
+        if (size_name == size_token && http_strncasecmp(pt_name, token, size_token) == 0)
+        {
+            return quality;
+        }
+        if (size_name == 1 && *pt_name == '*')
+        {
+            wildcard = quality;
+        }
+    }
+    return (wildcard < 0) ? 0 : wildcard;
+}
+
 #ifdef TEST
 #    include <assert.h>
 #    include <stdio.h>
+#    include <time.h>
+
+int test_gzip = 0;
+void test_acceptEncoding(HTTP_REQUEST *request, const HTTP_SLICE *value)
+{
+    (void)request;
+    test_gzip = http_slice_tokenQuality(value, "gzip") > 0;
+}
+const HTTP_HEADER_HANDLER test_handlers[] = {{"Accept-Encoding", test_acceptEncoding}};
+
+uint16_t test_tokenQuality(const char *value, const char *token)
+{
+    HTTP_SLICE slice;
+    slice.ptr = (char *)value;
+    slice.size = strlen(value);
+    return http_slice_tokenQuality(&slice, token);
+}
+
+void test_quality(void)
+{
+    assert(test_tokenQuality("gzip, deflate", "gzip") == 1000);
+    assert(test_tokenQuality("gzip;q=0, deflate", "gzip") == 0);
+    assert(test_tokenQuality("gzip;q=0, deflate", "deflate") == 1000);
+    assert(test_tokenQuality("deflate, gzip; q=0.5", "gzip") == 500);
+    assert(test_tokenQuality("gzip;q=1.0", "gzip") == 1000);
+    assert(test_tokenQuality("gzip;q=0.000", "gzip") == 0);
+    assert(test_tokenQuality("GZIP ;Q=0.25", "gzip") == 250);
+    assert(test_tokenQuality("br;level=3;q=0.8, gzip", "br") == 800);
+    assert(test_tokenQuality("x-gzip", "gzip") == 0);
+    assert(test_tokenQuality("", "gzip") == 0);
+    assert(test_tokenQuality("*;q=0.1", "gzip") == 100);
+    assert(test_tokenQuality("*, gzip;q=0", "gzip") == 0);
+    assert(test_tokenQuality("deflate, *;q=0", "gzip") == 0);
+}
+
+void test_request(void)
+{
+    const char querry[] = "GET /index%20r.html?a=1&b=2 HTTP/1.1\r\n\
+Host: 192.168.4.1\r\n\
+User-Agent: Mozilla/5.0 (Android 7.0; Mobile; rv:53.0) Gecko/53.0 Firefox/53.0\r\n\
+Accept-Encoding: gzip, deflate\r\n\
+Connection: keep-alive\r\n\
+\r\n\
+POST /api/led HTTP/1.0\r\n\
+Content-Length: 5\r\n\
+\r\n\
+on=1\n";
+    char buffer[128];
+    HTTP_REQUEST request;
+    size_t split, consumed;
+
+    // same result whatever the split of the stream
+    for (split = 0; split < sizeof(querry) - 1; split++)
+    {
+        http_request_init(&request, buffer, sizeof(buffer), test_handlers, 1, NULL);
+        test_gzip = 0;
+        consumed = http_request_feed(&request, querry, split);
+        consumed += http_request_feed(&request, querry + consumed, sizeof(querry) - 1 - consumed);
+        assert(request.state == HTTP_REQUEST_COMPLETE);
+        assert(request.type == HTTP_QUERRY_TYPE_GET);
+        assert(request.keepAlive == 1);
+        assert(test_gzip == 1);
+        http_slice_urlDecode(&request.path);
+        assert(strcmp(http_slice_str(&request.path), "/index r.html") == 0);
+        assert(strcmp(http_slice_str(&request.query), "a=1&b=2") == 0);
+
+        // pipelined request
+        http_request_reset(&request);
+        consumed += http_request_feed(&request, querry + consumed, sizeof(querry) - 1 - consumed);
+        assert(consumed == sizeof(querry) - 1);
+        assert(request.state == HTTP_REQUEST_COMPLETE);
+        assert(request.type == HTTP_QUERRY_TYPE_POST);
+        assert(request.keepAlive == 0);
+        assert(strcmp(http_slice_str(&request.body), "on=1\n") == 0);
+    }
+
+    // path terminated before the query is read, without escapes to shorten it
+    {
+        const char plain[] = "GET /api/led?x=1 HTTP/1.1\r\n\r\n";
+        http_request_init(&request, buffer, sizeof(buffer), test_handlers, 1, NULL);
+        http_request_feed(&request, plain, sizeof(plain) - 1);
+        assert(request.state == HTTP_REQUEST_COMPLETE);
+        assert(strcmp(http_slice_str(&request.path), "/api/led") == 0);
+        assert(strcmp(http_slice_str(&request.query), "x=1") == 0);
+        assert(strcmp(http_slice_str(&request.method), "GET") == 0);
+        assert(strcmp(http_slice_str(&request.path), "/api/led") == 0);
+    }
+
+    // fuzz, parser must never write outside its buffer
+    srand(0);
+    for (split = 0; split < 100000; split++)
+    {
+        char fuzz[64];
+        size_t i, size = rand() % sizeof(fuzz);
+        memcpy(fuzz, querry, sizeof(fuzz));
+        for (i = 0; i < 4; i++)
+        {
+            fuzz[rand() % sizeof(fuzz)] = rand();
+        }
+        http_request_init(&request, buffer, 32, test_handlers, 1, NULL);
+        http_request_feed(&request, fuzz, size);
+        assert(request.len < 32);
+    }
+
+    // throughput
+    clock_t start = clock();
+    for (split = 0; split < 1000000; split++)
+    {
+        http_request_init(&request, buffer, sizeof(buffer), test_handlers, 1, NULL);
+        http_request_feed(&request, querry, sizeof(querry) - 1);
+    }
+    printf("http_request_feed: %.1f MB/s\n", (sizeof(querry) - 1) / ((double)(clock() - start) / CLOCKS_PER_SEC));
+}
+
 int main(void)
 {
     char querry[] = "GET /index%20r.html HTTP/1.1\r\n\
@@ -186,12 +859,24 @@ Cache-Control: max-age=0\r\n\
 
     assert(type == HTTP_QUERRY_TYPE_GET);
     assert(strcmp(url, "/index r.html") == 0);
+    assert(http_parse_accept_encoding(&parser, "gzip") == 1);
+    assert(http_parse_accept_encoding(&parser, "deflate") == 1);
+    assert(http_parse_accept_encoding(&parser, "br") == 0);
     while (http_parse_field(&parser, name, value) == 0)
     {
         num++;
     }
 
     assert(num == 9);
+
+    char refused[] = "GET / HTTP/1.1\r\nAccept-Encoding: gzip;q=0, deflate\r\n\r\n";
+    http_parse_init(&parser, refused);
+    assert(http_parse_querry(&parser, url) == HTTP_QUERRY_TYPE_GET);
+    assert(http_parse_accept_encoding(&parser, "gzip") == 0);
+    assert(http_parse_accept_encoding(&parser, "deflate") == 1);
+
+    test_quality();
+    test_request();
     return 0;
 };
 
@@ -28,6 +28,10 @@ endif
 $(HTMLGEN_EXE): $(UDEVKIT)/tool/htmlGen/htmlGen.cpp $(UDEVKIT)/tool/htmlGen/htmlGen.pro
 	@echo "Building htmlGen..."
 	cd $(UDEVKIT)/tool/htmlGen/ && make
+esp8266-test:
+	gcc $(NETPATH)/driver/esp8266/esp8266.c $(UDEVKIT)/support/sys/buffer.c -O2 -Wall -Wextra -I$(UDEVKIT)/include -DTEST_ESP8266 -o esp8266-test && ./esp8266-test
+	rm esp8266-test
+
 rwildcard=$(foreach d,$(wildcard $1*),$(call rwildcard,$d/,$2) $(filter $(subst *,%,$2),$d))
 
 endif
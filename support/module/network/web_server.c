@@ -15,94 +15,395 @@
 
 #include "fs_functions.h"
 
+#include "sys/packet.h"
+
 #include <string.h>
 
 #include "board.h"
 
+#ifndef WEB_SERVER_REQUEST_SIZE
+#    define WEB_SERVER_REQUEST_SIZE 256
+#endif
+
+// per socket request parser
+typedef struct
+{
+    HTTP_REQUEST request;
+    char buffer[WEB_SERVER_REQUEST_SIZE];
+    uint8_t acceptGzip;
+    uint8_t respond;  ///< request parsed, its response waits for the socket and buffers to be free
+    uint16_t backlogSize;
+    char *backlog;  ///< data received while a response waits, pipelined requests, packet buffer
+} Web_Server_Client;
+Web_Server_Client web_server_clients[ESP8266_SOCKET_COUNT];
+HTTP_REQUEST *web_server_currentRequest = NULL;
+
 char web_server_buffer[2048];
+uint8_t web_server_bufferSock = 0xFF;  // socket using web_server_buffer for a REST response
+char web_server_headers[ESP8266_SOCKET_COUNT][160];
 void (*web_server_restApi)(char *restUrl, HTTP_QUERRY_TYPE querry_type, char *buffer) = NULL;
 
 const Fs_FilesList *web_server_file_list = NULL;
 
+void web_server_acceptEncoding(HTTP_REQUEST *request, const HTTP_SLICE *value)
+{
+    // gzip;q=0 refuses gzip
+    ((Web_Server_Client *)request->user)->acceptGzip = http_slice_tokenQuality(value, "gzip") > 0;
+}
+
+const HTTP_HEADER_HANDLER web_server_headerHandlers[] = {
+    {"Accept-Encoding", web_server_acceptEncoding},
+};
+
 void web_server_init(void)
 {
-    // services init
+    uint8_t sock;
+
+    for (sock = 0; sock < ESP8266_SOCKET_COUNT; sock++)
+    {
+        Web_Server_Client *client = &web_server_clients[sock];
+        http_request_init(&client->request, client->buffer, WEB_SERVER_REQUEST_SIZE, web_server_headerHandlers,
+                          sizeof(web_server_headerHandlers) / sizeof(HTTP_HEADER_HANDLER), client);
+        client->acceptGzip = 0;
+        client->respond = 0;
+        client->backlogSize = 0;
+        client->backlog = NULL;
+    }
 }
 
-void web_server_task(void)
+/**
+ * @brief Internal function to queue a header only response and close the socket
+ * @param sock id of the socket
+ * @param code HTTP result code
+ */
+void web_server_sendCode(uint8_t sock, int code)
+{
+    char *header = web_server_headers[sock];
+
+    http_write_header_code(header, code);
+    http_write_header_end(header);
+    esp8266_queue_socket(sock, header, strlen(header));
+    esp8266_close_socket(sock);
+}
+
+/**
+ * @brief Internal function to know if a parsed request is handled by the REST API
+ * @param request complete request, with its path decoded
+ * @return 1 if REST request, 0 else
+ */
+uint8_t web_server_isRest(const HTTP_REQUEST *request)
 {
-    if (esp8266_getRec() != 1)
+    if (web_server_restApi == NULL || request->path.size < 5)
     {
-        return;
+        return 0;
+    }
+    return (strncmp(request->path.ptr, "/api/", 5) == 0) ? 1 : 0;
+}
+
+/**
+ * @brief Internal function to insert the Content-Length of the body in a REST
+ * response, to delimit it without closing the connection
+ * @param buffer complete REST response, header and body
+ * @return size of the response, 0 if the length can not be inserted
+ */
+size_t web_server_restLength(char *buffer)
+{
+    char length[32] = "";
+    size_t size = strlen(buffer);
+    size_t lengthSize;
+    char *headerEnd;
+
+    if (strstr(buffer, "Content-Length:") != NULL)
+    {
+        return size;  // already given by REST API
+    }
+
+    headerEnd = strstr(buffer, "\r\n\r\n");
+    if (headerEnd == NULL)
+    {
+        // header without end, response has no body
+        if (strncmp(buffer, "HTTP/", 5) != 0)
+        {
+            return 0;
+        }
+        if (strcmp(buffer + size - 2, "\r\n") != 0)
+        {
+            return 0;
+        }
+        headerEnd = buffer + size;
+        http_write_content_length(length, 0);
+        http_write_header_end(length);
+    }
+    else
+    {
+        headerEnd += 2;  // length is inserted before the empty line
+        http_write_content_length(length, size - (headerEnd + 2 - buffer));
+    }
+
+    lengthSize = strlen(length);
+    if (size + lengthSize >= sizeof(web_server_buffer))
+    {
+        return 0;
+    }
+    memmove(headerEnd + lengthSize, headerEnd, size - (headerEnd - buffer) + 1);
+    memcpy(headerEnd, length, lengthSize);
+    return size + lengthSize;
+}
+
+/**
+ * @brief Internal function to know if the response of a parsed request can be
+ * queued now, without waiting for buffers in use by previous responses
+ * @param sock id of the socket
+ * @param client client context with the parsed request
+ * @return 1 if response can be queued, 0 else
+ */
+uint8_t web_server_canRespond(uint8_t sock, Web_Server_Client *client)
+{
+    // previous response on this socket still uses its header buffer
+    if (esp8266_socket_txPending(sock))
+    {
+        return 0;
     }
+    // REST buffer is shared by sockets
+    if (client->request.state == HTTP_REQUEST_COMPLETE && web_server_isRest(&client->request)
+        && web_server_bufferSock != 0xFF && esp8266_socket_txPending(web_server_bufferSock))
+    {
+        return 0;
+    }
+    return 1;
+}
 
-    unsigned char sock = esp8266_getRecSocket();
-    char *querry = esp8266_getRecData();
-    HTTP_PARSER parser;
-    char url[50];
+/**
+ * @brief Internal function to answer a parsed request, socket and buffers
+ * have to be free (web_server_canRespond)
+ * @param sock id of the socket
+ * @param client client context with the parsed request
+ * @return 1 if the connection is kept alive, 0 if socket is closed
+ */
+uint8_t web_server_respond(uint8_t sock, Web_Server_Client *client)
+{
+    HTTP_REQUEST *request = &client->request;
+    size_t size;
+    char *url;
 
-    querry[esp8266_getRecSize()] = 0;
+    if (request->state == HTTP_REQUEST_ERROR)
+    {
+        web_server_sendCode(sock, HTTP_BAD_REQUEST);
+        return 0;
+    }
 
-    http_parse_init(&parser, querry);
-    HTTP_QUERRY_TYPE type = http_parse_querry(&parser, url);
+    url = http_slice_str(&request->path);
 
-    if (type != HTTP_QUERRY_TYPE_ERROR)
+    if (web_server_isRest(request))
     {
-        if (web_server_restApi && strncmp(url, "/api/", 5) == 0)
+        web_server_bufferSock = sock;
+
+        web_server_currentRequest = request;
+        (*web_server_restApi)(url + 5, request->type, web_server_buffer);
+        web_server_currentRequest = NULL;
+
+        size = web_server_restLength(web_server_buffer);
+        if (size == 0)
         {
-            (*web_server_restApi)(url + 5, type, web_server_buffer);
-            esp8266_write_socket_string(sock, web_server_buffer);
+            // connection end delimits the response
+            esp8266_queue_socket(sock, web_server_buffer, strlen(web_server_buffer));
+            esp8266_close_socket(sock);
+            return 0;
         }
-        else
+        esp8266_queue_socket(sock, web_server_buffer, size);
+        if (request->keepAlive == 0)
         {
-            const Fs_File *file;
+            esp8266_close_socket(sock);
+        }
+        return request->keepAlive;
+    }
 
-            if (strcmp(url, "/") == 0)
-            {
-                file = getFile(web_server_file_list, "index.html");
-            }
-            else
-            {
-                file = getFile(web_server_file_list, url + 1);
-            }
+    const Fs_File *file;
+    if (strcmp(url, "/") == 0)
+    {
+        file = getFile(web_server_file_list, "index.html");
+    }
+    else
+    {
+        file = getFile(web_server_file_list, url + 1);
+    }
+
+    if (file == NULL)  // search in fs
+    {
+        web_server_sendCode(sock, HTTP_NOT_FOUND);
+        return 0;
+    }
+    if (file->encoding == FS_FILE_ENCODING_GZIP && client->acceptGzip == 0)
+    {
+        // precompressed file can not be served to this client
+        web_server_sendCode(sock, HTTP_NOT_ACCEPTABLE);
+        return 0;
+    }
+
+    char *header = web_server_headers[sock];
+    http_write_header_code(header, HTTP_OK);
+
+    // content type
+    http_write_content_type(header, file->type);
+    if (file->encoding == FS_FILE_ENCODING_GZIP)
+    {
+        http_write_content_encoding(header, "gzip");
+    }
+    http_write_content_length(header, file->size);
+
+    // end of header
+    http_write_header_end(header);
+
+    // header and file content are sent from their place, without copy
+    esp8266_queue_socket(sock, header, strlen(header));
+    if (request->type != HTTP_QUERRY_TYPE_HEAD)
+    {
+        esp8266_queue_socket(sock, file->data, file->size);
+    }
+    if (request->keepAlive == 0)
+    {
+        esp8266_close_socket(sock);
+    }
+    return request->keepAlive;
+}
+
+/**
+ * @brief Internal function to parse received data until a request is complete
+ * @param client client context
+ * @param data received data
+ * @param size size of data in bytes
+ * @return number of bytes consumed, remaining bytes belong to the next requests
+ */
+size_t web_server_parse(Web_Server_Client *client, const char *data, size_t size)
+{
+    size_t consumed = http_request_feed(&client->request, data, size);
+
+    if (client->request.state == HTTP_REQUEST_COMPLETE)
+    {
+        http_slice_urlDecode(&client->request.path);
+        client->respond = 1;
+    }
+    else if (client->request.state == HTTP_REQUEST_ERROR)
+    {
+        client->respond = 1;
+    }
+    return consumed;
+}
+
+/**
+ * @brief Internal function to give back the backlog packet of a client
+ * @param client client context
+ */
+void web_server_dropBacklog(Web_Server_Client *client)
+{
+    packet_free(client->backlog);
+    client->backlog = NULL;
+    client->backlogSize = 0;
+}
+
+/**
+ * @brief Internal function to keep received data until the waiting response is queued
+ * @param client client context
+ * @param data received data
+ * @param size size of data in bytes
+ */
+void web_server_keep(Web_Server_Client *client, const char *data, size_t size)
+{
+    if (client->request.keepAlive == 0)
+    {
+        return;  // connection is closed after the waiting response
+    }
+    if (client->backlog == NULL)
+    {
+        client->backlog = packet_alloc();
+    }
+    if (client->backlog == NULL || client->backlogSize + size > PACKET_SIZE)
+    {
+        // too much pipelined data, connection is closed after the waiting response, client retries the others
+        client->request.keepAlive = 0;
+        web_server_dropBacklog(client);
+        return;
+    }
+    memcpy(client->backlog + client->backlogSize, data, size);
+    client->backlogSize += size;
+}
+
+/**
+ * @brief Internal function to queue the waiting response of a socket if it can
+ * be queued, and to parse the next pipelined request
+ * @param sock id of the socket
+ */
+void web_server_serve(uint8_t sock)
+{
+    Web_Server_Client *client = &web_server_clients[sock];
+    uint8_t keepAlive;
+    size_t consumed;
+
+    if (client->respond == 0 || web_server_canRespond(sock, client) == 0)
+    {
+        return;
+    }
+
+    keepAlive = web_server_respond(sock, client);
+    http_request_reset(&client->request);
+    client->acceptGzip = 0;
+    client->respond = 0;
+    if (keepAlive == 0 || client->backlog == NULL)
+    {
+        web_server_dropBacklog(client);
+        return;
+    }
 
-            if (file == NULL)  // search in fs
+    consumed = web_server_parse(client, client->backlog, client->backlogSize);
+    memmove(client->backlog, client->backlog + consumed, client->backlogSize - consumed);
+    client->backlogSize -= consumed;
+    if (client->backlogSize == 0)
+    {
+        web_server_dropBacklog(client);
+    }
+}
+
+void web_server_task(void)
+{
+    uint8_t sock;
+
+    if (esp8266_getRec() == 1)
+    {
+        sock = esp8266_getRecSocket();
+        if (sock < ESP8266_SOCKET_COUNT)
+        {
+            // packet buffer is reused by the next packet, data are parsed or kept now
+            Web_Server_Client *client = &web_server_clients[sock];
+            const char *data = esp8266_getRecData();
+            size_t size = esp8266_getRecSize();
+            size_t consumed = 0;
+
+            if (client->respond == 0)
             {
-                http_write_header_code(web_server_buffer, HTTP_NOT_FOUND);
-                http_write_header_end(web_server_buffer);
-                esp8266_write_socket_string(sock, web_server_buffer);
+                consumed = web_server_parse(client, data, size);
             }
-            else
+            if (consumed < size)
             {
-                unsigned int idData = 0, start;
-                http_write_header_code(web_server_buffer, HTTP_OK);
-
-                // content type
-                http_write_content_type(web_server_buffer, file->type);
-
-                // end of header
-                http_write_header_end(web_server_buffer);
-                start = strlen(web_server_buffer);
-
-                while (idData + 2048 < file->size)
-                {
-                    memcpy(web_server_buffer + start, file->data + idData, 2048 - start);
-                    esp8266_write_socket(sock, web_server_buffer, 2048);
-                    idData += 2048 - start;
-                    start = 0;
-                }
-                memcpy(web_server_buffer + start, file->data + idData, file->size - idData);
-                esp8266_write_socket(sock, web_server_buffer, file->size - idData + start);
+                web_server_keep(client, data + consumed, size - consumed);
             }
         }
     }
-    else
+
+    // responses are queued when socket and buffers are free, this task never waits for them
+    for (sock = 0; sock < ESP8266_SOCKET_COUNT; sock++)
     {
-        http_write_header_code(web_server_buffer, HTTP_BAD_REQUEST);
-        http_write_header_end(web_server_buffer);
-        esp8266_write_socket_string(sock, web_server_buffer);
+        web_server_serve(sock);
     }
-    esp8266_close_socket(sock);
+}
+
+/**
+ * @brief Gives the request currently handled by the REST API callback, to access
+ * its query string or its body
+ * @return current request, NULL outside of REST API callback
+ */
+const HTTP_REQUEST *web_server_getRequest(void)
+{
+    return web_server_currentRequest;
 }
 
 void web_server_setRestApi(void (*restApi)(char *url, HTTP_QUERRY_TYPE code, char *buffer))
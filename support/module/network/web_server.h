@@ -21,5 +21,6 @@ void web_server_task(void);
 
 void web_server_setRestApi(void (*restApi)(char *url, HTTP_QUERRY_TYPE code, char *buffer));
 void web_server_setRootFS(const Fs_FilesList *file_list);
+const HTTP_REQUEST *web_server_getRequest(void);
 
 #endif  // WEB_SERVER_H
@@ -0,0 +1,222 @@
+/**
+ * @file prof.c
+ * @author agent
+ * @copyright UniSwarm 2026
+ *
+ * @date October 19, 2026, 08:40 PM
+ *
+ * @brief Hot path profiler with per region cycle statistics
+ */
+
+#include "prof.h"
+
+#include <archi.h>
+#include <driver/sysclock.h>
+
+#include <string.h>
+
+#if defined(SIMULATOR)
+#    include <time.h>
+#elif defined(ARCHI_dspic33ch) || defined(ARCHI_dspic33ck)
+#    include <driver/ccp.h>
+static rt_dev_t prof_ccp = NULLDEV;
+#elif defined(ARCHI_pic24ep) || defined(ARCHI_pic24f) || defined(ARCHI_pic24fj) || defined(ARCHI_pic24hj)              \
+    || defined(ARCHI_dspic30f) || defined(ARCHI_dspic33fj) || defined(ARCHI_dspic33ep) || defined(ARCHI_dspic33ev)
+#    include <driver/timer.h>
+#    define PROF_TIMER_T32
+#endif
+
+#ifdef SIMULATOR
+#    include <pthread.h>
+static pthread_mutex_t prof_mutex = PTHREAD_MUTEX_INITIALIZER;
+#    define prof_lock(state)                                                                                           \
+        do                                                                                                             \
+        {                                                                                                              \
+            disable_interrupt_save(state);                                                                             \
+            pthread_mutex_lock(&prof_mutex);                                                                           \
+        } while (0)
+#    define prof_unlock(state)                                                                                         \
+        do                                                                                                             \
+        {                                                                                                              \
+            pthread_mutex_unlock(&prof_mutex);                                                                         \
+            restore_interrupt(state);                                                                                  \
+        } while (0)
+#else
+#    define prof_lock(state)   disable_interrupt_save(state)
+#    define prof_unlock(state) restore_interrupt(state)
+#endif
+
+ProfRegion prof_regions[PROF_REGION_COUNT];
+static uint32_t prof_counterFreq = 0;
+
+/**
+ * @brief Starts the free running counter and clears stats
+ * @return 0 if ok, -1 if the counter peripheral is already used
+ */
+int prof_init(void)
+{
+#if defined(SIMULATOR)
+    prof_counterFreq = 1000000000;
+#elif defined(ARCHI_dspic33ch) || defined(ARCHI_dspic33ck)
+    prof_ccp = ccp_getFreeDevice();
+    if (prof_ccp == NULLDEV)
+    {
+        return -1;
+    }
+    ccp_setMode(prof_ccp, CCP_MODE_TIMER);
+    ccp_setPeriod(prof_ccp, 0xFFFFFFFF);
+    ccp_enable(prof_ccp);
+    prof_counterFreq = sysclock_periphFreq(SYSCLOCK_CLOCK_CCP);
+#elif defined(PROF_TIMER_T32)
+    // timers 2 and 3 are reserved to be chained
+    if (timer_open(timer(2)) < 0)
+    {
+        return -1;
+    }
+    if (timer_open(timer(3)) < 0)
+    {
+        timer_close(timer(2));
+        return -1;
+    }
+    T2CON = 0;
+    T3CON = 0;
+    T2CONbits.T32 = 1;  // 32 bits mode, timer 3 is the MSB part
+    PR2 = 0xFFFF;
+    PR3 = 0xFFFF;
+    TMR3 = 0;
+    TMR2 = 0;
+    T2CONbits.TON = 1;
+    prof_counterFreq = sysclock_periphFreq(SYSCLOCK_CLOCK_TIMER);
+#else
+    prof_counterFreq = sysclock_periphFreq(SYSCLOCK_CLOCK_CPU) / 2;  // CP0 Count runs at half CPU clock
+#endif
+
+    prof_reset();
+    return 0;
+}
+
+/**
+ * @brief Names a region for the prof command
+ * @param id region id
+ * @param name region name, not copied
+ * @return 0 if ok, -1 if id is invalid
+ */
+int prof_setName(uint8_t id, const char *name)
+{
+    if (id >= PROF_REGION_COUNT)
+    {
+        return -1;
+    }
+    prof_regions[id].name = name;
+    return 0;
+}
+
+/**
+ * @brief Clears stats of all regions, names are kept
+ */
+void prof_reset(void)
+{
+    uint8_t id;
+    rt_reg_t irqState;
+
+    for (id = 0; id < PROF_REGION_COUNT; id++)
+    {
+        prof_lock(irqState);
+        prof_regions[id].count = 0;
+        prof_regions[id].min = 0xFFFFFFFF;
+        prof_regions[id].max = 0;
+        prof_regions[id].sum = 0;
+        memset(prof_regions[id].hist, 0, sizeof(prof_regions[id].hist));
+        prof_unlock(irqState);
+    }
+}
+
+/**
+ * @brief Reads the free running counter
+ */
+uint32_t prof_counter(void)
+{
+#if defined(SIMULATOR)
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint32_t)now.tv_sec * 1000000000 + now.tv_nsec;
+#elif defined(ARCHI_dspic33ch) || defined(ARCHI_dspic33ck)
+    return ccp_getValue(prof_ccp);
+#elif defined(PROF_TIMER_T32)
+    uint16_t lsw = TMR2;  // latches TMR3 in TMR3HLD
+    return ((uint32_t)TMR3HLD << 16) | lsw;
+#else
+    return _CP0_GET_COUNT();
+#endif
+}
+
+/**
+ * @brief Counter frequency in Hz
+ */
+uint32_t prof_freq(void)
+{
+    return prof_counterFreq;
+}
+
+/**
+ * @brief Converts counter ticks to nanoseconds
+ */
+uint32_t prof_ticksToNs(uint32_t ticks)
+{
+    if (prof_counterFreq == 0)
+    {
+        return 0;
+    }
+    return (uint64_t)ticks * 1000000000 / prof_counterFreq;
+}
+
+/**
+ * @brief Ends a region, use the PROF_END macro instead
+ * @param id region id
+ * @param end counter value at the end of the region
+ */
+void prof_end(uint8_t id, uint32_t end)
+{
+    ProfRegion *region = &prof_regions[id];
+    uint32_t ticks = end - region->start;
+    uint32_t scaled = ticks >> PROF_HIST_SHIFT;
+    uint8_t bin = 0;
+
+    while (scaled != 0 && bin < PROF_HIST_BINS - 1)
+    {
+        scaled >>= 1;
+        bin++;
+    }
+
+    region->count++;
+    region->sum += ticks;
+    if (ticks < region->min)
+    {
+        region->min = ticks;
+    }
+    if (ticks > region->max)
+    {
+        region->max = ticks;
+    }
+    region->hist[bin]++;
+}
+
+/**
+ * @brief Copies consistent stats of a region
+ * @param id region id
+ * @param region destination
+ * @return 0 if ok, -1 if id is invalid
+ */
+int prof_region(uint8_t id, ProfRegion *region)
+{
+    rt_reg_t irqState;
+
+    if (id >= PROF_REGION_COUNT)
+    {
+        return -1;
+    }
+    prof_lock(irqState);
+    memcpy(region, &prof_regions[id], sizeof(ProfRegion));
+    prof_unlock(irqState);
+    return 0;
+}
@@ -0,0 +1,69 @@
+/**
+ * @file prof.h
+ * @author agent
+ * @copyright UniSwarm 2026
+ *
+ * @date October 19, 2026, 08:40 PM
+ *
+ * @brief Hot path profiler with per region cycle statistics
+ *
+ * PROF_BEGIN(id) / PROF_END(id) read a free running 32 bits counter and keep
+ * count, min, max, average and a log2 histogram of the duration of the region
+ * id. Counter : CP0 Count on PIC32, timer 2/3 chained in 32 bits mode on
+ * PIC24 / dsPIC30F / dsPIC33F / dsPIC33E, a CCP in 32 bits timer mode on
+ * dsPIC33C and clock_gettime in nanoseconds on the simulator.
+ *
+ * A region must not be nested with itself, different regions can be nested
+ * and used in interrupt handlers. Stats are shown by the cmdline prof command.
+ */
+
+#ifndef PROF_H
+#define PROF_H
+
+#include <stdint.h>
+
+#ifndef PROF_REGION_COUNT
+#    define PROF_REGION_COUNT 8
+#endif
+
+// histogram bin 0 counts durations < 2^PROF_HIST_SHIFT ticks, bin n durations in [2^(PROF_HIST_SHIFT+n-1), 2^(PROF_HIST_SHIFT+n))
+#ifndef PROF_HIST_BINS
+#    define PROF_HIST_BINS 10
+#endif
+#ifndef PROF_HIST_SHIFT
+#    define PROF_HIST_SHIFT 8
+#endif
+
+typedef struct
+{
+    const char *name;
+    volatile uint32_t start;
+    uint32_t count;
+    uint32_t min;
+    uint32_t max;
+    uint64_t sum;
+    uint32_t hist[PROF_HIST_BINS];
+} ProfRegion;
+
+int prof_init(void);
+int prof_setName(uint8_t id, const char *name);
+void prof_reset(void);
+
+uint32_t prof_counter(void);
+uint32_t prof_freq(void);
+uint32_t prof_ticksToNs(uint32_t ticks);
+
+void prof_end(uint8_t id, uint32_t end);
+int prof_region(uint8_t id, ProfRegion *region);
+
+extern ProfRegion prof_regions[PROF_REGION_COUNT];
+
+#ifndef PROF_DISABLE
+#    define PROF_BEGIN(id) prof_regions[(id)].start = prof_counter()
+#    define PROF_END(id)   prof_end((id), prof_counter())
+#else
+#    define PROF_BEGIN(id)
+#    define PROF_END(id)
+#endif
+
+#endif  // PROF_H
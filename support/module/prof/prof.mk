@@ -0,0 +1,19 @@
+ifndef PROF_MODULE
+PROF_MODULE=
+
+vpath %.c $(MODULEPATH)
+vpath %.h $(MODULEPATH)
+
+SRC += prof.c
+HEADER += prof.h
+
+# free running 32 bits counter, CP0 Count on PIC32
+ifeq ($(ARCHI),$(filter $(ARCHI),pic24ep dspic33ep dspic33ev pic24f pic24fj pic24hj dspic33fj dspic30f))
+ DRIVERS += timer
+endif
+ifeq ($(ARCHI),$(filter $(ARCHI),dspic33ch dspic33ck))
+ DRIVERS += ccp
+endif
+DRIVERS += sysclock
+
+endif
@@ -40,6 +40,7 @@ $(OUT_PWD)/modules.h : $(firstword $(MAKEFILE_LIST))
 	@printf "\n// defines use of modules and drivers\n\
 $(subst $(space),\n,$(foreach DRIVER,$(sort $(DRIVERS)),#define USE_$(DRIVER)\n))\n\
 $(subst $(space),\n,$(foreach MODULE,$(sort $(MODULES)),#define USE_MODULE_$(MODULE)\n))\n\
+$(subst $(space),\n,$(foreach SYSFILE,$(sort $(SYS)),#define USE_SYS_$(SYSFILE)\n))\n\
 // include all modules and drivers in project\n\
 $(subst $(space),\n,$(foreach DRIVER,$(sort $(DRIVERS)),#include \"driver/$(DRIVER).h\"\n))\n\
 $(subst $(space),\n,$(foreach MODULE,$(sort $(MODULES)),#include \"module/$(MODULE).h\"\n))\n\
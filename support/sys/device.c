@@ -74,3 +74,223 @@ ssize_t device_read(rt_dev_t device, char *data, size_t size_max)
             return 0;
     }
 }
+
+/**
+ * @brief Checks that all written data left the device transmit fifo
+ * @return 1 if finished, 0 if not, -1 if the device class does not support it
+ */
+int device_transmitFinished(rt_dev_t device)
+{
+    switch (MAJOR(device))
+    {
+#ifdef USE_uart
+        case DEV_CLASS_UART:
+            return uart_transmitFinished(device);
+#endif
+#ifdef USE_spi
+        case DEV_CLASS_SPI:
+            return 1;  // spi_write is synchronous
+#endif
+#ifdef USE_usb_serial
+        case DEV_CLASS_USB_SERIAL:
+            return usb_serial_transmitFinished(device);
+#endif
+        default:
+            return -1;
+    }
+}
+
+/**
+ * @brief Writes several buffers in order without copying them in one buffer
+ * @param device device to write to
+ * @param iov array of buffers
+ * @param iovCount number of buffers
+ * @return number of bytes written, stops at the first buffer partially written, -1 in case of error
+ */
+ssize_t device_writev(rt_dev_t device, const DeviceIovec *iov, uint8_t iovCount)
+{
+    uint8_t i;
+    ssize_t written;
+    ssize_t total = 0;
+
+    for (i = 0; i < iovCount; i++)
+    {
+        written = device_write(device, iov[i].data, iov[i].size);
+        if (written < 0)
+        {
+            return (total > 0) ? total : -1;
+        }
+        total += written;
+        if ((size_t)written < iov[i].size)
+        {
+            break;
+        }
+    }
+    return total;
+}
+
+// pending asynchronous requests, in submission order
+static DeviceRequest *device_requests = NULL;
+
+static int device_requestBlocked(const DeviceRequest *request);
+static void device_requestWrite(DeviceRequest *request);
+
+/**
+ * @brief Writes one buffer asynchronously, see device_writevAsync
+ */
+int device_writeAsync(DeviceRequest *request,
+                      rt_dev_t device,
+                      const char *data,
+                      size_t size,
+                      void (*callback)(DeviceRequest *request))
+{
+    request->buffer.data = data;
+    request->buffer.size = size;
+    return device_writevAsync(request, device, &request->buffer, 1, callback);
+}
+
+/**
+ * @brief Queues buffers to write and returns immediately, buffers are written by device_task
+ *
+ * Requests to the same device are written in submission order. The callback
+ * is called by device_task when all data left the device transmit fifo, or
+ * after a write error with request->written set to -1. Request and buffers
+ * must stay valid until then. Not callable from interrupt handlers.
+ *
+ * @param request request storage
+ * @param device device to write to
+ * @param iov array of buffers
+ * @param iovCount number of buffers
+ * @param callback completion callback, can be NULL
+ * @return 0 if ok, -1 if the device class does not support it or the request is already pending
+ */
+int device_writevAsync(DeviceRequest *request,
+                       rt_dev_t device,
+                       const DeviceIovec *iov,
+                       uint8_t iovCount,
+                       void (*callback)(DeviceRequest *request))
+{
+    DeviceRequest **link;
+
+    if (device_transmitFinished(device) < 0)
+    {
+        return -1;
+    }
+    for (link = &device_requests; *link != NULL; link = &(*link)->next)
+    {
+        if (*link == request)
+        {
+            return -1;
+        }
+    }
+
+    request->next = NULL;
+    request->iov = iov;
+    request->iovCount = iovCount;
+    request->iovId = 0;
+    request->offset = 0;
+    request->written = 0;
+    request->device = device;
+    request->callback = callback;
+    request->pending = 1;
+
+    *link = request;
+
+    // starts writing now, completion is handled by device_task
+    if (!device_requestBlocked(request))
+    {
+        device_requestWrite(request);
+    }
+    return 0;
+}
+
+/**
+ * @brief Checks if an asynchronous request is still pending
+ * @return 1 if pending, 0 once its callback was called
+ */
+int device_isPending(const DeviceRequest *request)
+{
+    return request->pending;
+}
+
+/**
+ * @brief Checks if data of a previous request to the same device are not all queued
+ */
+static int device_requestBlocked(const DeviceRequest *request)
+{
+    const DeviceRequest *previous;
+
+    for (previous = device_requests; previous != request; previous = previous->next)
+    {
+        if (previous->device == request->device && previous->iovId < previous->iovCount)
+        {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Pushes as much request data as the device accepts without blocking
+ */
+static void device_requestWrite(DeviceRequest *request)
+{
+    const DeviceIovec *iov;
+    ssize_t written;
+
+    while (request->iovId < request->iovCount)
+    {
+        iov = &request->iov[request->iovId];
+        written = device_write(request->device, iov->data + request->offset, iov->size - request->offset);
+        if (written < 0)
+        {
+            request->written = -1;
+            request->iovId = request->iovCount;
+            return;
+        }
+        request->written += written;
+        request->offset += written;
+        if (request->offset < iov->size)
+        {
+            return;  // device transmit fifo full
+        }
+        request->offset = 0;
+        request->iovId++;
+    }
+}
+
+/**
+ * @brief Makes asynchronous requests progress and calls completion callbacks, to call in the main loop
+ */
+void device_task(void)
+{
+    DeviceRequest **link = &device_requests;
+    DeviceRequest *request;
+
+    while (*link != NULL)
+    {
+        request = *link;
+
+        // waits for the data of previous requests to the same device to be queued
+        if (device_requestBlocked(request))
+        {
+            link = &request->next;
+            continue;
+        }
+
+        device_requestWrite(request);
+        if (request->iovId < request->iovCount
+            || (request->written >= 0 && device_transmitFinished(request->device) == 0))
+        {
+            link = &request->next;
+            continue;
+        }
+
+        *link = request->next;
+        request->pending = 0;
+        if (request->callback != NULL)
+        {
+            request->callback(request);
+        }
+    }
+}
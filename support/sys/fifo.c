@@ -104,6 +104,32 @@ size_t fifo_pop(Fifo *fifo, char *data, size_t max_size)
     return len;
 }
 
+// gives the contiguous part of the data to read, without popping it
+size_t fifo_span(Fifo *fifo, const char **data)
+{
+    size_t len = fifo_len(fifo);
+    size_t tail = fifo->tail & fifo->mask;
+
+    *data = fifo->data + tail;
+    if (tail + len > fifo->size)
+    {
+        len = fifo->size - tail;
+    }
+    return len;
+}
+
+// pops data without copy, after a fifo_span
+size_t fifo_drop(Fifo *fifo, size_t size)
+{
+    size_t len = fifo_len(fifo);
+    if (len > size)
+    {
+        len = size;
+    }
+    fifo->tail = (fifo->tail + len) & fifo->mask;
+    return len;
+}
+
 #define fifo_push_str(ff, str) fifo_push(ff, str, strlen(str))
 
 #ifdef TEST_FIFO
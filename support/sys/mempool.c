@@ -0,0 +1,301 @@
+/**
+ * @file mempool.c
+ * @author agent
+ * @copyright UniSwarm 2026
+ *
+ * @date October 19, 2026, 07:15 PM
+ *
+ * @brief Fixed block memory pool
+ */
+
+#include "sys/mempool.h"
+
+#include <string.h>
+
+#ifndef TEST_MEMPOOL
+#    include <archi.h>
+#endif
+
+#ifdef SIMULATOR
+#    include <pthread.h>
+static pthread_mutex_t mempool_mutex = PTHREAD_MUTEX_INITIALIZER;
+#    define mempool_lock(state)                                                                                        \
+        do                                                                                                             \
+        {                                                                                                              \
+            disable_interrupt_save(state);                                                                             \
+            pthread_mutex_lock(&mempool_mutex);                                                                        \
+        } while (0)
+#    define mempool_unlock(state)                                                                                      \
+        do                                                                                                             \
+        {                                                                                                              \
+            pthread_mutex_unlock(&mempool_mutex);                                                                      \
+            restore_interrupt(state);                                                                                  \
+        } while (0)
+#elif defined(TEST_MEMPOOL)
+typedef unsigned int rt_reg_t;
+#    define mempool_lock(state)   (state) = 0
+#    define mempool_unlock(state) (void)(state)
+#else
+#    define mempool_lock(state)   disable_interrupt_save(state)
+#    define mempool_unlock(state) restore_interrupt(state)
+#endif
+
+/**
+ * @brief Initializes a pool on a data array, STATIC_MEMPOOL reserves and
+ * initializes it statically
+ * @param pool pool to initialize
+ * @param data storage of MEMPOOL_DATA_SIZE(blockSize, blockCount) bytes, aligned on a pointer
+ * @param blockSize usable size of a block in bytes
+ * @param blockCount number of blocks
+ */
+void mempool_init(MemPool *pool, char *data, size_t blockSize, uint16_t blockCount)
+{
+    pool->blockSize = MEMPOOL_BLOCK_SIZE(blockSize);
+    pool->blockCount = blockCount;
+    pool->carved = 0;
+    pool->used = 0;
+    pool->highWater = 0;
+    pool->failures = 0;
+    pool->badFrees = 0;
+    pool->data = data;
+    pool->map = (uint8_t *)data + (size_t)blockCount * pool->blockSize;
+    pool->free = NULL;
+    memset(pool->map, 0, (blockCount + 7) / 8);
+}
+
+/**
+ * @brief Allocates a block
+ * @param pool pool to allocate from
+ * @return pointer to a block of at least blockSize bytes, NULL if the pool is empty
+ */
+void *mempool_alloc(MemPool *pool)
+{
+    MemPoolBlock *block;
+    uint16_t id;
+    rt_reg_t irqState;
+
+    mempool_lock(irqState);
+    block = pool->free;
+    if (block != NULL)
+    {
+        pool->free = block->next;
+    }
+    else if (pool->carved < pool->blockCount)
+    {
+        // never used block, in address order
+        block = (MemPoolBlock *)(pool->data + (size_t)pool->carved * pool->blockSize);
+        pool->carved++;
+    }
+    else
+    {
+        pool->failures++;
+        mempool_unlock(irqState);
+        return NULL;
+    }
+    id = ((char *)block - pool->data) / pool->blockSize;
+    pool->map[id >> 3] |= 1 << (id & 7);
+    pool->used++;
+    if (pool->used > pool->highWater)
+    {
+        pool->highWater = pool->used;
+    }
+    mempool_unlock(irqState);
+
+    return block;
+}
+
+/**
+ * @brief Gives back a block to its pool
+ * @param pool pool the block was allocated from
+ * @param block block to free, NULL is ignored
+ * @return 0 if ok, -1 if the block does not belong to the pool or is not allocated (double free)
+ */
+int mempool_free(MemPool *pool, void *block)
+{
+    char *ptr = (char *)block;
+    uint16_t id;
+    uint8_t bit;
+    rt_reg_t irqState;
+
+    if (block == NULL)
+    {
+        return 0;
+    }
+    if (ptr < pool->data || ptr >= pool->data + (size_t)pool->blockCount * pool->blockSize
+        || (size_t)(ptr - pool->data) % pool->blockSize != 0)
+    {
+        return -1;
+    }
+    id = (ptr - pool->data) / pool->blockSize;
+    bit = 1 << (id & 7);
+
+    mempool_lock(irqState);
+    if ((pool->map[id >> 3] & bit) == 0 || pool->used == 0)
+    {
+        pool->badFrees++;
+        mempool_unlock(irqState);
+        return -1;
+    }
+    pool->map[id >> 3] &= ~bit;
+    ((MemPoolBlock *)block)->next = pool->free;
+    pool->free = (MemPoolBlock *)block;
+    pool->used--;
+    mempool_unlock(irqState);
+
+    return 0;
+}
+
+size_t mempool_blockSize(MemPool *pool)
+{
+    return pool->blockSize;
+}
+
+uint16_t mempool_used(MemPool *pool)
+{
+    return pool->used;
+}
+
+uint16_t mempool_avail(MemPool *pool)
+{
+    return pool->blockCount - pool->used;
+}
+
+uint16_t mempool_highWater(MemPool *pool)
+{
+    return pool->highWater;
+}
+
+uint16_t mempool_failures(MemPool *pool)
+{
+    return pool->failures;
+}
+
+uint16_t mempool_badFrees(MemPool *pool)
+{
+    return pool->badFrees;
+}
+
+/**
+ * @brief Allocates a block from the smallest class fitting size, falls back to larger classes when empty
+ * @param pools array of pools sorted by increasing block size
+ * @param poolCount number of pools
+ * @param size needed size in bytes
+ * @return pointer to a block, NULL if no block is available
+ */
+void *mempool_allocSize(MemPool *pools, uint8_t poolCount, size_t size)
+{
+    uint8_t i;
+    void *block;
+
+    for (i = 0; i < poolCount; i++)
+    {
+        if (pools[i].blockSize < size)
+        {
+            continue;
+        }
+        block = mempool_alloc(&pools[i]);
+        if (block != NULL)
+        {
+            return block;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Frees a block allocated with mempool_allocSize
+ * @param pools array of pools given to mempool_allocSize
+ * @param poolCount number of pools
+ * @param block block to free, NULL is ignored
+ * @return 0 if ok, -1 if the block does not belong to any pool
+ */
+int mempool_freeAny(MemPool *pools, uint8_t poolCount, void *block)
+{
+    uint8_t i;
+
+    if (block == NULL)
+    {
+        return 0;
+    }
+    for (i = 0; i < poolCount; i++)
+    {
+        if (mempool_free(&pools[i], block) == 0)
+        {
+            return 0;
+        }
+    }
+    return -1;
+}
+
+#ifdef TEST_MEMPOOL
+#    include <assert.h>
+#    include <stdio.h>
+#    include <time.h>
+
+STATIC_MEMPOOL(test_small, 30, 4);
+STATIC_MEMPOOL(test_big, 256, 2);
+
+static double test_timeNs(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1e9 + now.tv_nsec;
+}
+
+int main(void)
+{
+    MemPool pools[2];
+    void *blocks[8];
+    uint32_t i, count = 10000000;
+    double start;
+
+    // static pool usable without init, blocks in address order
+    blocks[0] = mempool_alloc(&test_small);
+    blocks[1] = mempool_alloc(&test_small);
+    assert(blocks[0] == (void *)test_small_data);
+    assert((char *)blocks[1] == (char *)blocks[0] + MEMPOOL_BLOCK_SIZE(30));
+    assert(mempool_used(&test_small) == 2 && mempool_avail(&test_small) == 2);
+
+    // double free and foreign pointers are rejected without changing the pool
+    assert(mempool_free(&test_small, blocks[1]) == 0);
+    assert(mempool_free(&test_small, blocks[1]) == -1);
+    assert(mempool_free(&test_small, (char *)blocks[0] + 1) == -1);
+    assert(mempool_free(&test_small, blocks) == -1);
+    assert(mempool_used(&test_small) == 1 && mempool_badFrees(&test_small) == 1);
+    assert(mempool_alloc(&test_small) == blocks[1]);
+    assert(mempool_free(&test_small, blocks[1]) == 0);
+    assert(mempool_free(&test_small, blocks[0]) == 0);
+    assert(mempool_free(&test_small, blocks[0]) == -1);
+    assert(mempool_used(&test_small) == 0 && mempool_highWater(&test_small) == 2);
+
+    // size classes, fall back to the larger class when the smaller is empty
+    STATIC_MEMPOOL_INIT(test_small, 30, 4);
+    STATIC_MEMPOOL_INIT(test_big, 256, 2);
+    pools[0] = test_small;
+    pools[1] = test_big;
+    for (i = 0; i < 7; i++)
+    {
+        blocks[i] = mempool_allocSize(pools, 2, 20);
+        assert((i < 6) == (blocks[i] != NULL));
+    }
+    assert(mempool_failures(&pools[1]) == 1);
+    assert(mempool_allocSize(pools, 2, 300) == NULL);
+    for (i = 0; i < 6; i++)
+    {
+        assert(mempool_freeAny(pools, 2, blocks[i]) == 0);
+        assert(mempool_freeAny(pools, 2, blocks[i]) == -1);
+    }
+    assert(mempool_used(&pools[0]) == 0 && mempool_used(&pools[1]) == 0);
+
+    // alloc / free cost
+    start = test_timeNs();
+    for (i = 0; i < count; i++)
+    {
+        blocks[0] = mempool_alloc(&pools[0]);
+        mempool_free(&pools[0], blocks[0]);
+    }
+    printf("mempool alloc + free: %.1f ns\n", (test_timeNs() - start) / count);
+
+    return 0;
+}
+#endif
@@ -0,0 +1,41 @@
+/**
+ * @file packet.c
+ * @author agent
+ * @copyright UniSwarm 2026
+ *
+ * @date October 20, 2026, 10:05 AM
+ *
+ * @brief Packet buffers shared by drivers and modules
+ */
+
+#include "sys/packet.h"
+
+STATIC_MEMPOOL(packet_buffers, PACKET_SIZE, PACKET_COUNT);
+
+/**
+ * @brief Allocates a packet buffer, from main code or interrupt handlers
+ * @return buffer of PACKET_SIZE bytes, NULL if all packets are in use
+ */
+void *packet_alloc(void)
+{
+    return mempool_alloc(&packet_buffers);
+}
+
+/**
+ * @brief Gives back a packet buffer
+ * @param packet buffer given by packet_alloc, NULL is ignored
+ * @return 0 if ok, -1 if not a packet buffer in use
+ */
+int packet_free(void *packet)
+{
+    return mempool_free(&packet_buffers, packet);
+}
+
+/**
+ * @brief Gives the pool of packets, for its stats
+ * @return packets pool
+ */
+MemPool *packet_pool(void)
+{
+    return &packet_buffers;
+}
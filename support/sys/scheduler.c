@@ -0,0 +1,239 @@
+/**
+ * @file scheduler.c
+ * @author agent
+ * @copyright UniSwarm 2026
+ *
+ * @date October 19, 2026, 06:40 PM
+ *
+ * @brief Cooperative event driven task scheduler
+ *
+ * Each priority has a FIFO of pending tasks and a bit in a pending mask, a
+ * signal and a task selection are O(1). The pending check and the idle
+ * instruction are done with interrupts masked, so that a signal between them
+ * cannot be missed, this relies on the wake up of each family :
+ *  - PIC24, dsPIC30F, dsPIC33F/E/C: the CPU priority is raised to 7 and
+ *    PWRSAV #IDLE_MODE is executed. An interrupt source with its IE bit set
+ *    wakes up the CPU even if its priority is not above the CPU one, the
+ *    execution goes on after PWRSAV, the interrupt is served when the CPU
+ *    priority is restored (FRM Watchdog Timer and Power-Saving Modes, Idle
+ *    Mode).
+ *  - PIC32MX (M4K) and PIC32MZ/MK/MM (microAptiv): interrupts are disabled
+ *    with DI and WAIT is executed, a pending interrupt still ends WAIT on
+ *    these cores, the execution goes on after WAIT and the interrupt is
+ *    served at EI, like the r4k_wait_irqoff idle of Linux.
+ * Uart rx (uart_setRxTask) signals tasks from interrupt. On the simulator,
+ * idle waits on a condition variable signaled by scheduler_signal, which is
+ * called from simulated interrupt threads.
+ */
+
+#include "sys/scheduler.h"
+
+#include <stddef.h>
+
+#include <archi.h>
+
+#if SCHEDULER_PRIORITY_COUNT > 8
+#    error SCHEDULER_PRIORITY_COUNT must be lower or equal to 8
+#endif
+
+#ifdef SIMULATOR
+#    include <pthread.h>
+static pthread_mutex_t scheduler_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t scheduler_cond = PTHREAD_COND_INITIALIZER;
+#    define scheduler_lock(state)                                                                                      \
+        do                                                                                                             \
+        {                                                                                                              \
+            disable_interrupt_save(state);                                                                             \
+            pthread_mutex_lock(&scheduler_mutex);                                                                      \
+        } while (0)
+#    define scheduler_unlock(state)                                                                                    \
+        do                                                                                                             \
+        {                                                                                                              \
+            pthread_mutex_unlock(&scheduler_mutex);                                                                    \
+            restore_interrupt(state);                                                                                  \
+        } while (0)
+#else
+#    define scheduler_lock(state)   disable_interrupt_save(state)
+#    define scheduler_unlock(state) restore_interrupt(state)
+#endif
+
+typedef struct
+{
+    SchedulerTask *head;
+    SchedulerTask *tail;
+} scheduler_queue;
+
+static scheduler_queue scheduler_queues[SCHEDULER_PRIORITY_COUNT];
+static volatile uint8_t scheduler_pendingMask = 0;
+static volatile uint8_t scheduler_running = 0;
+
+/**
+ * @brief Registers a task, it runs at the first signaled event
+ * @param task task storage, must stay valid while the scheduler runs
+ * @param run task function, called with the pending events
+ * @param priority task priority, 0 is the highest one
+ * @return 0 if ok, -1 in case of error
+ */
+int scheduler_addTask(SchedulerTask *task, void (*run)(uint16_t events), uint8_t priority)
+{
+    if (task == NULL || run == NULL || priority >= SCHEDULER_PRIORITY_COUNT)
+    {
+        return -1;
+    }
+
+    task->next = NULL;
+    task->run = run;
+    task->events = 0;
+    task->priority = priority;
+    task->queued = 0;
+
+    return 0;
+}
+
+/**
+ * @brief Signals events to a task, can be called from an interrupt handler
+ * @param task task to wake up
+ * @param events event flags, or-ed with the already pending ones
+ */
+void scheduler_signal(SchedulerTask *task, uint16_t events)
+{
+    scheduler_queue *queue;
+    rt_reg_t irqState;
+
+    scheduler_lock(irqState);
+    task->events |= events;
+    if (!task->queued)
+    {
+        queue = &scheduler_queues[task->priority];
+        task->next = NULL;
+        if (queue->tail == NULL)
+        {
+            queue->head = task;
+        }
+        else
+        {
+            queue->tail->next = task;
+        }
+        queue->tail = task;
+        task->queued = 1;
+        scheduler_pendingMask |= 1 << task->priority;
+    }
+#ifdef SIMULATOR
+    pthread_cond_signal(&scheduler_cond);
+#endif
+    scheduler_unlock(irqState);
+}
+
+/**
+ * @brief Pops the highest priority pending task, called locked
+ */
+static SchedulerTask *scheduler_pop(uint16_t *events)
+{
+    scheduler_queue *queue;
+    SchedulerTask *task;
+    uint8_t priority = 0;
+
+    if (scheduler_pendingMask == 0)
+    {
+        return NULL;
+    }
+    while ((scheduler_pendingMask & (1 << priority)) == 0)
+    {
+        priority++;
+    }
+
+    queue = &scheduler_queues[priority];
+    task = queue->head;
+    queue->head = task->next;
+    if (queue->head == NULL)
+    {
+        queue->tail = NULL;
+        scheduler_pendingMask &= ~(1 << priority);
+    }
+    task->queued = 0;
+    *events = task->events;
+    task->events = 0;
+
+    return task;
+}
+
+/**
+ * @brief Runs the highest priority pending task, does not idle
+ * @return 1 if a task ran, 0 if no task was pending
+ */
+int scheduler_runOnce(void)
+{
+    SchedulerTask *task;
+    uint16_t events;
+    rt_reg_t irqState;
+
+    scheduler_lock(irqState);
+    task = scheduler_pop(&events);
+    scheduler_unlock(irqState);
+
+    if (task == NULL)
+    {
+        return 0;
+    }
+    task->run(events);
+    return 1;
+}
+
+/**
+ * @brief Runs pending tasks until scheduler_stop, idles when no task is pending
+ */
+void scheduler_run(void)
+{
+    SchedulerTask *task;
+    uint16_t events;
+    rt_reg_t irqState;
+
+    scheduler_running = 1;
+    while (scheduler_running)
+    {
+        scheduler_lock(irqState);
+        task = scheduler_pop(&events);
+#ifdef SIMULATOR
+        while (task == NULL && scheduler_running)
+        {
+            pthread_cond_wait(&scheduler_cond, &scheduler_mutex);
+            task = scheduler_pop(&events);
+        }
+        scheduler_unlock(irqState);
+#else
+        if (task == NULL)
+        {
+            // idles with interrupts masked, a pending interrupt still wakes the cpu and is served
+            // once unmasked, so a task signaled after the check cannot be missed
+#    if defined(__XC16)
+            Idle();
+#    elif defined(__XC32)
+            _wait();
+#    endif
+            scheduler_unlock(irqState);
+            continue;
+        }
+        scheduler_unlock(irqState);
+#endif
+
+        if (task != NULL)
+        {
+            task->run(events);
+        }
+    }
+}
+
+/**
+ * @brief Makes scheduler_run return after the current task
+ */
+void scheduler_stop(void)
+{
+    rt_reg_t irqState;
+
+    scheduler_lock(irqState);
+    scheduler_running = 0;
+#ifdef SIMULATOR
+    pthread_cond_signal(&scheduler_cond);
+#endif
+    scheduler_unlock(irqState);
+}
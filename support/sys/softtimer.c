@@ -0,0 +1,589 @@
+/**
+ * @file softtimer.c
+ * @author agent
+ * @copyright UniSwarm 2026
+ *
+ * @date October 19, 2026, 05:30 PM
+ *
+ * @brief Software timers multiplexed on one hardware timer
+ *
+ * Timers are stored in the slot of their expiration tick, at the lowest level
+ * able to hold their remaining delay. When the lower bits of the current tick
+ * wrap to zero, the matching upper level slot is cascaded : its timers are
+ * inserted again at a lower level. Delays longer than the wheel range are
+ * stored in the last level and cascaded until they fit.
+ *
+ * In tickless mode, the hardware timer period is set to the next expiration
+ * (at most SOFTTIMER_TICKLESS_MAX ticks) instead of one tick. Elapsed time
+ * during a period is read from the hardware timer counter when a timer is
+ * started or stopped. On the simulator, elapsed time is read from the host
+ * clock and a shorter period only applies after the current one.
+ */
+
+#include "sys/softtimer.h"
+
+#ifndef TEST_SOFTTIMER
+#    include <archi.h>
+#    include <driver/timer.h>
+#endif
+
+#if defined(SIMULATOR)
+#    include <pthread.h>
+#    include <time.h>
+static pthread_mutex_t softtimer_mutex = PTHREAD_MUTEX_INITIALIZER;
+#    define softtimer_lock(state)                                                                                      \
+        do                                                                                                             \
+        {                                                                                                              \
+            disable_interrupt_save(state);                                                                             \
+            pthread_mutex_lock(&softtimer_mutex);                                                                      \
+        } while (0)
+#    define softtimer_unlock(state)                                                                                    \
+        do                                                                                                             \
+        {                                                                                                              \
+            pthread_mutex_unlock(&softtimer_mutex);                                                                    \
+            restore_interrupt(state);                                                                                  \
+        } while (0)
+#elif defined(TEST_SOFTTIMER)
+typedef unsigned int rt_reg_t;
+#    define softtimer_lock(state)   (state) = 0
+#    define softtimer_unlock(state) (void)(state)
+#else
+#    define softtimer_lock(state)   disable_interrupt_save(state)
+#    define softtimer_unlock(state) restore_interrupt(state)
+#endif
+
+#if SOFTTIMER_WHEEL_BITS * SOFTTIMER_WHEEL_LEVELS > 31
+#    error SOFTTIMER_WHEEL_BITS * SOFTTIMER_WHEEL_LEVELS must be lower than 32
+#endif
+
+#define SOFTTIMER_WHEEL_SLOTS (1 << SOFTTIMER_WHEEL_BITS)
+#define SOFTTIMER_WHEEL_MASK  (SOFTTIMER_WHEEL_SLOTS - 1)
+#define SOFTTIMER_WHEEL_RANGE ((uint32_t)1 << (SOFTTIMER_WHEEL_BITS * SOFTTIMER_WHEEL_LEVELS))
+
+static SoftTimer *softtimer_wheel[SOFTTIMER_WHEEL_LEVELS][SOFTTIMER_WHEEL_SLOTS];
+static uint32_t softtimer_now = 0;
+static uint32_t softtimer_tickUs = 1000;
+static uint8_t softtimer_tickless = 0;
+static rt_dev_t softtimer_timer = NULLDEV;
+static uint32_t softtimer_periodTicks = 1;    // current hardware period
+static uint32_t softtimer_accountedTicks = 0;  // ticks already processed in current hardware period
+#ifdef SIMULATOR
+static uint64_t softtimer_periodStartUs = 0;
+#endif
+#ifdef TEST_SOFTTIMER
+static uint32_t softtimer_cascaded = 0;
+#endif
+
+static void softtimer_insert(SoftTimer *softTimer)
+{
+    SoftTimer **slot;
+    uint32_t expire = softTimer->expire;
+    uint32_t delta = expire - softtimer_now;
+    uint8_t level = 0;
+
+    if ((int32_t)delta < 0)
+    {
+        // late timer from a cascade, expires with the current tick slot
+        expire = softtimer_now;
+        delta = 0;
+    }
+    else if (delta >= SOFTTIMER_WHEEL_RANGE)
+    {
+        expire = softtimer_now + SOFTTIMER_WHEEL_RANGE - 1;
+        delta = SOFTTIMER_WHEEL_RANGE - 1;
+    }
+    while (level < SOFTTIMER_WHEEL_LEVELS - 1 && delta >= ((uint32_t)1 << ((level + 1) * SOFTTIMER_WHEEL_BITS)))
+    {
+        level++;
+    }
+
+    slot = &softtimer_wheel[level][(expire >> (level * SOFTTIMER_WHEEL_BITS)) & SOFTTIMER_WHEEL_MASK];
+    softTimer->next = *slot;
+    if (softTimer->next != NULL)
+    {
+        softTimer->next->pprev = &softTimer->next;
+    }
+    *slot = softTimer;
+    softTimer->pprev = slot;
+}
+
+static void softtimer_unlink(SoftTimer *softTimer)
+{
+    *softTimer->pprev = softTimer->next;
+    if (softTimer->next != NULL)
+    {
+        softTimer->next->pprev = softTimer->pprev;
+    }
+    softTimer->pprev = NULL;
+}
+
+static void softtimer_cascade(uint8_t level)
+{
+    SoftTimer **slot = &softtimer_wheel[level][(softtimer_now >> (level * SOFTTIMER_WHEEL_BITS)) & SOFTTIMER_WHEEL_MASK];
+    SoftTimer *softTimer = *slot;
+    SoftTimer *next;
+
+    *slot = NULL;
+    while (softTimer != NULL)
+    {
+        next = softTimer->next;
+#ifdef TEST_SOFTTIMER
+        softtimer_cascaded++;
+#endif
+        softtimer_insert(softTimer);
+        softTimer = next;
+    }
+}
+
+/**
+ * @brief Advances time of one tick and calls expired timers handlers, called locked
+ * @param irqState interrupt state saved by the caller lock, handlers are called unlocked
+ */
+static void softtimer_advance(rt_reg_t irqState)
+{
+    SoftTimer *expired;
+    SoftTimer *softTimer;
+    void (*handler)(void);
+    uint8_t level;
+
+    softtimer_now++;
+    for (level = SOFTTIMER_WHEEL_LEVELS - 1; level > 0; level--)
+    {
+        if ((softtimer_now & (((uint32_t)1 << (level * SOFTTIMER_WHEEL_BITS)) - 1)) == 0)
+        {
+            softtimer_cascade(level);
+        }
+    }
+
+    // expired list is detached from the wheel, softtimer_stop still works on it
+    expired = softtimer_wheel[0][softtimer_now & SOFTTIMER_WHEEL_MASK];
+    softtimer_wheel[0][softtimer_now & SOFTTIMER_WHEEL_MASK] = NULL;
+    if (expired != NULL)
+    {
+        expired->pprev = &expired;
+    }
+    while (expired != NULL)
+    {
+        softTimer = expired;
+        softtimer_unlink(softTimer);
+        handler = softTimer->handler;
+        if (softTimer->period != 0)
+        {
+            softTimer->expire += softTimer->period;
+            softtimer_insert(softTimer);
+        }
+
+        softtimer_unlock(irqState);
+        handler();
+        softtimer_lock(irqState);
+    }
+}
+
+/**
+ * @brief Ticks before next timer expiration or cascade, at most SOFTTIMER_TICKLESS_MAX, called locked
+ */
+static uint32_t softtimer_nextExpireLocked(void)
+{
+    uint32_t next = SOFTTIMER_TICKLESS_MAX;
+    uint32_t ticks;
+    uint16_t slot, index;
+    uint8_t level;
+
+    for (level = 0; level < SOFTTIMER_WHEEL_LEVELS; level++)
+    {
+        uint8_t shift = level * SOFTTIMER_WHEEL_BITS;
+        index = (softtimer_now >> shift) & SOFTTIMER_WHEEL_MASK;
+        for (slot = 1; slot <= SOFTTIMER_WHEEL_SLOTS; slot++)
+        {
+            if (softtimer_wheel[level][(index + slot) & SOFTTIMER_WHEEL_MASK] != NULL)
+            {
+                // start of the slot window, when the slot is expired or cascaded
+                ticks = ((uint32_t)slot << shift) - (softtimer_now & (((uint32_t)1 << shift) - 1));
+                if (ticks < next)
+                {
+                    next = ticks;
+                }
+                break;
+            }
+        }
+    }
+    return next;
+}
+
+#ifndef TEST_SOFTTIMER
+#    ifdef SIMULATOR
+static uint64_t softtimer_timeUs(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000 + now.tv_nsec / 1000;
+}
+#    endif
+
+/**
+ * @brief Ticks elapsed since the start of the current hardware period, called locked
+ */
+static uint32_t softtimer_hardwareElapsed(void)
+{
+#    ifdef SIMULATOR
+    return (softtimer_timeUs() - softtimer_periodStartUs) / softtimer_tickUs;
+#    else
+    uint32_t period = timer_period(softtimer_timer);
+    if (period == 0)
+    {
+        return 0;
+    }
+    return (uint32_t)timer_getValue(softtimer_timer) * softtimer_periodTicks / period;
+#    endif
+}
+
+static void softtimer_setHardwarePeriod(uint32_t ticks)
+{
+    while (ticks > 1 && timer_setPeriodUs(softtimer_timer, ticks * softtimer_tickUs) != 0)
+    {
+        ticks >>= 1;  // too long for the hardware timer
+    }
+    if (ticks <= 1)
+    {
+        ticks = 1;
+        timer_setPeriodUs(softtimer_timer, softtimer_tickUs);
+    }
+    softtimer_periodTicks = ticks;
+    softtimer_accountedTicks = 0;
+}
+
+/**
+ * @brief Processes ticks elapsed in the current tickless hardware period, called locked
+ */
+static void softtimer_sync(rt_reg_t irqState)
+{
+    uint32_t elapsed;
+
+    if (!softtimer_tickless || softtimer_timer == NULLDEV)
+    {
+        return;
+    }
+
+    elapsed = softtimer_hardwareElapsed();
+    while (softtimer_accountedTicks < elapsed)
+    {
+        softtimer_accountedTicks++;
+        softtimer_advance(irqState);
+    }
+}
+
+/**
+ * @brief Shortens the current tickless hardware period if a timer expires before its end, called locked
+ */
+static void softtimer_reschedule(void)
+{
+    uint32_t next;
+
+    if (!softtimer_tickless || softtimer_timer == NULLDEV)
+    {
+        return;
+    }
+
+    next = softtimer_nextExpireLocked();
+    if (next < softtimer_periodTicks - softtimer_accountedTicks)
+    {
+#    ifdef SIMULATOR
+        // simulated timer takes the new period after the current one
+        timer_setPeriodUs(softtimer_timer, next * softtimer_tickUs);
+#    else
+        timer_clearValue(softtimer_timer);
+        softtimer_setHardwarePeriod(next);
+#    endif
+    }
+}
+
+static void softtimer_timerHandler(void)
+{
+    uint32_t ticks;
+    rt_reg_t irqState;
+
+    softtimer_lock(irqState);
+#    ifdef SIMULATOR
+    ticks = softtimer_hardwareElapsed();  // follows host time, even if the handler thread is late
+#    else
+    ticks = softtimer_periodTicks;
+#    endif
+    while (softtimer_accountedTicks < ticks)
+    {
+        softtimer_accountedTicks++;
+        softtimer_advance(irqState);
+    }
+#    ifdef SIMULATOR
+    softtimer_periodStartUs += (uint64_t)softtimer_accountedTicks * softtimer_tickUs;
+#    endif
+    softtimer_accountedTicks = 0;
+
+    if (softtimer_tickless)
+    {
+        softtimer_setHardwarePeriod(softtimer_nextExpireLocked());
+    }
+    softtimer_unlock(irqState);
+}
+#else
+#    define softtimer_sync(state)
+#    define softtimer_reschedule()
+#endif
+
+/**
+ * @brief Initializes soft timers and binds them to a hardware timer
+ * @param timer hardware timer device, or NULLDEV to call softtimer_tick from an existing periodic handler
+ * @param tickUs tick period in us
+ * @return 0 if ok, -1 in case of error
+ */
+int softtimer_init(rt_dev_t timer, uint32_t tickUs)
+{
+    if (tickUs == 0)
+    {
+        return -1;
+    }
+
+    softtimer_tickUs = tickUs;
+    softtimer_timer = timer;
+    softtimer_periodTicks = 1;
+    softtimer_accountedTicks = 0;
+
+#ifndef TEST_SOFTTIMER
+    if (timer != NULLDEV)
+    {
+        if (timer_setPeriodUs(timer, tickUs) != 0)
+        {
+            return -1;
+        }
+        timer_setHandler(timer, softtimer_timerHandler);
+#    ifdef SIMULATOR
+        softtimer_periodStartUs = softtimer_timeUs();
+#    endif
+        timer_enable(timer);
+    }
+#endif
+
+    return 0;
+}
+
+/**
+ * @brief Enables tickless mode, hardware timer period follows the next expiration
+ * @param tickless 1 to enable, 0 for a periodic tick
+ * @return 0 if ok, -1 if no hardware timer is bound
+ */
+int softtimer_setTickless(uint8_t tickless)
+{
+    rt_reg_t irqState;
+
+    if (softtimer_timer == NULLDEV)
+    {
+        return -1;
+    }
+
+    softtimer_lock(irqState);
+    softtimer_sync(irqState);
+    softtimer_tickless = tickless;
+    softtimer_reschedule();
+    softtimer_unlock(irqState);
+
+    return 0;
+}
+
+/**
+ * @brief Advances soft timers of one tick, for soft timers without hardware timer bound
+ */
+void softtimer_tick(void)
+{
+    rt_reg_t irqState;
+
+    softtimer_lock(irqState);
+    softtimer_advance(irqState);
+    softtimer_unlock(irqState);
+}
+
+/**
+ * @brief Current tick count
+ */
+uint32_t softtimer_ticks(void)
+{
+    return softtimer_now;
+}
+
+/**
+ * @brief Ticks before next timer expiration or cascade, at most SOFTTIMER_TICKLESS_MAX
+ */
+uint32_t softtimer_nextExpire(void)
+{
+    uint32_t next;
+    rt_reg_t irqState;
+
+    softtimer_lock(irqState);
+    next = softtimer_nextExpireLocked();
+    softtimer_unlock(irqState);
+
+    return next;
+}
+
+/**
+ * @brief Starts or restarts a soft timer
+ * @param softTimer timer storage, must stay valid while the timer runs
+ * @param handler function called on expiration, from hardware timer interrupt
+ * @param delayUs delay before first expiration, rounded up to tick period
+ * @param periodUs period for next expirations, 0 for a one shot timer
+ * @return 0 if ok, -1 in case of error
+ */
+int softtimer_start(SoftTimer *softTimer, void (*handler)(void), uint32_t delayUs, uint32_t periodUs)
+{
+    uint32_t delay = (delayUs + softtimer_tickUs - 1) / softtimer_tickUs;
+    rt_reg_t irqState;
+
+    if (softTimer == NULL || handler == NULL)
+    {
+        return -1;
+    }
+
+    softtimer_lock(irqState);
+    if (softTimer->pprev != NULL)
+    {
+        softtimer_unlink(softTimer);
+    }
+    softtimer_sync(irqState);
+
+    softTimer->handler = handler;
+    softTimer->expire = softtimer_now + ((delay == 0) ? 1 : delay);
+    softTimer->period = (periodUs + softtimer_tickUs / 2) / softtimer_tickUs;
+    if (periodUs != 0 && softTimer->period == 0)
+    {
+        softTimer->period = 1;
+    }
+    softtimer_insert(softTimer);
+
+    softtimer_reschedule();
+    softtimer_unlock(irqState);
+
+    return 0;
+}
+
+/**
+ * @brief Stops a soft timer, can be called from its own handler
+ * @return 0 if ok, -1 if timer was not running
+ */
+int softtimer_stop(SoftTimer *softTimer)
+{
+    int ret = -1;
+    rt_reg_t irqState;
+
+    softtimer_lock(irqState);
+    if (softTimer->pprev != NULL)
+    {
+        softtimer_unlink(softTimer);
+        ret = 0;
+    }
+    softtimer_unlock(irqState);
+
+    return ret;
+}
+
+int softtimer_isActive(const SoftTimer *softTimer)
+{
+    return softTimer->pprev != NULL;
+}
+
+#ifdef TEST_SOFTTIMER
+#    include <assert.h>
+#    include <stdio.h>
+#    include <time.h>
+
+static uint32_t bench_count;
+static void bench_handler(void)
+{
+    bench_count++;
+}
+
+static double bench_timeNs(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1e9 + now.tv_nsec;
+}
+
+int main(void)
+{
+    static SoftTimer timers[100000];
+    static const uint32_t counts[] = {10, 100, 1000, 10000, 100000};
+    SoftTimer oneShot = {0}, periodic = {0};
+    uint32_t i, c, ticks;
+    double start, startNs, stopNs, tickNs;
+
+    softtimer_init(NULLDEV, 1000);
+
+    // functional checks : one shot, periodic, long delay cascade, stop from list
+    bench_count = 0;
+    softtimer_start(&oneShot, bench_handler, 5000, 0);
+    for (i = 0; i < 4; i++)
+    {
+        softtimer_tick();
+    }
+    assert(bench_count == 0 && softtimer_isActive(&oneShot));
+    softtimer_tick();
+    assert(bench_count == 1 && !softtimer_isActive(&oneShot));
+
+    softtimer_start(&periodic, bench_handler, 1000, 3000);
+    for (i = 0; i < 301; i++)
+    {
+        softtimer_tick();
+    }
+    assert(bench_count == 1 + 101);
+    assert(softtimer_stop(&periodic) == 0 && softtimer_stop(&periodic) == -1);
+
+    bench_count = 0;
+    softtimer_start(&oneShot, bench_handler, (SOFTTIMER_WHEEL_RANGE + 1234) * 1000, 0);
+    for (i = 0; i < SOFTTIMER_WHEEL_RANGE + 1233; i++)
+    {
+        softtimer_tick();
+    }
+    assert(bench_count == 0);
+    softtimer_tick();
+    assert(bench_count == 1);
+
+    // benchmark : cost per operation must not depend on the number of timers
+    // tick cost is given per elementary operation : tick, expiration or cascaded timer
+    printf("%10s %12s %12s %12s\n", "timers", "start ns", "stop ns", "tick op ns");
+    srand(1);
+    for (c = 0; c < sizeof(counts) / sizeof(counts[0]); c++)
+    {
+        start = bench_timeNs();
+        for (i = 0; i < counts[c]; i++)
+        {
+            softtimer_start(&timers[i], bench_handler, (1 + rand() % 60000) * 1000, (1 + rand() % 60000) * 1000);
+        }
+        startNs = (bench_timeNs() - start) / counts[c];
+
+        ticks = 10000;
+        bench_count = 0;
+        softtimer_cascaded = 0;
+        start = bench_timeNs();
+        for (i = 0; i < ticks; i++)
+        {
+            softtimer_tick();
+        }
+        tickNs = (bench_timeNs() - start) / (ticks + bench_count + softtimer_cascaded);
+
+        start = bench_timeNs();
+        for (i = 0; i < counts[c]; i++)
+        {
+            softtimer_stop(&timers[i]);
+        }
+        stopNs = (bench_timeNs() - start) / counts[c];
+
+        printf("%10u %12.1f %12.1f %12.1f (%u expirations, %u cascaded)\n",
+               counts[c],
+               startNs,
+               stopNs,
+               tickNs,
+               bench_count,
+               softtimer_cascaded);
+    }
+
+    return 0;
+}
+#endif
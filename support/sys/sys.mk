@@ -9,6 +9,39 @@ HEADER += fifo.h buffer.h
 
 $(OUT_PWD)/device.o: $(OUT_PWD)/modules.h
 
+# optional sys components, only built when listed in SYS
+ifneq ($(filter scheduler,$(SYS)),)
+ SRC += scheduler.c
+ HEADER += scheduler.h
+endif
+# shared packet buffers need mempool
+ifneq ($(filter packet,$(SYS)),)
+ SYS += mempool
+ SRC += packet.c
+ HEADER += packet.h
+endif
+ifneq ($(filter mempool,$(SYS)),)
+ SRC += mempool.c
+ HEADER += mempool.h
+endif
+
+# soft timers need the timer driver
+ifneq ($(filter softtimer,$(SYS)),)
+ ifeq ($(filter timer,$(DRIVERS)),)
+  $(error softtimer needs the timer driver, add DRIVERS += timer)
+ endif
+ SRC += softtimer.c
+ HEADER += softtimer.h
+endif
+
+mempool-test:
+	gcc $(UDEVKIT)/support/sys/mempool.c -O2 -Wall -Wextra -I$(UDEVKIT)/include -DTEST_MEMPOOL -o mempool-test && ./mempool-test
+	rm mempool-test
+
+softtimer-bench:
+	gcc $(UDEVKIT)/support/sys/softtimer.c -O2 -Wall -Wextra -I$(UDEVKIT)/include -DTEST_SOFTTIMER -o softtimer-bench && ./softtimer-bench
+	rm softtimer-bench
+
 #test-fifo:
 #	gcc $(UDEVKIT)/support/sys/fifo.c -Wall -Wextra -I$(UDEVKIT)/include -DTEST_FIFO -o a.exe && ./a.exe
 #	rm a.exe
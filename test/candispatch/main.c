@@ -0,0 +1,277 @@
+/**
+ * CAN receive dispatch test
+ *
+ * Frames sent on can1 are received back and dispatched to handlers by
+ * identifier. On the simulator, the can driver uses the udk-sim fabric bus
+ * and this test stands for udk-sim with a loopback server, run it with
+ * make sim-test. On target, the bus is in loopback mode and led 0 is set on
+ * success.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "modules.h"
+#include "board.h"
+#include "archi.h"
+
+#ifdef SIMULATOR
+#    include <arpa/inet.h>
+#    include <netinet/in.h>
+#    include <pthread.h>
+#    include <sys/socket.h>
+#    include <unistd.h>
+
+#    include "simulator_socket.h"
+
+static int loopback_server = -1;
+
+/**
+ * @brief Stands for udk-sim, can frames written by the driver are given back to it to be read
+ */
+static void *loopback_client(void *arg)
+{
+    char packet[0x10000];
+    uint16_t *header = (uint16_t *)packet;
+    int client = (int)(intptr_t)arg;
+
+    while (recv(client, packet, 8, MSG_WAITALL) == 8)
+    {
+        if (header[0] < 8 || (header[0] > 8 && recv(client, packet + 8, header[0] - 8, MSG_WAITALL) != header[0] - 8))
+        {
+            break;
+        }
+        if (header[1] == CAN_SIM_MODULE && header[3] == CAN_SIM_WRITE)
+        {
+            header[3] = CAN_SIM_READ;
+            send(client, packet, header[0], 0);
+        }
+    }
+    close(client);
+    return NULL;
+}
+
+static void *loopback_thread(void *arg)
+{
+    pthread_t thread;
+    int client;
+
+    (void)arg;
+    // each simulator_init connects again
+    while ((client = accept(loopback_server, NULL, NULL)) >= 0)
+    {
+        pthread_create(&thread, NULL, loopback_client, (void *)(intptr_t)client);
+        pthread_detach(thread);
+    }
+    return NULL;
+}
+
+static int loopback_start(void)
+{
+    struct sockaddr_in addr;
+    pthread_t thread;
+    int reuse = 1;
+
+    loopback_server = socket(AF_INET, SOCK_STREAM, 0);
+    setsockopt(loopback_server, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = inet_addr("127.0.0.1");
+    addr.sin_port = htons(SIM_SOCKET_PORT);
+    if (bind(loopback_server, (struct sockaddr *)&addr, sizeof(addr)) != 0 || listen(loopback_server, 4) != 0)
+    {
+        printf("port %d in use, udk-sim running?\n", SIM_SOCKET_PORT);
+        return -1;
+    }
+    return pthread_create(&thread, NULL, loopback_thread, NULL);
+}
+#endif
+
+rt_dev_t can1;
+CanRxHandler handlerA = CAN_RX_HANDLER_INITIALIZER;
+CanRxHandler handlerB = CAN_RX_HANDLER_INITIALIZER;
+CanRxHandler handlerExt = CAN_RX_HANDLER_INITIALIZER;
+CanRxHandler handlersMany[2 * CAN_DISPATCH_BUCKETS];
+
+uint32_t receivedA, receivedB, receivedExt, receivedMany, receivedDefault;
+char lastData;
+
+void rxA(rt_dev_t device, const CAN_MSG_HEADER *header, const char *data)
+{
+    receivedA++;
+    lastData = data[0];
+}
+
+void rxB(rt_dev_t device, const CAN_MSG_HEADER *header, const char *data)
+{
+    receivedB++;
+}
+
+void rxExt(rt_dev_t device, const CAN_MSG_HEADER *header, const char *data)
+{
+    receivedExt++;
+}
+
+void rxMany(rt_dev_t device, const CAN_MSG_HEADER *header, const char *data)
+{
+    // handler index is given in data
+    if ((uint8_t)data[0] == header->id - 0x400)
+    {
+        receivedMany++;
+    }
+}
+
+void rxDefault(rt_dev_t device, const CAN_MSG_HEADER *header, const char *data)
+{
+    receivedDefault++;
+}
+
+void sendFrame(uint32_t id, uint8_t flags, char value)
+{
+    CAN_MSG_HEADER header;
+    char data[8] = {value};
+
+    header.id = id;
+    header.size = 1;
+    header.flags = flags;
+    can_send(can1, 0, &header, data);
+}
+
+/**
+ * @brief Dispatches until count frames are received or a timeout
+ */
+int dispatchAll(uint16_t count)
+{
+    uint16_t received = 0;
+    uint32_t tries;
+    int ret;
+
+    for (tries = 0; received < count && tries < 1000; tries++)
+    {
+        ret = can_dispatch(can1, 0, 0);
+        if (ret < 0)
+        {
+            return -1;
+        }
+        received += ret;
+#ifdef SIMULATOR
+        if (received < count)
+        {
+            simulator_socket_wait(1);
+        }
+#endif
+    }
+    return received;
+}
+
+#define check(cond)                                                                                                    \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        if (!(cond))                                                                                                   \
+        {                                                                                                              \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond);                                            \
+            return -1;                                                                                                 \
+        }                                                                                                              \
+    } while (0)
+
+int test(void)
+{
+    CanDispatchStats stats;
+    uint16_t i;
+
+    check(can_setDefaultRxHandler(can1, rxDefault) == 0);
+
+    // one handler per identifier, standard and extended identifiers are distinct
+    check(can_setRxHandler(can1, &handlerA, 0x181, CAN_FRAME_STD, rxA) == 0);
+    check(can_setRxHandler(can1, &handlerB, 0x181, CAN_FRAME_STD, rxB) == -1);
+    check(handlerB.pprev == NULL);
+    check(can_setRxHandler(can1, &handlerB, 0x182, CAN_FRAME_STD, rxB) == 0);
+    check(can_setRxHandler(can1, &handlerExt, 0x181, CAN_FRAME_EXT, rxExt) == 0);
+    check(can_setRxHandler(can1, &handlerExt, 0x800, CAN_FRAME_STD, rxExt) == -1);
+
+    sendFrame(0x181, CAN_VERS1, 1);
+    sendFrame(0x182, CAN_VERS1, 2);
+    sendFrame(0x181, CAN_VERS2BA, 3);
+    sendFrame(0x183, CAN_VERS1, 4);
+    check(dispatchAll(4) == 4);
+    check(receivedA == 1 && lastData == 1);
+    check(receivedB == 1 && receivedExt == 1 && receivedDefault == 1);
+    check(handlerA.count == 1 && handlerB.count == 1 && handlerExt.count == 1);
+
+    // a failed re-registration keeps the previous one
+    check(can_setRxHandler(can1, &handlerB, 0x181, CAN_FRAME_STD, rxB) == -1);
+    sendFrame(0x182, CAN_VERS1, 5);
+    check(dispatchAll(1) == 1);
+    check(receivedB == 2);
+
+    // re-registering the same identifier or moving to a free one
+    check(can_setRxHandler(can1, &handlerA, 0x181, CAN_FRAME_STD, rxA) == 0);
+    check(can_setRxHandler(can1, &handlerA, 0x183, CAN_FRAME_STD, rxA) == 0);
+    sendFrame(0x181, CAN_VERS1, 6);
+    sendFrame(0x183, CAN_VERS1, 7);
+    check(dispatchAll(2) == 2);
+    check(receivedA == 2 && lastData == 7 && receivedDefault == 2);
+
+    // removal
+    check(can_removeRxHandler(can1, &handlerB) == 0);
+    check(can_removeRxHandler(can1, &handlerB) == -1);
+    sendFrame(0x182, CAN_VERS1, 8);
+    check(dispatchAll(1) == 1);
+    check(receivedB == 2 && receivedDefault == 3);
+
+    // more handlers than buckets, chained in each bucket
+    for (i = 0; i < 2 * CAN_DISPATCH_BUCKETS; i++)
+    {
+        check(can_setRxHandler(can1, &handlersMany[i], 0x400 + i, CAN_FRAME_STD, rxMany) == 0);
+    }
+    check(can_removeRxHandler(can1, &handlersMany[3]) == 0);
+    for (i = 0; i < 2 * CAN_DISPATCH_BUCKETS; i++)
+    {
+        sendFrame(0x400 + i, CAN_VERS1, i);
+    }
+    check(dispatchAll(2 * CAN_DISPATCH_BUCKETS) == 2 * CAN_DISPATCH_BUCKETS);
+    check(receivedMany == 2 * CAN_DISPATCH_BUCKETS - 1 && receivedDefault == 4);
+
+    check(can_dispatchStats(can1, &stats) == 0);
+    check(stats.received == 8 + 2 * CAN_DISPATCH_BUCKETS && stats.unhandled == 4);
+    can_dispatchResetStats(can1);
+    check(can_dispatchStats(can1, &stats) == 0);
+    check(stats.received == 0 && handlerA.count == 0);
+
+    return 0;
+}
+
+int main(void)
+{
+#ifdef SIMULATOR
+    if (loopback_start() != 0)
+    {
+        return 1;
+    }
+#endif
+    archi_init();
+    board_init();
+
+    can1 = can(1);
+    can_sim_setBus(can1, CAN_SIM_FABRIC_BUS);
+    can_open(can1);
+    can_setBitTiming(can1, 1000000, 1, 4, 2);
+    can_setMode(can1, CAN_MODE_LOOPBACK);
+    can_enable(can1);
+
+    if (test() != 0)
+    {
+        return 1;
+    }
+    puts("can dispatch test ok");
+    board_setLed(0, 1);
+
+#ifndef SIMULATOR
+    while (1)
+    {
+    }
+#endif
+
+    return 0;
+}
@@ -5,6 +5,7 @@
 #include "modules.h"
 #include "board.h"
 #include "archi.h"
+#include <sys/scheduler.h>
 
 #ifdef SIMULATOR
     unsigned char *dspic33c_slave;
@@ -19,13 +20,19 @@ void tt()
     board_toggleLed(0);
 }
 
-int main(void)
+rt_dev_t uartDbg;
+SchedulerTask consoleTask;
+void console_run(uint16_t events)
 {
-    uint16_t i, j;
-    rt_dev_t uartDbg;
-    uint16_t value;
-    char buff[100];
+    // signaled by uart rx, the cpu idles in scheduler_run between received bytes
+    while (uart_datardy(uartDbg) > 0)
+    {
+        cmdline_task();
+    }
+}
 
+int main(void)
+{
     sysclock_switchSourceTo(SYSCLOCK_SRC_POSC);
     board_init();
     sysclock_setPLLClock(80000000, SYSCLOCK_SRC_POSC);
@@ -58,6 +65,8 @@ int main(void)
 
     cmdline_init();
     cmdline_setDevice(uartDbg, uartDbg);
+    scheduler_addTask(&consoleTask, console_run, 0);
+    uart_setRxTask(uartDbg, &consoleTask, 1);
 
     // init timer
     rt_dev_t timer;
@@ -68,22 +77,7 @@ int main(void)
 
     enable_interrupt();
 
-    while(1)
-    {
-        #ifdef SIMULATOR
-            usleep(1000);
-        #endif
-
-        cmdline_task();
-
-        //board_setLed(0, 1);
-        //uart_write(uartDbg, "Led ON", 6);
-        for(j=0; j<5; j++) for(i=0; i<65000; i++);
-
-        //board_setLed(0, 0);
-        //uart_write(uartDbg, "Led OFF", 7);
-        for(j=0; j<5; j++) for(i=0; i<65000; i++);
-    }
+    scheduler_run();
 
     return 0;
 }
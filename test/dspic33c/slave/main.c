@@ -5,6 +5,7 @@
 #include "modules.h"
 #include "board.h"
 #include "archi.h"
+#include <sys/scheduler.h>
 
 char led=0;
 void tt()
@@ -14,10 +15,6 @@ void tt()
 
 int main(void)
 {
-    uint16_t i, j;
-    uint16_t value;
-    char buff[100];
-
     sysclock_switchSourceTo(SYSCLOCK_SRC_POSC);
     board_init();
     //sysclock_setPLLClock(80000000, SYSCLOCK_SRC_POSC);
@@ -29,6 +26,7 @@ int main(void)
     timer_setHandler(timer, tt);
     timer_enable(timer);
 
+#ifndef SIMULATOR
     // Configure the source clock for the APLL
     ACLKCON1bits.FRCSEL = 0;
     // Select internal POSC as the clock source
@@ -107,23 +105,12 @@ int main(void)
     PG2IOCONHbits.POLL = 0;    // PWML polarity non inversed
 
     PG2CONLbits.ON = 1;
+#endif
     
     enable_interrupt();
 
-    while(1)
-    {
-        #ifdef SIMULATOR
-            usleep(1000);
-        #endif
-
-        //board_setLed(0, 1);
-        //uart_write(uartDbg, "Led ON", 6);
-        for(j=0; j<5; j++) for(i=0; i<65000; i++);
-
-        //board_setLed(0, 0);
-        //uart_write(uartDbg, "Led OFF", 7);
-        for(j=0; j<5; j++) for(i=0; i<65000; i++);
-    }
+    // no task, idles between timer interrupts
+    scheduler_run();
 
     return 0;
 }
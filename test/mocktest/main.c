@@ -0,0 +1,190 @@
+/**
+ * Regression tests and micro-benchmarks of uart and timer drivers on the
+ * PIC32MM register mock, run on a PC with make mock-test.
+ *
+ * Checks give the failing line and make the test exit with an error status,
+ * benchmarks print host time per operation and are not checked.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "modules.h"
+#include "archi.h"
+
+#define check(cond)                                                                                                    \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        if (!(cond))                                                                                                   \
+        {                                                                                                              \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond);                                            \
+            return -1;                                                                                                 \
+        }                                                                                                              \
+    } while (0)
+
+rt_dev_t uartDev;
+uint32_t frameCycles;
+
+char txLine[1024];
+size_t txLen;
+void txCapture(uint8_t uart, uint16_t data)
+{
+    if (txLen < sizeof(txLine))
+    {
+        txLine[txLen++] = data;
+    }
+}
+
+char rxLine[64];
+size_t rxLen;
+uint16_t rxCalls;
+void rxReceived(rt_dev_t device, const char *data, size_t size)
+{
+    memcpy(rxLine, data, size);
+    rxLen = size;
+    rxCalls++;
+}
+
+uint32_t ticks;
+void tick(void)
+{
+    ticks++;
+}
+
+double nowUs(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1e6 + now.tv_nsec / 1e3;
+}
+
+int test_uartTx(void)
+{
+    const char msg[] = "longer than the 8 levels hardware fifo";
+    size_t size = sizeof(msg) - 1;
+
+    txLen = 0;
+    check(uart_write(uartDev, msg, size) == (ssize_t)size);
+    mock_run(0);  // tx interrupt fills the hardware fifo
+    check(uart_transmitFinished(uartDev) == 0);
+
+    // one character per frame time, in order
+    mock_run(frameCycles * (size - 1));
+    check(txLen == size - 1);
+    mock_run(frameCycles + 1);
+    check(txLen == size && memcmp(txLine, msg, size) == 0);
+    check(uart_transmitFinished(uartDev) == 1);
+    return 0;
+}
+
+int test_uartRx(void)
+{
+    char buff[16];
+
+    // polled with uart_read
+    check(mock_uart_inject(0, "abcdef", 6) == 6);
+    mock_run(frameCycles * 7);
+    check(uart_read(uartDev, buff, sizeof(buff)) == 6 && memcmp(buff, "abcdef", 6) == 0);
+    check(uart_read(uartDev, buff, sizeof(buff)) == 0);
+
+    // delimiter handler called from rx interrupt with the whole line
+    check(uart_setRxHandler(uartDev, UART_RX_HANDLER_DELIMITER, '\n', rxReceived) == 0);
+    mock_uart_inject(0, "cmd 1\nnext", 10);
+    mock_run(frameCycles * 11);
+    check(rxCalls == 1 && rxLen == 6 && memcmp(rxLine, "cmd 1\n", 6) == 0);
+    check(uart_setRxHandler(uartDev, UART_RX_HANDLER_DELIMITER, '\n', NULL) == 0);
+    check(uart_read(uartDev, buff, sizeof(buff)) == 4 && memcmp(buff, "next", 4) == 0);
+    return 0;
+}
+
+int test_timer(void)
+{
+    rt_dev_t timerDev = timer(1);
+
+    check(timer_open(timerDev) == 0);
+    check(timer_setPeriodMs(timerDev, 1) == 0);
+    check(timer_setHandler(timerDev, tick) == 0);
+    check(timer_enable(timerDev) == 0);
+
+    // period match resets the counter, a period is PR1 + 1 counts
+    ticks = 0;
+    mock_run(10 * (PR1 + 1) - 1);
+    check(ticks == 9);
+    mock_run(1);
+    check(ticks == 10);
+
+    check(timer_disable(timerDev) == 0);
+    mock_run(10 * (PR1 + 1));
+    check(ticks == 10);
+    timer_close(timerDev);
+    return 0;
+}
+
+void bench(void)
+{
+    const char msg[] = "0123456789abcdef0123456789abcdef";
+    double startUs;
+    uint32_t i, count = 20000;
+
+    startUs = nowUs();
+    for (i = 0; i < count; i++)
+    {
+        txLen = 0;
+        uart_write(uartDev, msg, sizeof(msg) - 1);
+        mock_run(frameCycles * (sizeof(msg) + 1));
+    }
+    printf("bench uart tx: %.1f ns per char\n", (nowUs() - startUs) * 1000 / count / (sizeof(msg) - 1));
+
+    startUs = nowUs();
+    for (i = 0; i < count; i++)
+    {
+        mock_uart_inject(0, msg, sizeof(msg) - 1);
+        mock_run(frameCycles * (sizeof(msg) + 1));
+        uart_read(uartDev, txLine, sizeof(txLine));
+    }
+    printf("bench uart rx: %.1f ns per char\n", (nowUs() - startUs) * 1000 / count / (sizeof(msg) - 1));
+
+    rt_dev_t timerDev = timer(2);
+    timer_open(timerDev);
+    timer_setPeriodUs(timerDev, 10);
+    timer_setHandler(timerDev, tick);
+    timer_enable(timerDev);
+    ticks = 0;
+    startUs = nowUs();
+    mock_run(sysclock_periphFreq(SYSCLOCK_CLOCK_TIMER));  // 1 s
+    printf("bench timer interrupt: %.1f ns per interrupt\n", (nowUs() - startUs) * 1000 / ticks);
+    timer_close(timerDev);
+}
+
+int main(void)
+{
+    archi_init();
+    sysclock_setClock(48000000);
+    mock_uart_setTxHandler(0, txCapture);
+
+    uartDev = uart(1);
+    uart_open(uartDev);
+    uart_setBaudSpeed(uartDev, 115200);
+    uart_setBitConfig(uartDev, 8, UART_BIT_PARITY_NONE, 1);
+    uart_enable(uartDev);
+    frameCycles = mock_uart_frameCycles(0);
+
+    // 10 bits per frame
+    if (uart_effectiveBaudSpeed(uartDev) < 114000 || uart_effectiveBaudSpeed(uartDev) > 116000
+        || frameCycles != 10 * (sysclock_periphFreq(SYSCLOCK_CLOCK_UART) / uart_effectiveBaudSpeed(uartDev)))
+    {
+        printf("bad uart config, %u bauds, %u cycles per frame\n", uart_effectiveBaudSpeed(uartDev), frameCycles);
+        return 1;
+    }
+
+    if (test_uartTx() != 0 || test_uartRx() != 0 || test_timer() != 0)
+    {
+        return 1;
+    }
+    puts("mock test ok");
+
+    bench();
+    return 0;
+}
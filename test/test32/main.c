@@ -5,6 +5,7 @@
 #include "modules.h"
 #include "board.h"
 #include "archi.h"
+#include <sys/scheduler.h>
 
 char led=0;
 void tt()
@@ -12,13 +13,19 @@ void tt()
     board_setLed(1, led++);
 }
 
-int main(void)
+rt_dev_t uartDbg;
+SchedulerTask consoleTask;
+void console_run(uint16_t events)
 {
-    uint16_t i, j;
-    rt_dev_t uartDbg;
-    uint16_t value;
-    char buff[100];
+    // signaled by uart rx, the cpu idles in scheduler_run between received bytes
+    while (uart_datardy(uartDbg) > 0)
+    {
+        cmdline_task();
+    }
+}
 
+int main(void)
+{
     archi_init();
     //sysclock_setClock(200000000);
     sysclock_setClockDiv(SYSCLOCK_CLOCK_TIMER, 16);
@@ -48,6 +55,8 @@ int main(void)
     // console init
     cmdline_init();
     cmdline_setDevice(uartDbg, uartDbg);
+    scheduler_addTask(&consoleTask, console_run, 0);
+    uart_setRxTask(uartDbg, &consoleTask, 1);
 
 #ifdef OLED_I2C_BUS
     rt_dev_t i2c_ihm = i2c(OLED_I2C_BUS);
@@ -64,19 +73,7 @@ int main(void)
     gui_ctrl_update();
 #endif
 
-    while(1)
-    {
-        #ifdef SIMULATOR
-            usleep(1000);
-        #endif
-        
-        cmdline_task();
-
-        board_setLed(2, 1);
-        for(j=0; j<5; j++) for(i=0; i<65000; i++);
-        board_setLed(2, 0);
-        for(j=0; j<5; j++) for(i=0; i<65000; i++);
-    }
+    scheduler_run();
 
     return 0;
 }
@@ -14,6 +14,7 @@
 
 #include <QTextStream>
 #include <QDir>
+#include <QFileInfo>
 #include <QMimeDatabase>
 #include <QMimeType>
 
@@ -23,7 +24,45 @@ QString typeFromExtension(const QString &file_name)
     return database.mimeTypeForFile(file_name).name();
 }
 
-void exportPathToStruct(const QString &path, const QString &outputFile)
+quint32 crc32(const QByteArray &data)
+{
+    quint32 crc = 0xFFFFFFFF;
+    for (int i = 0; i < data.size(); i++)
+    {
+        crc ^= (unsigned char)data[i];
+        for (int bit = 0; bit < 8; bit++)
+        {
+            crc = (crc >> 1) ^ (0xEDB88320 & (-(crc & 1)));
+        }
+    }
+    return ~crc;
+}
+
+QByteArray gzipCompress(const QByteArray &data)
+{
+    // qCompress gives 4 bytes of size + zlib stream (2 bytes header, deflate data, 4 bytes adler32)
+    QByteArray zlibData = qCompress(data, 9);
+    QByteArray deflateData = zlibData.mid(6, zlibData.size() - 10);
+
+    QByteArray gzipData;
+    // magic, deflate method, no flags, no mtime, best compression, unknown OS
+    gzipData.append("\x1f\x8b\x08\x00\x00\x00\x00\x00\x02\xff", 10);
+    gzipData.append(deflateData);
+
+    quint32 crc = crc32(data);
+    quint32 size = (quint32)data.size();
+    for (int i = 0; i < 4; i++)
+    {
+        gzipData.append((char)((crc >> (8 * i)) & 0xFF));
+    }
+    for (int i = 0; i < 4; i++)
+    {
+        gzipData.append((char)((size >> (8 * i)) & 0xFF));
+    }
+    return gzipData;
+}
+
+void exportPathToStruct(const QString &path, const QString &outputFile, const QStringList &gzipExtensions)
 {
     QDir dir(path);
 
@@ -44,9 +83,12 @@ void exportPathToStruct(const QString &path, const QString &outputFile)
     text << "   ================================================================" << endl;
     text << endl;
     text << "  | " << QString("File name").leftJustified(30, ' ') << "| "
-         << QString("Struct name").leftJustified(30, ' ') << '|' << endl;
-    text << "   --------------------------------------------------------------- " << endl;
+         << QString("Struct name").leftJustified(30, ' ') << "| "
+         << QString("Encoding").leftJustified(10, ' ') << '|' << endl;
+    text << "   -------------------------------------------------------------------------- " << endl;
 
+    QList<QByteArray> filesData;
+    QList<bool> filesGzip;
     foreach (QString file, files)
     {
         QString filewodot = file;
@@ -55,22 +97,41 @@ void exportPathToStruct(const QString &path, const QString &outputFile)
         filesLog.append(file);
         filesLog.append('\n');
 
+        QFile filebin(path + file);
+        filebin.open(QIODevice::ReadOnly);
+        QByteArray data = filebin.readAll();
+        bool gzip = false;
+
+        // compressed content is kept only if it is smaller than the stored one
+        if (gzipExtensions.contains(QFileInfo(file).suffix(), Qt::CaseInsensitive))
+        {
+            QByteArray gzipData = gzipCompress(data);
+            if (gzipData.size() < data.size())
+            {
+                data = gzipData;
+                gzip = true;
+            }
+        }
+        filesData.append(data);
+        filesGzip.append(gzip);
+
         text << "  | " << file.leftJustified(30, ' ') << "| "
-             << filewodot.leftJustified(30, ' ') << "|" << endl;
+             << filewodot.leftJustified(30, ' ') << "| "
+             << QString(gzip ? "gzip" : "identity").leftJustified(10, ' ') << "|" << endl;
     }
-    text << "   --------------------------------------------------------------- " << endl;
+    text << "   -------------------------------------------------------------------------- " << endl;
     text << "*/" << endl;
     text << endl;
     
     text << "#include <module/network.h>" << endl << endl;
 
     text << "// ======== Struct content ======== " << endl;
-    foreach (QString file, files)
+    for (int i = 0; i < files.count(); i++)
     {
+        const QString &file = files[i];
+        const QByteArray &data = filesData[i];
         QString filewodot = file;
         filewodot.replace(".", "_");
-        QFile filebin(path + file);
-        filebin.open(QIODevice::ReadOnly);
         text << "// -> " << file << endl;
         text << "const char " << filewodot << "_name[] = \"" << file
              << "\";" << endl;
@@ -79,26 +140,25 @@ void exportPathToStruct(const QString &path, const QString &outputFile)
         text << "const char " << filewodot << "_data[] = " << endl
              << "{" << endl
              << "    ";
-        unsigned int addr = 0;
-        while (filebin.bytesAvailable() > 0)
+        int addr = 0;
+        while (addr < data.size())
         {
-            char data;
             QString hexdat;
-            filebin.getChar(&data);
+            hexdat = QString::number((unsigned char)data[addr], 16);
             addr++;
 
-            hexdat = QString::number((unsigned char)data, 16);
             if (hexdat.size() < 2)
                 hexdat.prepend('0');
             text << "0x" << hexdat;
-            if (filebin.bytesAvailable() > 0)
+            if (addr < data.size())
                 text << ", ";
             if (addr % 10 == 0)
                 text << endl << "    ";
         }
         text << endl << "};" << endl;
         text << "const Fs_File " << filewodot << " = {" << filewodot << "_name, "
-             << filewodot << "_type, " << filewodot << "_data, " << addr << "};"
+             << filewodot << "_type, " << filewodot << "_data, " << addr << ", "
+             << (filesGzip[i] ? "FS_FILE_ENCODING_GZIP" : "FS_FILE_ENCODING_IDENTITY") << "};"
              << endl
              << endl;
     }
@@ -142,6 +202,9 @@ files into file struct system for web server");
     QCommandLineOption outputOption(QStringList() << "o" << "output",
         "Write generated data into <file>.", "html_data.c");
     parser.addOption(outputOption);
+    QCommandLineOption gzipOption(QStringList() << "z" << "gzip",
+        "Compress files with <extensions> (comma separated list) with gzip.", "html,css,js");
+    parser.addOption(gzipOption);
 
     parser.process(app);
     
@@ -161,7 +224,14 @@ files into file struct system for web server");
     }
     QString outputFile = parser.value(outputOption);
 
-    exportPathToStruct(inputPath, outputFile);
+    // compression
+    QStringList gzipExtensions;
+    if (parser.isSet(gzipOption))
+    {
+        gzipExtensions = parser.value(gzipOption).split(',', QString::SkipEmptyParts);
+    }
+
+    exportPathToStruct(inputPath, outputFile, gzipExtensions);
 
     return 0;
 }
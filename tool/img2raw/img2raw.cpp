@@ -14,6 +14,7 @@
 
 #include <QFile>
 #include <QDir>
+#include <QHash>
 #include <QTextStream>
 #include <QDebug>
 
@@ -25,12 +26,109 @@
 #include <QPainter>
 #include <QRegExp>
 
+#include <algorithm>
+
+// picture formats, see include/gui/picture.h
+enum PictureFormat
+{
+    FormatAuto = -1,
+    FormatRaw = 0,
+    FormatPalette,
+    FormatRle
+};
+static const char *const pictureFormatNames[] = {"PICTURE_FORMAT_RAW", "PICTURE_FORMAT_PALETTE", "PICTURE_FORMAT_RLE"};
+#define PICTURE_RLE_REPEAT   0x80
+#define PICTURE_RLE_MAX_SPAN 128
+
+/**
+ * @brief Packs palette indexes on bpp bits, MSB first, padded to a byte boundary
+ */
+static void packIndexes(QByteArray &out, const QVector<int> &indexes, int from, int count, int bpp)
+{
+    int byte = 0;
+    int bitsLeft = 8;
+    for (int i = from; i < from + count; ++i)
+    {
+        bitsLeft -= bpp;
+        byte |= indexes[i] << bitsLeft;
+        if (bitsLeft == 0)
+        {
+            out.append(static_cast<char>(byte));
+            byte = 0;
+            bitsLeft = 8;
+        }
+    }
+    if (bitsLeft != 8)
+        out.append(static_cast<char>(byte));
+}
+
+/**
+ * @brief Run length encodes palette indexes, runs shorter than a repeated span
+ * are stored as packed literal spans
+ */
+static QByteArray rleIndexes(const QVector<int> &indexes, int bpp)
+{
+    QByteArray out;
+    // a repeated span costs two bytes, shorter runs are cheaper as literals
+    const int minRun = qMax(2, 16 / bpp + 1);
+    int literalStart = 0;
+    int i = 0;
+
+    while (i < indexes.size())
+    {
+        int run = 1;
+        while (i + run < indexes.size() && run < PICTURE_RLE_MAX_SPAN && indexes[i + run] == indexes[i])
+            run++;
+
+        if (run >= minRun)
+        {
+            if (i > literalStart)
+            {
+                out.append(static_cast<char>(i - literalStart - 1));
+                packIndexes(out, indexes, literalStart, i - literalStart, bpp);
+            }
+            out.append(static_cast<char>(PICTURE_RLE_REPEAT | (run - 1)));
+            out.append(static_cast<char>(indexes[i]));
+            i += run;
+            literalStart = i;
+        }
+        else
+            i += run;
+
+        while (i - literalStart >= PICTURE_RLE_MAX_SPAN)
+        {
+            out.append(static_cast<char>(PICTURE_RLE_MAX_SPAN - 1));
+            packIndexes(out, indexes, literalStart, PICTURE_RLE_MAX_SPAN, bpp);
+            literalStart += PICTURE_RLE_MAX_SPAN;
+        }
+    }
+    if (i > literalStart)
+    {
+        out.append(static_cast<char>(i - literalStart - 1));
+        packIndexes(out, indexes, literalStart, i - literalStart, bpp);
+    }
+    return out;
+}
+
+static void writeWords(QTextStream &stream, const QVector<quint16> &words, int perLine)
+{
+    for (int i = 0; i < words.size(); ++i)
+    {
+        if (i % perLine == 0)
+            stream << endl;
+        stream << "0x" << QString::number(words[i], 16);
+        if (i != words.size() - 1)
+            stream << ", ";
+    }
+}
+
 /**
  * @brief exportImage convert an image to a structure containing metadata and
  * data
  * To read the arguments list of the Picture struc, see "/module/gui.gui.h"
+ * @return used format, the smallest one in auto format mode
  */
-void exportImage(const QImage &image, const QString &filename)
+PictureFormat exportImage(const QImage &image, const QString &filename, PictureFormat format, int *dataSize)
 {
     QFileInfo finfo(filename);
     QFile file(filename);
@@ -38,20 +136,13 @@ void exportImage(const QImage &image, const QString &filename)
 
     QTextStream stream(&file);
 
-    // starting preprocessor instructions
-    stream << "#include <gui/picture.h>" << endl;
-    stream << endl;
-
-    // creating an array containnig the image data
-    stream << "// an array containnig the image data" << endl;
-    stream << "__prog__ const uint16_t " << finfo.baseName()
-           << "_data[] __space_prog__ = {";
-
     QImage mirrored = image.mirrored(false, false);
 
+    // RGB565 pixels, column by column
+    QVector<quint16> pixels;
+    pixels.reserve(mirrored.width() * mirrored.height());
     for (int x = 0; x < mirrored.width(); ++x)
     {
-        stream << endl;
         for (int y = 0; y < mirrored.height(); ++y)
         {
             QRgb color = mirrored.pixel(x, y);
@@ -60,19 +151,125 @@ void exportImage(const QImage &image, const QString &filename)
             syscolor |= (qRed(color) & 0xF8) << 8;
             syscolor |= (qGreen(color) & 0xFC) << 3;
             syscolor |= (qBlue(color) & 0xF8) >> 3;
-            stream << "0x" << QString::number(syscolor, 16);
-            if (x != mirrored.width() - 1 || y != mirrored.height() - 1)
-                stream << ", ";
+            pixels.append(syscolor);
+        }
+    }
+
+    // palette, only possible with 256 colors or less
+    QVector<quint16> palette;
+    QVector<int> indexes;
+    QHash<quint16, int> paletteIndex;
+    indexes.reserve(pixels.size());
+    for (quint16 pixel : pixels)
+    {
+        QHash<quint16, int>::const_iterator it = paletteIndex.constFind(pixel);
+        if (it == paletteIndex.constEnd())
+        {
+            if (palette.size() == 256)
+            {
+                palette.clear();
+                break;
+            }
+            it = paletteIndex.insert(pixel, palette.size());
+            palette.append(pixel);
         }
+        indexes.append(*it);
+    }
+    if (palette.isEmpty())
+        format = FormatRaw;
+
+    int bpp = 1;
+    while ((1 << bpp) < palette.size())
+        bpp *= 2;
+
+    QByteArray packed;
+    QByteArray rle;
+    if (format != FormatRaw)
+    {
+        packIndexes(packed, indexes, 0, indexes.size(), bpp);
+        rle = rleIndexes(indexes, bpp);
+    }
+    int rawSize = pixels.size() * 2;
+    int packedSize = palette.size() * 2 + packed.size();
+    int rleSize = palette.size() * 2 + rle.size();
+    if (format == FormatAuto)
+    {
+        format = FormatRaw;
+        if (packedSize < rawSize)
+            format = FormatPalette;
+        if (rleSize < packedSize && rleSize < rawSize)
+            format = FormatRle;
     }
-    stream << endl << "};\n" << endl;
 
-    // creating the Picture structure
-    stream << "// the image structure {width, height, data}" << endl;
-    stream << "const Picture " << finfo.baseName() << " = {" << image.width()
-           << ", " << image.height() << ", " << finfo.baseName() << "_data};";
+    // starting preprocessor instructions
+    stream << "#include <gui/picture.h>" << endl;
+    stream << endl;
+
+    if (format == FormatRaw)
+    {
+        // creating an array containnig the image data
+        stream << "// an array containnig the image data" << endl;
+        stream << "__prog__ const uint16_t " << finfo.baseName() << "_data[] __space_prog__ = {";
+        writeWords(stream, pixels, mirrored.height());
+        stream << endl << "};\n" << endl;
+
+        // creating the Picture structure
+        stream << "// the image structure {width, height, data}" << endl;
+        stream << "const Picture " << finfo.baseName() << " = {" << image.width() << ", " << image.height() << ", "
+               << finfo.baseName() << "_data};";
+        *dataSize = rawSize;
+    }
+    else
+    {
+        const QByteArray &data = (format == FormatRle) ? rle : packed;
+
+        stream << "// palette of " << palette.size() << " RGB565 colors" << endl;
+        stream << "__prog__ const uint16_t " << finfo.baseName() << "_palette[] __space_prog__ = {";
+        writeWords(stream, palette, 16);
+        stream << endl << "};\n" << endl;
+
+        stream << "// " << bpp << " bit" << ((bpp > 1) ? "s" : "") << " palette indexes, "
+               << ((format == FormatRle) ? "run length encoded" : "packed") << endl;
+        stream << "__prog__ const uint8_t " << finfo.baseName() << "_indexes[] __space_prog__ = {";
+        for (int i = 0; i < data.size(); ++i)
+        {
+            if (i % 24 == 0)
+                stream << endl;
+            stream << "0x" << QString::number(static_cast<quint8>(data[i]), 16);
+            if (i != data.size() - 1)
+                stream << ", ";
+        }
+        stream << endl << "};\n" << endl;
+
+        stream << "// the image structure {width, height, palette, format, bpp, indexes}" << endl;
+        stream << "const Picture " << finfo.baseName() << " = {" << image.width() << ", " << image.height() << ", "
+               << finfo.baseName() << "_palette, " << pictureFormatNames[format] << ", " << bpp << ", "
+               << finfo.baseName() << "_indexes};";
+        *dataSize = (format == FormatRle) ? rleSize : packedSize;
+    }
 
     file.close();
+    return format;
+}
+
+/**
+ * @brief C name of a font, family followed by size and style (b, u, i)
+ */
+QString fontVarName(const QFont &font)
+{
+    QString fontName = font.family().replace(" ", "_");
+    // if (fontName.size()>10) fontName = fontName.mid(0,10);
+    if (font.pixelSize() != -1)
+        fontName.append(QString::number(font.pixelSize()));
+    else
+        fontName.append(QString::number(font.pointSize()));
+    if (font.bold())
+        fontName.append("b");
+    if (font.underline())
+        fontName.append("u");
+    if (font.italic())
+        fontName.append("i");
+    return fontName;
 }
 
 /**
@@ -91,22 +288,10 @@ void exportFont(QFont font, QString outFileName)
 
     QTextStream stream(&file);
 
-    QString fontName;
     QFontMetrics metric(font);
     height = metric.height();
 
-    fontName = font.family().replace(" ", "_");
-    // if (fontName.size()>10) fontName = fontName.mid(0,10);
-    if (font.pixelSize() != -1)
-        fontName.append(QString::number(font.pixelSize()));
-    else
-        fontName.append(QString::number(font.pointSize()));
-    if (font.bold())
-        fontName.append("b");
-    if (font.underline())
-        fontName.append("u");
-    if (font.italic())
-        fontName.append("i");
+    QString fontName = fontVarName(font);
 
     stream << QString("#ifndef _") + fontName + QString("_font_") << endl;
     stream << QString("#define _") + fontName + QString("_font_") << endl
@@ -207,6 +392,196 @@ void exportFont(QFont font, QString outFileName)
     letters.save(outFileName + ".png");
 }
 
+/**
+ * @brief Parses a list of character ranges, "32-126,160-255", "ascii" or "latin1"
+ * @return sorted ranges, empty on error
+ */
+QList<QPair<int, int>> parseRanges(QString rangesText)
+{
+    QList<QPair<int, int>> ranges;
+    rangesText.replace("latin1", "32-126,160-255").replace("ascii", "32-126");
+    for (const QString &rangeText : rangesText.split(',', QString::SkipEmptyParts))
+    {
+        QStringList bounds = rangeText.split('-');
+        bool okFirst, okLast;
+        int first = bounds.first().toInt(&okFirst, 0);
+        int last = bounds.last().toInt(&okLast, 0);
+        if (bounds.size() > 2 || !okFirst || !okLast || first > last || first < 1 || last > 255)
+            return QList<QPair<int, int>>();
+        ranges.append(qMakePair(first, last));
+    }
+    std::sort(ranges.begin(), ranges.end());
+    for (int i = 1; i < ranges.size(); i++)
+    {
+        if (ranges[i].first <= ranges[i - 1].second)
+            return QList<QPair<int, int>>();
+    }
+    return ranges;
+}
+
+static QString charComment(int c)
+{
+    if (c > ' ' && c < 127 && c != '\\')
+        return QString("// '%1' (%2)").arg(QChar(c)).arg(c);
+    return QString("// (%1)").arg(c);
+}
+
+/**
+ * @brief exportPackedFont writes all glyphs in one blob with an offset table,
+ * pixels are pen coverage on bpp bits (1, 2 or 4), see "gui/font.h"
+ */
+bool exportPackedFont(QFont font, const QString &outFileName, int bpp, const QList<QPair<int, int>> &ranges)
+{
+    QFile file(outFileName);
+    file.open(QIODevice::WriteOnly | QIODevice::Text);
+    QTextStream stream(&file);
+
+    font.setStyleStrategy((bpp == 1) ? QFont::NoAntialias : QFont::PreferAntialias);
+    QFontMetrics metric(font);
+    int height = metric.height();
+    int maxLevel = (1 << bpp) - 1;
+    QString fontName = fontVarName(font);
+
+    QList<int> chars;
+    for (const QPair<int, int> &range : ranges)
+    {
+        for (int c = range.first; c <= range.second; c++)
+            chars.append(c);
+    }
+
+    QByteArray glyphs;
+    QList<int> offsets;
+    QList<int> widths;
+    QStringList glyphLines;
+    int previewWidth = 0;
+    for (int c : chars)
+    {
+        int width = qMin(metric.width(QChar(c)), 255);
+        offsets.append(glyphs.size());
+        widths.append(width);
+        previewWidth += width;
+
+        QImage letter(qMax(width, 1), height, QImage::Format_ARGB32);
+        letter.fill(Qt::white);
+        QPainter paint(&letter);
+        paint.setFont(font);
+        paint.setPen(Qt::black);
+        paint.drawText(QRect(0, 0, letter.width(), height), Qt::AlignLeft | Qt::AlignTop, QString(QChar(c)));
+        paint.end();
+
+        QStringList bytes;
+        int byte = 0;
+        int bitsLeft = 8;
+        for (int x = 0; x < width; ++x)
+        {
+            for (int y = 0; y < height; ++y)
+            {
+                int level = ((255 - qGray(letter.pixel(x, y))) * maxLevel + 127) / 255;
+                bitsLeft -= bpp;
+                byte |= level << bitsLeft;
+                if (bitsLeft == 0)
+                {
+                    glyphs.append(static_cast<char>(byte));
+                    bytes.append("0x" + QString::number(byte, 16).toUpper().rightJustified(2, '0'));
+                    byte = 0;
+                    bitsLeft = 8;
+                }
+            }
+        }
+        if (bitsLeft != 8)
+        {
+            glyphs.append(static_cast<char>(byte));
+            bytes.append("0x" + QString::number(byte, 16).toUpper().rightJustified(2, '0'));
+        }
+        glyphLines.append(charComment(c) + "\n" + (bytes.isEmpty() ? QString() : ("    " + bytes.join(", ") + ",\n")));
+    }
+    if (glyphs.size() > 0xFFFF)
+    {
+        QTextStream(stdout) << "Font " << fontName << " glyphs exceed 64 KiB, reduce ranges or bpp." << endl;
+        return false;
+    }
+
+    // kerning pairs, advance difference of the pair compared to separate characters
+    QStringList kernings;
+    for (int left : chars)
+    {
+        for (int right : chars)
+        {
+            QString pair = QString(QChar(left)) + QChar(right);
+            int offset = metric.width(pair) - metric.width(QChar(left)) - metric.width(QChar(right));
+            if (offset != 0 && offset >= -128 && offset <= 127)
+                kernings.append(QString("{%1, %2, %3}").arg(left).arg(right).arg(offset));
+        }
+    }
+
+    stream << QString("#ifndef _") + fontName + QString("_font_") << endl;
+    stream << QString("#define _") + fontName + QString("_font_") << endl << endl;
+    stream << "#include <stddef.h>" << endl;
+    stream << QString("#include \"gui/font.h\"") << endl << endl;
+
+    stream << "// glyphs, " << bpp << " bit" << ((bpp > 1) ? "s" : "") << " per pixel, column by column" << endl;
+    stream << "const uint8_t " << fontName << "_glyphs[] = {" << endl;
+    for (const QString &line : glyphLines)
+        stream << "    " << line;
+    stream << "};" << endl << endl;
+
+    stream << "const uint16_t " << fontName << "_offsets[] = {";
+    for (int i = 0; i < offsets.size(); i++)
+        stream << ((i % 16 == 0) ? "\n    " : " ") << offsets[i] << ",";
+    stream << endl << "};" << endl << endl;
+
+    stream << "const uint8_t " << fontName << "_widths[] = {";
+    for (int i = 0; i < widths.size(); i++)
+        stream << ((i % 16 == 0) ? "\n    " : " ") << widths[i] << ",";
+    stream << endl << "};" << endl << endl;
+
+    stream << "// {first, last, glyph}" << endl;
+    stream << "const FontRange " << fontName << "_ranges[] = {";
+    int glyph = 0;
+    for (const QPair<int, int> &range : ranges)
+    {
+        stream << "{" << range.first << ", " << range.second << ", " << glyph << "}, ";
+        glyph += range.second - range.first + 1;
+    }
+    stream << "};" << endl << endl;
+
+    if (!kernings.isEmpty())
+    {
+        stream << "// kerning pairs {left, right, offset}" << endl;
+        stream << "const FontKerning " << fontName << "_kernings[] = {";
+        for (int i = 0; i < kernings.size(); i++)
+            stream << ((i % 8 == 0) ? "\n    " : " ") << kernings[i] << ",";
+        stream << endl << "};" << endl << endl;
+    }
+
+    stream << "// Font structure" << endl;
+    stream << "const Font " << fontName << " = {" << height << ", " << ranges.first().first << ", "
+           << ranges.last().second << ", NULL, " << bpp << ", " << ranges.size() << ", " << fontName << "_ranges, "
+           << fontName << "_widths, " << fontName << "_offsets, " << fontName << "_glyphs, " << kernings.size() << ", "
+           << (kernings.isEmpty() ? QString("NULL") : fontName + "_kernings") << "};" << endl;
+    stream << "#endif";
+    file.close();
+
+    // preview
+    QImage letters(qMax(previewWidth, 1), height, QImage::Format_ARGB32);
+    letters.fill(Qt::white);
+    QPainter paint(&letters);
+    paint.setFont(font);
+    paint.setPen(Qt::black);
+    int x = 0;
+    for (int i = 0; i < chars.size(); i++)
+    {
+        paint.drawText(QRect(x, 0, qMax(widths[i], 1), height), Qt::AlignLeft | Qt::AlignTop, QString(QChar(chars[i])));
+        x += widths[i];
+    }
+    paint.end();
+    letters.save(outFileName + ".png");
+
+    QTextStream(stdout) << "Font " << fontName << " " << chars.size() << " glyphs, " << glyphs.size() << " bytes, "
+                        << kernings.size() << " kerning pairs" << endl;
+    return true;
+}
+
 int main(int argc, char *argv[])
 {
     QApplication app(argc, argv);
@@ -229,6 +604,28 @@ int main(int argc, char *argv[])
                                     "Write generated data into <file>.",
                                     "image.c");
     parser.addOption(outputOption);
+    QCommandLineOption formatOption(QStringList() << "f"
+                                                  << "format",
+                                    "Picture format: auto (smallest), raw, palette or rle.",
+                                    "format",
+                                    "auto");
+    parser.addOption(formatOption);
+    QCommandLineOption bppOption(QStringList() << "b"
+                                               << "bpp",
+                                 "Font bits per pixel: 1, 2 or 4 (anti-aliased).",
+                                 "bpp",
+                                 "1");
+    parser.addOption(bppOption);
+    QCommandLineOption rangesOption(QStringList() << "r"
+                                                  << "ranges",
+                                    "Font characters: ascii, latin1 or list of ranges (32-126,160-255).",
+                                    "ranges",
+                                    "ascii");
+    parser.addOption(rangesOption);
+    QCommandLineOption lettersOption(QStringList() << "l"
+                                                   << "letters",
+                                     "Font with one letter struct per character (' ' to 'z', 1 bpp).");
+    parser.addOption(lettersOption);
 
     parser.process(app);
 
@@ -268,9 +665,21 @@ int main(int argc, char *argv[])
             out << "Invalid image file format." << endl;
             return 1;
         }
-        exportImage(image, outputFile);
+        QStringList formats;
+        formats << "raw"
+                << "palette"
+                << "rle";
+        PictureFormat format = static_cast<PictureFormat>(formats.indexOf(parser.value(formatOption)));
+        if (format == FormatAuto && parser.value(formatOption) != "auto")
+        {
+            out << "Unknown picture format " << parser.value(formatOption) << "." << endl;
+            return 1;
+        }
+        int dataSize = 0;
+        format = exportImage(image, outputFile, format, &dataSize);
         out << "Image " << inputFile << " " << image.size().width() << " x "
-            << image.size().height() << " px" << endl;
+            << image.size().height() << " px, " << formats[format] << " "
+            << dataSize << " bytes" << endl;
 
         return 0;
     }
@@ -288,9 +697,25 @@ int main(int argc, char *argv[])
 
         QFont font(fontName, fontSize, bold, italic);
         out << "fontSize: " << fontSize << " family: " << font.family() << endl;
-        exportFont(font, outputFile);
+        if (parser.isSet(lettersOption))
+        {
+            exportFont(font, outputFile);
+            return 0;
+        }
 
-        return 0;
+        int bpp = parser.value(bppOption).toInt();
+        if (bpp != 1 && bpp != 2 && bpp != 4)
+        {
+            out << "Invalid font bpp " << parser.value(bppOption) << "." << endl;
+            return 1;
+        }
+        QList<QPair<int, int>> ranges = parseRanges(parser.value(rangesOption));
+        if (ranges.isEmpty())
+        {
+            out << "Invalid font ranges " << parser.value(rangesOption) << "." << endl;
+            return 1;
+        }
+        return exportPackedFont(font, outputFile, bpp, ranges) ? 0 : 1;
     }
 
     return 1;
@@ -2,4 +2,5 @@ TEMPLATE = subdirs
 
 SUBDIRS += a6kontrol \
            udk-sim \
-           img2raw
+           img2raw \
+           udk-log
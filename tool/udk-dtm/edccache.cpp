@@ -0,0 +1,171 @@
+#include "edccache.h"
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QSaveFile>
+
+const quint32 EDCCache::magic = 0x45444343;  // EDCC
+const quint16 EDCCache::version = 1;
+
+EDCCache::EDCCache(const QString &path)
+    : _path(path)
+{
+    _modified = false;
+    _hitCount = 0;
+    _parseCount = 0;
+}
+
+bool EDCCache::load()
+{
+    QFile file(_path);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_0);
+
+    quint32 fileMagic;
+    quint16 fileVersion;
+    stream >> fileMagic >> fileVersion;
+    if (fileMagic != magic || fileVersion != version)
+    {
+        return false;
+    }
+
+    quint32 count;
+    stream >> count;
+    for (quint32 i = 0; i < count && stream.status() == QDataStream::Ok; i++)
+    {
+        QString fileName;
+        Entry entry;
+        quint32 sfrCount;
+
+        stream >> fileName >> entry.mtime >> entry.size >> entry.hash >> entry.device.name >> sfrCount;
+        entry.device.sfrs.reserve(sfrCount);
+        for (quint32 j = 0; j < sfrCount && stream.status() == QDataStream::Ok; j++)
+        {
+            EDCSFRDef sfr;
+            quint32 addr;
+            stream >> sfr.name >> addr;
+            sfr.adrr = addr;
+            entry.device.sfrs.append(sfr);
+        }
+        _entries.insert(fileName, entry);
+    }
+
+    if (stream.status() != QDataStream::Ok)
+    {
+        _entries.clear();
+        return false;
+    }
+    return true;
+}
+
+bool EDCCache::save() const
+{
+    QMutexLocker locker(&_mutex);
+    if (!_modified)
+    {
+        return true;
+    }
+
+    QSaveFile file(_path);
+    if (!file.open(QIODevice::WriteOnly))
+    {
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_0);
+
+    stream << magic << version << (quint32)_entries.count();
+    for (QHash<QString, Entry>::const_iterator it = _entries.cbegin(); it != _entries.cend(); ++it)
+    {
+        const Entry &entry = it.value();
+        stream << it.key() << entry.mtime << entry.size << entry.hash << entry.device.name
+               << (quint32)entry.device.sfrs.count();
+        for (const EDCSFRDef &sfr : entry.device.sfrs)
+        {
+            stream << sfr.name << (quint32)sfr.adrr;
+        }
+    }
+
+    return file.commit();
+}
+
+/**
+ * @brief Gives the device description of an EDC file, from cache if the file
+ * is unchanged (same mtime and size or same content hash), parsed else.
+ * Thread safe.
+ */
+EDCDevice EDCCache::device(const QString &fileName)
+{
+    QFileInfo fileInfo(fileName);
+    qint64 mtime = fileInfo.lastModified().toMSecsSinceEpoch();
+    qint64 size = fileInfo.size();
+    QByteArray hash;
+
+    {
+        QMutexLocker locker(&_mutex);
+        QHash<QString, Entry>::iterator it = _entries.find(fileName);
+        if (it != _entries.end() && it.value().mtime == mtime && it.value().size == size)
+        {
+            _hitCount++;
+            return it.value().device;
+        }
+    }
+
+    // timestamp changed, content could be the same (pack reinstalled)
+    QFile file(fileName);
+    if (file.open(QIODevice::ReadOnly))
+    {
+        QCryptographicHash hasher(QCryptographicHash::Md5);
+        hasher.addData(&file);
+        hash = hasher.result();
+        file.close();
+    }
+
+    {
+        QMutexLocker locker(&_mutex);
+        QHash<QString, Entry>::iterator it = _entries.find(fileName);
+        if (it != _entries.end() && it.value().hash == hash)
+        {
+            it.value().mtime = mtime;
+            it.value().size = size;
+            _modified = true;
+            _hitCount++;
+            return it.value().device;
+        }
+    }
+
+    Entry entry;
+    EDCParser parser(fileName);
+    entry.mtime = mtime;
+    entry.size = size;
+    entry.hash = hash;
+    entry.device.name = parser.name();
+    entry.device.sfrs = parser.sfrs();
+
+    QMutexLocker locker(&_mutex);
+    _entries.insert(fileName, entry);
+    _modified = true;
+    _parseCount++;
+    return entry.device;
+}
+
+int EDCCache::hitCount() const
+{
+    QMutexLocker locker(&_mutex);
+    return _hitCount;
+}
+
+int EDCCache::parseCount() const
+{
+    QMutexLocker locker(&_mutex);
+    return _parseCount;
+}
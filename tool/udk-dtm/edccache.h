@@ -0,0 +1,51 @@
+#ifndef EDCCACHE_H
+#define EDCCACHE_H
+
+#include <QByteArray>
+#include <QDateTime>
+#include <QHash>
+#include <QMutex>
+#include <QString>
+
+#include "edcparser.h"
+
+struct EDCDevice
+{
+    QString name;
+    QList<EDCSFRDef> sfrs;
+};
+
+class EDCCache
+{
+public:
+    EDCCache(const QString &path);
+
+    bool load();
+    bool save() const;
+
+    EDCDevice device(const QString &fileName);
+
+    int hitCount() const;
+    int parseCount() const;
+
+protected:
+    struct Entry
+    {
+        qint64 mtime;
+        qint64 size;
+        QByteArray hash;
+        EDCDevice device;
+    };
+
+    QString _path;
+    QHash<QString, Entry> _entries;
+    mutable QMutex _mutex;
+    bool _modified;
+    int _hitCount;
+    int _parseCount;
+
+    static const quint32 magic;
+    static const quint16 version;
+};
+
+#endif // EDCCACHE_H
@@ -1,16 +1,38 @@
 #include <QCoreApplication>
 
 #include "cwritter.h"
+#include "edccache.h"
 #include "edcparser.h"
 
 #include <QCollator>
+#include <QCommandLineParser>
 #include <QDebug>
 #include <QDirIterator>
 #include <QRegularExpression>
+#include <QtConcurrent>
+
+// functor to load devices in thread pool
+struct DeviceLoader
+{
+    DeviceLoader(EDCCache *cache)
+        : _cache(cache)
+    {
+    }
+
+    typedef EDCDevice result_type;
+    EDCDevice operator()(const QString &fileName)
+    {
+        return _cache->device(fileName);
+    }
+
+    EDCCache *_cache;
+};
 
 int main(int argc, char *argv[])
 {
-    QCoreApplication a(argc, argv);
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("udk-dtm");
+    QCoreApplication::setApplicationVersion("1.0");
 
 #ifdef WIN32
     QString edsPath = "C:/Program Files (x86)/Microchip/MPLABX/v5.40/packs/Microchip/";
@@ -18,10 +40,40 @@ int main(int argc, char *argv[])
     QString edsPath = "/opt/microchip/mplabx/v5.40/packs/Microchip/";
     // QString edsPath = "/opt/microchip/mplabx/v5.25/packs/Microchip/";
 #endif
-    QString picFilter = "(DSPIC33|PIC24)[CE]";
-    QString sfrFilter = "ADCBUF([0-9]+)";
-    QString deviceName = "ADC";
-    QString outputFileName = "adc_dspic33.h";
+
+    QCommandLineParser cmdParser;
+    cmdParser.setApplicationDescription("Tool to extract device SFR tables from MPLAB X packs and \
+generate per family driver headers");
+    cmdParser.addHelpOption();
+    cmdParser.addVersionOption();
+
+    QCommandLineOption packOption(QStringList() << "p" << "pack", "MPLAB X Microchip packs <path>.", "path", edsPath);
+    cmdParser.addOption(packOption);
+    QCommandLineOption picOption(QStringList() << "c" << "cpu", "Regular expression <filter> of device files.", "filter",
+                                 "(DSPIC33|PIC24)[CE]");
+    cmdParser.addOption(picOption);
+    QCommandLineOption sfrOption(QStringList() << "s" << "sfr",
+                                 "Regular expression <filter> of SFR, with the channel id captured.", "filter",
+                                 "ADCBUF([0-9]+)");
+    cmdParser.addOption(sfrOption);
+    QCommandLineOption nameOption(QStringList() << "n" << "name", "Peripheral <name> prefix of defines.", "name", "ADC");
+    cmdParser.addOption(nameOption);
+    QCommandLineOption outputOption(QStringList() << "o" << "output", "Write generated header into <file>.", "file",
+                                    "adc_dspic33.h");
+    cmdParser.addOption(outputOption);
+    QCommandLineOption cacheOption(QStringList() << "cache", "Binary SFR cache <file>.", "file",
+                                   QDir(QDir::tempPath()).filePath("udk-dtm.cache"));
+    cmdParser.addOption(cacheOption);
+    QCommandLineOption noCacheOption(QStringList() << "no-cache", "Parse all device files, without cache.");
+    cmdParser.addOption(noCacheOption);
+
+    cmdParser.process(app);
+
+    edsPath = cmdParser.value(packOption);
+    QString picFilter = cmdParser.value(picOption);
+    QString sfrFilter = cmdParser.value(sfrOption);
+    QString deviceName = cmdParser.value(nameOption);
+    QString outputFileName = cmdParser.value(outputOption);
 
     QStringList fileList;
     QRegularExpression picFileRegExp(picFilter);
@@ -39,18 +91,27 @@ int main(int argc, char *argv[])
     }
     qDebug() << fileList.count() << "files matches on" << fileCount << "files.";
 
+    // parse or get from cache all devices, in parallel
+    EDCCache cache(cmdParser.value(cacheOption));
+    if (!cmdParser.isSet(noCacheOption))
+    {
+        cache.load();
+    }
+    QList<EDCDevice> devices = QtConcurrent::blockingMapped<QList<EDCDevice>>(fileList, DeviceLoader(&cache));
+    if (!cache.save())
+    {
+        qWarning() << "Cannot write cache" << cmdParser.value(cacheOption);
+    }
+    qDebug() << cache.hitCount() << "devices from cache," << cache.parseCount() << "parsed.";
+
     QMultiMap<QString, QString> adbuffCpu;
     QMultiMap<QString, QString> cpuAadbuff;
 
     QRegularExpression sfrRegExp(sfrFilter);
-    int fi = 0;
-    for (const QString &fileName : fileList)
+    for (const EDCDevice &device : devices)
     {
-        QFileInfo fileInfo(fileName);
         QStringList sfrList;
-        qDebug() << ++fi << "/" << fileList.count() << fileInfo.fileName();
-        EDCParser parser(fileName);
-        for (const EDCSFRDef &sfr : parser.sfrs())
+        for (const EDCSFRDef &sfr : device.sfrs)
         {
             if (sfrRegExp.match(sfr.name).hasMatch())
             {
@@ -64,7 +125,7 @@ int main(int argc, char *argv[])
             adBuff.replace(QRegularExpression("\\(.*\\)"), QString::number(i));
             if (sfrList.contains(adBuff))
             {
-                QString deviceName = parser.name();
+                QString deviceName = device.name;
                 deviceName.replace("DSPIC", "DEVICE_");
                 deviceName.replace("PIC", "DEVICE_");
                 adbuffCpu.insertMulti(adBuff, deviceName);
@@ -1,4 +1,5 @@
 QT -= gui xml
+QT += concurrent
 
 CONFIG += c++11 console
 CONFIG -= app_bundle
@@ -16,6 +17,7 @@ DEFINES += QT_DEPRECATED_WARNINGS
 
 SOURCES += \
         cwritter.cpp \
+        edccache.cpp \
         edcparser.cpp \
         main.cpp
 
@@ -26,4 +28,5 @@ else: unix:!android: target.path = /opt/$${TARGET}/bin
 
 HEADERS += \
     cwritter.h \
+    edccache.h \
     edcparser.h
@@ -0,0 +1,347 @@
+/**
+ * @file main.cpp
+ * @author agent
+ * @copyright UniSwarm 2026
+ *
+ * @date October 19, 2026, 07:50 PM
+ *
+ * @brief Host decoder of the log module binary stream
+ *
+ * udk-log firmware.elf [stream]
+ *
+ * Format strings are read from the .udklog section of the firmware ELF file,
+ * the stream is a file, a tty already configured (stty) or stdin by default.
+ * See support/module/log/log.h for the record format.
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#define LOG_SYNC       0xA5
+#define LOG_MAX_ARGS   6
+#define LOG_ID_DROPPED 0xFFFFFFFF
+
+struct LogStrings
+{
+    std::vector<uint8_t> section;
+    uint64_t sectionAddr;
+    uint64_t baseAddr;
+};
+
+static uint64_t readLe(const std::vector<uint8_t> &data, size_t offset, int size)
+{
+    uint64_t value = 0;
+    if (offset + size > data.size())
+    {
+        return 0;
+    }
+    for (int i = size - 1; i >= 0; i--)
+    {
+        value = (value << 8) | data[offset + i];
+    }
+    return value;
+}
+
+static std::string readString(const std::vector<uint8_t> &data, size_t offset)
+{
+    std::string str;
+    while (offset < data.size() && data[offset] != 0)
+    {
+        str.push_back(static_cast<char>(data[offset++]));
+    }
+    return str;
+}
+
+/**
+ * @brief Loads the .udklog section and the log_base symbol from a little endian ELF32 or ELF64 file
+ */
+static bool loadElf(const char *fileName, LogStrings &strings)
+{
+    FILE *file = fopen(fileName, "rb");
+    if (file == nullptr)
+    {
+        fprintf(stderr, "udk-log: cannot open '%s'\n", fileName);
+        return false;
+    }
+    std::vector<uint8_t> elf;
+    uint8_t chunk[4096];
+    size_t size;
+    while ((size = fread(chunk, 1, sizeof(chunk), file)) > 0)
+    {
+        elf.insert(elf.end(), chunk, chunk + size);
+    }
+    fclose(file);
+
+    if (elf.size() < 52 || memcmp(elf.data(), "\x7F" "ELF", 4) != 0 || elf[5] != 1)
+    {
+        fprintf(stderr, "udk-log: '%s' is not a little endian ELF file\n", fileName);
+        return false;
+    }
+    bool is64 = (elf[4] == 2);
+    int addrSize = is64 ? 8 : 4;
+    uint64_t shoff = readLe(elf, is64 ? 0x28 : 0x20, addrSize);
+    uint64_t shentsize = readLe(elf, is64 ? 0x3A : 0x2E, 2);
+    uint64_t shnum = readLe(elf, is64 ? 0x3C : 0x30, 2);
+    uint64_t shstrndx = readLe(elf, is64 ? 0x3E : 0x32, 2);
+
+    struct Section
+    {
+        uint32_t name;
+        uint32_t type;
+        uint64_t addr;
+        uint64_t offset;
+        uint64_t size;
+        uint32_t link;
+    };
+    std::vector<Section> sections;
+    for (uint64_t i = 0; i < shnum; i++)
+    {
+        size_t sh = shoff + i * shentsize;
+        Section section;
+        section.name = readLe(elf, sh, 4);
+        section.type = readLe(elf, sh + 4, 4);
+        section.addr = readLe(elf, sh + (is64 ? 0x10 : 0x0C), addrSize);
+        section.offset = readLe(elf, sh + (is64 ? 0x18 : 0x10), addrSize);
+        section.size = readLe(elf, sh + (is64 ? 0x20 : 0x14), addrSize);
+        section.link = readLe(elf, sh + (is64 ? 0x28 : 0x18), 4);
+        sections.push_back(section);
+    }
+    if (shstrndx >= sections.size())
+    {
+        fprintf(stderr, "udk-log: invalid section table in '%s'\n", fileName);
+        return false;
+    }
+
+    int logSection = -1;
+    int symtabSection = -1;
+    for (size_t i = 0; i < sections.size(); i++)
+    {
+        std::string name = readString(elf, sections[shstrndx].offset + sections[i].name);
+        if (name == ".udklog")
+        {
+            logSection = static_cast<int>(i);
+        }
+        else if (sections[i].type == 2)  // SHT_SYMTAB
+        {
+            symtabSection = static_cast<int>(i);
+        }
+    }
+    if (logSection < 0 || symtabSection < 0)
+    {
+        fprintf(stderr, "udk-log: no .udklog section or no symbol table in '%s'\n", fileName);
+        return false;
+    }
+
+    const Section &log = sections[logSection];
+    strings.section.assign(elf.begin() + log.offset, elf.begin() + log.offset + log.size);
+    strings.sectionAddr = log.addr;
+
+    const Section &symtab = sections[symtabSection];
+    const Section &strtab = sections[symtab.link];
+    size_t symSize = is64 ? 24 : 16;
+    for (uint64_t sym = symtab.offset; sym + symSize <= symtab.offset + symtab.size; sym += symSize)
+    {
+        if (readString(elf, strtab.offset + readLe(elf, sym, 4)) == "log_base")
+        {
+            strings.baseAddr = readLe(elf, sym + (is64 ? 8 : 4), addrSize);
+            return true;
+        }
+    }
+    fprintf(stderr, "udk-log: no log_base symbol in '%s'\n", fileName);
+    return false;
+}
+
+static const char *formatString(const LogStrings &strings, uint32_t id)
+{
+    uint64_t addr = strings.baseAddr + static_cast<int32_t>(id);
+    uint64_t offset = addr - strings.sectionAddr;
+    if (offset >= strings.section.size())
+    {
+        return nullptr;
+    }
+    return reinterpret_cast<const char *>(strings.section.data() + offset);
+}
+
+/**
+ * @brief printf like formatting of 32 bits raw arguments
+ */
+static std::string format(const char *fmt, const std::vector<uint32_t> &args)
+{
+    std::string out;
+    size_t argId = 0;
+    char buff[128];
+
+    while (*fmt != 0)
+    {
+        if (*fmt != '%')
+        {
+            out.push_back(*fmt++);
+            continue;
+        }
+        fmt++;
+        if (*fmt == '%')
+        {
+            out.push_back(*fmt++);
+            continue;
+        }
+
+        // flags, width and precision are kept, length modifiers are replaced
+        std::string spec = "%";
+        while (*fmt != 0 && strchr("-+ #0123456789.", *fmt) != nullptr)
+        {
+            spec.push_back(*fmt++);
+        }
+        while (*fmt != 0 && strchr("hlLqjzt", *fmt) != nullptr)
+        {
+            fmt++;
+        }
+        char conv = *fmt;
+        if (conv == 0)
+        {
+            break;
+        }
+        fmt++;
+
+        if (argId >= args.size())
+        {
+            out += "<?>";
+            continue;
+        }
+        uint32_t arg = args[argId++];
+        switch (conv)
+        {
+            case 'd':
+            case 'i':
+                snprintf(buff, sizeof(buff), (spec + "ld").c_str(), static_cast<long>(static_cast<int32_t>(arg)));
+                break;
+
+            case 'u':
+            case 'o':
+            case 'x':
+            case 'X':
+                snprintf(buff, sizeof(buff), (spec + "l" + conv).c_str(), static_cast<unsigned long>(arg));
+                break;
+
+            case 'c':
+                snprintf(buff, sizeof(buff), (spec + "c").c_str(), static_cast<int>(arg));
+                break;
+
+            case 'f':
+            case 'F':
+            case 'e':
+            case 'E':
+            case 'g':
+            case 'G':
+            {
+                float value;
+                memcpy(&value, &arg, sizeof(value));
+                snprintf(buff, sizeof(buff), (spec + conv).c_str(), static_cast<double>(value));
+                break;
+            }
+
+            case 'p':
+                snprintf(buff, sizeof(buff), "0x%08lx", static_cast<unsigned long>(arg));
+                break;
+
+            default:
+                snprintf(buff, sizeof(buff), "<%%%c unsupported>", conv);
+                break;
+        }
+        out += buff;
+    }
+    return out;
+}
+
+static bool readBytes(FILE *stream, uint8_t *data, size_t size)
+{
+    for (size_t i = 0; i < size; i++)
+    {
+        int c = fgetc(stream);
+        if (c == EOF)
+        {
+            return false;
+        }
+        data[i] = static_cast<uint8_t>(c);
+    }
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2 || argc > 3)
+    {
+        fprintf(stderr, "usage: udk-log firmware.elf [stream]\n");
+        return 1;
+    }
+
+    LogStrings strings;
+    if (!loadElf(argv[1], strings))
+    {
+        return 1;
+    }
+
+    FILE *stream = stdin;
+    if (argc == 3)
+    {
+        stream = fopen(argv[2], "rb");
+        if (stream == nullptr)
+        {
+            fprintf(stderr, "udk-log: cannot open '%s'\n", argv[2]);
+            return 1;
+        }
+    }
+    setvbuf(stdout, nullptr, _IOLBF, 0);
+
+    uint8_t header[5];
+    uint8_t argData[4 * LOG_MAX_ARGS];
+    int c;
+    while ((c = fgetc(stream)) != EOF)
+    {
+        if (c != LOG_SYNC)
+        {
+            continue;
+        }
+        if (!readBytes(stream, header, sizeof(header)))
+        {
+            break;
+        }
+        uint8_t argCount = header[0];
+        if (argCount > LOG_MAX_ARGS)
+        {
+            continue;  // resync
+        }
+        uint32_t id = header[1] | (header[2] << 8) | (header[3] << 16) | (static_cast<uint32_t>(header[4]) << 24);
+        if (!readBytes(stream, argData, 4 * argCount))
+        {
+            break;
+        }
+        std::vector<uint32_t> args;
+        for (int i = 0; i < argCount; i++)
+        {
+            const uint8_t *arg = argData + 4 * i;
+            args.push_back(arg[0] | (arg[1] << 8) | (arg[2] << 16) | (static_cast<uint32_t>(arg[3]) << 24));
+        }
+
+        if (id == LOG_ID_DROPPED && argCount == 1)
+        {
+            printf("<%u records dropped>\n", args[0]);
+            continue;
+        }
+        const char *fmt = formatString(strings, id);
+        if (fmt == nullptr)
+        {
+            fprintf(stderr, "udk-log: unknown id 0x%08x\n", id);
+            continue;
+        }
+        printf("%s\n", format(fmt, args).c_str());
+    }
+
+    if (stream != stdin)
+    {
+        fclose(stream);
+    }
+    return 0;
+}
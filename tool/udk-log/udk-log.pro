@@ -0,0 +1,10 @@
+CONFIG += c++11 console
+CONFIG -= app_bundle qt
+
+DESTDIR = $$PWD/../../bin
+
+TARGET = udk-log
+
+TEMPLATE = app
+
+SOURCES += main.cpp
@@ -18,11 +18,85 @@
 
 #include "mainwindow.h"
 #include <QApplication>
+#include <QRegularExpression>
 
+#include <cstdio>
+#include <cstring>
+
+#include "simfabric.h"
 #include "simserver.h"
+#include "simtopology.h"
+
+/**
+ * @brief Runs a topology without GUI, boards logs are printed on stdout and
+ * udk-sim exits when all boards are stopped
+ */
+static int runHeadless(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QStringList args = app.arguments();
+    args.removeAll("--headless");
+    if (args.size() < 2)
+    {
+        qCritical("usage: udk-sim --headless <topology.json>");
+        return 1;
+    }
+
+    SimServer *server = SimServer::instance();
+    if (!server->isConnected())
+    {
+        qErrnoWarning("Server cannot connect to port");
+        return 1;
+    }
+    server->setHeadless(true);
+
+    SimTopology topology;
+    if (!topology.load(args[1]))
+    {
+        qCritical("%s: %s", qPrintable(args[1]), qPrintable(topology.errorString()));
+        return 1;
+    }
+    server->fabric()->setTopology(topology);
+
+    int running = 0;
+    for (const SimTopology::Board &board : topology.boards())
+    {
+        SimProject *project = new SimProject(&app);
+        if (!project->setExePath(board.exePath))
+        {
+            qCritical("%s: cannot find '%s'", qPrintable(board.name), qPrintable(board.exePath));
+            return 1;
+        }
+        project->setName(board.name);
+        project->setArguments(board.args);
+        QObject::connect(project, &SimProject::logAppended, [](QString log) {
+            log.replace("<br></br>", "\n");
+            log.remove(QRegularExpression("<[^>]*>"));
+            fputs(qPrintable(log), stdout);
+        });
+        QObject::connect(project, &SimProject::stopped, [&running, &app]() {
+            if (--running == 0)
+                app.quit();
+        });
+        running++;
+        project->start();
+    }
+    if (running == 0)
+        return 0;
+
+    int ret = app.exec();
+    printf("%llu packets forwarded\n", static_cast<unsigned long long>(server->fabric()->forwardedCount()));
+    return ret;
+}
 
 int main(int argc, char *argv[])
 {
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--headless") == 0)
+            return runHeadless(argc, argv);
+    }
+
     QApplication app(argc, argv);
     app.setOrganizationName("UniSwarm");
     app.setOrganizationDomain("UniSwarm");
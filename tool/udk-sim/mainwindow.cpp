@@ -19,12 +19,16 @@
 #include "mainwindow.h"
 
 #include <QApplication>
+#include <QDockWidget>
 #include <QFileDialog>
 #include <QMenuBar>
 #include <QDebug>
 #include <QSettings>
 
+#include "simfabric.h"
 #include "simserver.h"
+#include "simtopology.h"
+#include "widgets/statswidget/statswidget.h"
 
 MainWindow::MainWindow(QStringList args)
 {
@@ -35,14 +39,27 @@ MainWindow::MainWindow(QStringList args)
     _logWidget = new QTextEdit();
     _logWidget->setReadOnly(true);
     setCentralWidget(_logWidget);
+
+    _statsDock = new QDockWidget(tr("Statistics"), this);
+    _statsDock->setObjectName("statsDock");
+    _statsDock->setWidget(new StatsWidget(_statsDock));
+    addDockWidget(Qt::BottomDockWidgetArea, _statsDock);
+    _statsDock->hide();
+
     createMenus();
     updateOldProjects();
 
     connect(SimServer::instance(), SIGNAL(clientAdded(SimClient *)), this, SLOT(setClient(SimClient *)));
+    connect(SimServer::instance(), SIGNAL(clientNamed(SimClient *)), this, SLOT(setNamedClient(SimClient *)));
     connect(_simProject, SIGNAL(logAppended(QString)), this, SLOT(appendLog(QString)));
 
     if (args.size()>1)
-        openProject(args[1]);
+    {
+        if (args[1].endsWith(".json"))
+            openTopology(args[1]);
+        else
+            openProject(args[1]);
+    }
 
     showMaximized();
 }
@@ -82,9 +99,62 @@ bool MainWindow::openProject(const QString &path)
     return true;
 }
 
+/**
+ * @brief Opens a topology file and starts all its board instances
+ */
+bool MainWindow::openTopology(const QString &path)
+{
+    QString mpath = path;
+    if (mpath.isEmpty())
+    {
+        mpath = QFileDialog::getOpenFileName(this, tr("Open topology"), QString(), tr("Topology (*.json)"));
+        if (mpath.isEmpty())
+            return false;
+    }
+
+    SimTopology topology;
+    if (!topology.load(mpath))
+    {
+        appendLog(QString("<span color='red'>%1: %2</span><br></br>").arg(mpath, topology.errorString()));
+        return false;
+    }
+
+    qDeleteAll(_topologyProjects);
+    _topologyProjects.clear();
+    SimServer::instance()->fabric()->setTopology(topology);
+
+    for (const SimTopology::Board &board : topology.boards())
+    {
+        SimProject *project = new SimProject(this);
+        if (!project->setExePath(board.exePath))
+        {
+            appendLog(QString("<span color='red'>%1: cannot find '%2'</span><br></br>").arg(board.name, board.exePath));
+            delete project;
+            continue;
+        }
+        project->setName(board.name);
+        project->setArguments(board.args);
+        connect(project, SIGNAL(logAppended(QString)), this, SLOT(appendLog(QString)));
+        _topologyProjects.append(project);
+        project->start();
+    }
+
+    return true;
+}
+
 void MainWindow::setClient(SimClient *client)
 {
-    _simProject->setClient(client);
+    if (_topologyProjects.isEmpty())
+        _simProject->setClient(client);
+}
+
+void MainWindow::setNamedClient(SimClient *client)
+{
+    for (SimProject *project : _topologyProjects)
+    {
+        if (project->name() == client->name())
+            project->setClient(client);
+    }
 }
 
 void MainWindow::createMenus()
@@ -99,6 +169,11 @@ void MainWindow::createMenus()
     openPrjAction->setShortcut(QKeySequence::Open);
     fileMenu->addAction(openPrjAction);
     connect(openPrjAction, SIGNAL(triggered()), this, SLOT(openProject()));
+
+    QAction *openTopologyAction = new QAction(tr("Open &topology"), this);
+    openTopologyAction->setStatusTip(tr("Opens a multi-board topology file"));
+    fileMenu->addAction(openTopologyAction);
+    connect(openTopologyAction, SIGNAL(triggered()), this, SLOT(openTopology()));
     fileMenu->addSeparator();
     for (int i=0; i < 8; i++)
     {
@@ -115,6 +190,13 @@ void MainWindow::createMenus()
     exitAction->setShortcut(QKeySequence::Quit);
     fileMenu->addAction(exitAction);
     connect(exitAction, &QAction::triggered, this, &QMainWindow::close);
+
+    // ============= view =============
+    QMenu *viewMenu = menuBar()->addMenu(tr("&View"));
+
+    QAction *statsAction = _statsDock->toggleViewAction();
+    statsAction->setStatusTip(tr("Shows packets and bytes exchanged with simulated programs"));
+    viewMenu->addAction(statsAction);
 }
 
 void MainWindow::writeSettings()
@@ -21,6 +21,7 @@
 
 #include <QMainWindow>
 
+#include <QDockWidget>
 #include <QTextEdit>
 
 #include "simproject.h"
@@ -35,13 +36,17 @@ public:
 
 public slots:
     bool openProject(const QString &path=QString());
+    bool openTopology(const QString &path=QString());
     void setClient(SimClient *client);
+    void setNamedClient(SimClient *client);
 
 protected:
     void createMenus();
 
     SimProject *_simProject;
+    QList<SimProject *> _topologyProjects;
     QTextEdit *_logWidget;
+    QDockWidget *_statsDock;
 
     void writeSettings();
     void readSettings();
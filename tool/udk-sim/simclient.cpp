@@ -19,6 +19,14 @@
 #include "simclient.h"
 
 #include "simmodules/simmodulefactory.h"
+#include "simfabric.h"
+#include "simserver.h"
+
+#include "archi/simulator/simulator.h"
+
+#include <QDebug>
+
+#include <cstring>
 
 SimClient::SimClient(QTcpSocket *socket)
     : _socket(socket)
@@ -35,52 +43,120 @@ SimModule *SimClient::module(uint16_t idModule, uint16_t idPeriph) const
     return Q_NULLPTR;
 }
 
+QTcpSocket *SimClient::socket() const
+{
+    return _socket;
+}
+
+/**
+ * @brief Board name announced by the simulated program, empty if none
+ */
+const QString &SimClient::name() const
+{
+    return _name;
+}
+
+/**
+ * @brief Key of stats map, module in bits 32-47, periph in 16-31 and function in 0-15
+ */
+quint64 SimClient::statsKey(uint16_t moduleId, uint16_t periphId, uint16_t functionId)
+{
+    return (static_cast<quint64>(moduleId) << 32) + (static_cast<quint64>(periphId) << 16) + functionId;
+}
+
+/**
+ * @brief Packets and bytes counters per (module, periph, function), rx is from the simulated program
+ */
+const QMap<quint64, SimClient::Stats> &SimClient::stats() const
+{
+    return _stats;
+}
+
 void SimClient::writeData(uint16_t moduleId, uint16_t periphId, uint16_t functionId, const QByteArray &data)
 {
-    char header[8];
-    QByteArray packet;
+    writeData(moduleId, periphId, functionId, data.constData(), data.size());
+}
+
+void SimClient::writeData(uint16_t moduleId, uint16_t periphId, uint16_t functionId, const char *data, int size)
+{
+    uint16_t header[4];
+
+    header[0] = static_cast<uint16_t>(size + 8);
+    header[1] = moduleId;
+    header[2] = periphId;
+    header[3] = functionId;
 
-    (reinterpret_cast<uint16_t*>(header))[0] = static_cast<uint16_t>(data.size()) + 8;
-    (reinterpret_cast<uint16_t*>(header))[1] = moduleId;
-    (reinterpret_cast<uint16_t*>(header))[2] = periphId;
-    (reinterpret_cast<uint16_t*>(header))[3] = functionId;
-    packet.append(header, 8);
-    packet.append(data);
+    _socket->write(reinterpret_cast<const char *>(header), 8);
+    _socket->write(data, size);
 
-    _socket->write(packet);
+    Stats &stats = _stats[statsKey(moduleId, periphId, functionId)];
+    stats.txPackets++;
+    stats.txBytes += static_cast<quint64>(size);
 }
 
 void SimClient::readData()
 {
     _dataReceive.append(_socket->readAll());
-    while(_dataReceive.size()>6)
+
+    // packets are parsed in place, consumed bytes are removed once
+    int offset = 0;
+    while (_dataReceive.size() - offset >= 8)
     {
-        unsigned short sizePacket = *(reinterpret_cast<unsigned short*>(_dataReceive.mid(0,2).data()));
+        const char *packet = _dataReceive.constData() + offset;
+        uint16_t header[4];
+        memcpy(header, packet, 8);
 
-        if(sizePacket>_dataReceive.size())
+        uint16_t sizePacket = header[0];
+        if (sizePacket < 8)
+        {
+            qDebug()<<"Invalid packet size"<<sizePacket;
+            _dataReceive.clear();
             return;
+        }
+        if (sizePacket > _dataReceive.size() - offset)
+            break;
 
-        unsigned short moduleId = *(reinterpret_cast<unsigned short*>(_dataReceive.mid(2,2).data()));
-        unsigned short periphId = *(reinterpret_cast<unsigned short*>(_dataReceive.mid(4,2).data()));
-        unsigned short functionId = *(reinterpret_cast<unsigned short*>(_dataReceive.mid(6,2).data()));
-        QByteArray data = _dataReceive.mid(8, sizePacket-8);
+        readPacket(header[1], header[2], header[3], packet + 8, sizePacket - 8);
+        offset += sizePacket;
+    }
+    _dataReceive.remove(0, offset);
+}
+
+void SimClient::readPacket(uint16_t moduleId, uint16_t periphId, uint16_t functionId, const char *data, int size)
+{
+    Stats &stats = _stats[statsKey(moduleId, periphId, functionId)];
+    stats.rxPackets++;
+    stats.rxBytes += static_cast<quint64>(size);
 
-        SimModule *modulePtr = module(moduleId, periphId);
-        if(!modulePtr)
+    if (moduleId == SIMULATOR_MODULE)
+    {
+        if (functionId == SIMULATOR_BOARD_NAME)
         {
-            modulePtr = SimModuleFactory::getSimModule(this, moduleId, periphId);
-            if(!modulePtr)
-            {
-                qDebug()<<"Unknow module"<<moduleId<<sizePacket;
-                _dataReceive = _dataReceive.mid(sizePacket);
-                continue;
-            }
-
-            _modules.insert(static_cast<uint32_t>((moduleId<<16) + periphId), modulePtr);
+            _name = QString::fromUtf8(data, size);
+            emit nameChanged(this);
         }
+        return;
+    }
 
-        modulePtr->pushData(functionId, data);
+    SimServer *server = SimServer::instance();
+    bool forwarded = server->fabric()->forward(this, moduleId, periphId, functionId, data, size);
+    if (forwarded && server->isHeadless())
+        return;
 
-        _dataReceive = _dataReceive.mid(sizePacket);
+    SimModule *modulePtr = module(moduleId, periphId);
+    if (!modulePtr)
+    {
+        if (server->isHeadless())
+            return;
+        modulePtr = SimModuleFactory::getSimModule(this, moduleId, periphId);
+        if (!modulePtr)
+        {
+            qDebug()<<"Unknow module"<<moduleId;
+            return;
+        }
+
+        _modules.insert(static_cast<uint32_t>((moduleId<<16) + periphId), modulePtr);
     }
+
+    modulePtr->pushData(functionId, QByteArray(data, size));
 }
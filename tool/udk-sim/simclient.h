@@ -33,17 +33,36 @@ public:
 
     SimModule *module(uint16_t idModule, uint16_t idPeriph) const;
 
+    QTcpSocket *socket() const;
+    const QString &name() const;
+
     void writeData(uint16_t moduleId, uint16_t periphId, uint16_t functionId, const QByteArray &data);
+    void writeData(uint16_t moduleId, uint16_t periphId, uint16_t functionId, const char *data, int size);
+
+    struct Stats
+    {
+        quint64 rxPackets = 0;
+        quint64 rxBytes = 0;
+        quint64 txPackets = 0;
+        quint64 txBytes = 0;
+    };
+    static quint64 statsKey(uint16_t moduleId, uint16_t periphId, uint16_t functionId);
+    const QMap<quint64, Stats> &stats() const;
 
 signals:
+    void nameChanged(SimClient *client);
 
 protected slots:
     void readData();
 
 protected:
+    void readPacket(uint16_t moduleId, uint16_t periphId, uint16_t functionId, const char *data, int size);
+
     QTcpSocket *_socket;
+    QString _name;
     QMap<uint32_t, SimModule*> _modules;
     QByteArray _dataReceive;
+    QMap<quint64, Stats> _stats;
 };
 
 #endif // SIMCLIENT_H
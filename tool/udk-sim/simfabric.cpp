@@ -0,0 +1,155 @@
+/**
+ ** This file is part of the UDK-SDK project.
+ ** Copyright 2026 UniSwarm sebastien.caux@uniswarm.eu
+ **
+ ** This program is free software: you can redistribute it and/or modify
+ ** it under the terms of the GNU General Public License as published by
+ ** the Free Software Foundation, either version 3 of the License, or
+ ** (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ ** GNU General Public License for more details.
+ **
+ ** You should have received a copy of the GNU General Public License
+ ** along with this program. If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "simfabric.h"
+
+#include "simclient.h"
+
+#include "driver/uart/uart_sim.h"
+
+SimFabric::SimFabric(QObject *parent)
+    : QObject(parent)
+{
+    _forwardedCount = 0;
+    _clock.start();
+    _delayTimer.setSingleShot(true);
+    _delayTimer.setTimerType(Qt::PreciseTimer);
+    connect(&_delayTimer, SIGNAL(timeout()), this, SLOT(flushDelayed()));
+}
+
+void SimFabric::setTopology(const SimTopology &topology)
+{
+    _topology = topology;
+    updateRoutes();
+}
+
+void SimFabric::addClient(SimClient *client)
+{
+    if (!_clients.contains(client))
+        _clients.append(client);
+    updateRoutes();
+}
+
+void SimFabric::removeClient(SimClient *client)
+{
+    _clients.removeOne(client);
+    updateRoutes();
+}
+
+/**
+ * @brief Forwards a packet received from a board to the boards linked to it
+ * @return true if the packet was routed to at least one board
+ */
+bool SimFabric::forward(SimClient *source, uint16_t moduleId, uint16_t periphId, uint16_t functionId, const char *data, int size)
+{
+    // uart and can simulator drivers share write and read function ids
+    if (functionId != UART_SIM_WRITE)
+        return false;
+
+    QHash<const SimClient *, QHash<quint32, QList<Route>>>::const_iterator clientRoutes = _routes.constFind(source);
+    if (clientRoutes == _routes.constEnd())
+        return false;
+    QHash<quint32, QList<Route>>::const_iterator routes = clientRoutes->constFind(periphKey(moduleId, periphId));
+    if (routes == clientRoutes->constEnd())
+        return false;
+
+    for (const Route &route : *routes)
+    {
+        if (route.target.isNull())
+            continue;
+        if (route.latencyMs <= 0)
+        {
+            route.target->writeData(moduleId, route.periphId, UART_SIM_READ, data, size);
+        }
+        else
+        {
+            DelayedPacket packet;
+            packet.target = route.target;
+            packet.moduleId = moduleId;
+            packet.periphId = route.periphId;
+            packet.data = QByteArray(data, size);
+            _delayed.insert(qMakePair(_clock.elapsed() + route.latencyMs, _forwardedCount), packet);
+        }
+        _forwardedCount++;
+    }
+
+    if (!_delayed.isEmpty() && !_delayTimer.isActive())
+        _delayTimer.start(static_cast<int>(qMax(Q_INT64_C(0), _delayed.firstKey().first - _clock.elapsed())));
+    return true;
+}
+
+quint64 SimFabric::forwardedCount() const
+{
+    return _forwardedCount;
+}
+
+void SimFabric::flushDelayed()
+{
+    qint64 now = _clock.elapsed();
+    while (!_delayed.isEmpty() && _delayed.firstKey().first <= now)
+    {
+        DelayedPacket packet = _delayed.take(_delayed.firstKey());
+        if (!packet.target.isNull())
+            packet.target->writeData(packet.moduleId, packet.periphId, UART_SIM_READ, packet.data);
+    }
+    if (!_delayed.isEmpty())
+        _delayTimer.start(static_cast<int>(_delayed.firstKey().first - now));
+}
+
+quint32 SimFabric::periphKey(uint16_t moduleId, uint16_t periphId)
+{
+    return (static_cast<quint32>(moduleId) << 16) | periphId;
+}
+
+/**
+ * @brief Resolves topology links to routes between connected and named clients
+ */
+void SimFabric::updateRoutes()
+{
+    _routes.clear();
+    for (const SimTopology::Link &link : _topology.links())
+    {
+        // list all connected clients matching each end of the link
+        QList<QPair<SimClient *, const SimTopology::Endpoint *>> members;
+        for (const SimTopology::Endpoint &end : link.ends)
+        {
+            for (SimClient *client : _clients)
+            {
+                if (!client->name().isEmpty() && end.matchBoard(client->name()))
+                    members.append(qMakePair(client, &end));
+            }
+        }
+
+        for (const QPair<SimClient *, const SimTopology::Endpoint *> &from : members)
+        {
+            QList<Route> &routes = _routes[from.first][periphKey(from.second->moduleId, from.second->periphId)];
+            for (const QPair<SimClient *, const SimTopology::Endpoint *> &to : members)
+            {
+                if (to.first == from.first && to.second->periphId == from.second->periphId)
+                    continue;
+                if (to.second->moduleId != from.second->moduleId)
+                    continue;
+                Route route;
+                route.target = to.first;
+                route.periphId = to.second->periphId;
+                route.latencyMs = link.latencyMs;
+                routes.append(route);
+            }
+        }
+    }
+}
@@ -0,0 +1,87 @@
+/**
+ ** This file is part of the UDK-SDK project.
+ ** Copyright 2026 UniSwarm sebastien.caux@uniswarm.eu
+ **
+ ** This program is free software: you can redistribute it and/or modify
+ ** it under the terms of the GNU General Public License as published by
+ ** the Free Software Foundation, either version 3 of the License, or
+ ** (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ ** GNU General Public License for more details.
+ **
+ ** You should have received a copy of the GNU General Public License
+ ** along with this program. If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef SIMFABRIC_H
+#define SIMFABRIC_H
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QMap>
+#include <QObject>
+#include <QPointer>
+#include <QTimer>
+
+#include "simtopology.h"
+
+class SimClient;
+
+/**
+ * @brief Routes peripheral writes between simulated boards following a
+ * topology
+ *
+ * A write received from a link end is sent to all other ends of the link as a
+ * read, directly from the client receive buffer when latency is null.
+ */
+class SimFabric : public QObject
+{
+    Q_OBJECT
+public:
+    explicit SimFabric(QObject *parent = Q_NULLPTR);
+
+    void setTopology(const SimTopology &topology);
+
+    void addClient(SimClient *client);
+    void removeClient(SimClient *client);
+
+    bool forward(SimClient *source, uint16_t moduleId, uint16_t periphId, uint16_t functionId, const char *data, int size);
+
+    quint64 forwardedCount() const;
+
+protected slots:
+    void flushDelayed();
+
+protected:
+    struct Route
+    {
+        QPointer<SimClient> target;
+        uint16_t periphId;
+        int latencyMs;
+    };
+    struct DelayedPacket
+    {
+        QPointer<SimClient> target;
+        uint16_t moduleId;
+        uint16_t periphId;
+        QByteArray data;
+    };
+
+    static quint32 periphKey(uint16_t moduleId, uint16_t periphId);
+    void updateRoutes();
+
+    SimTopology _topology;
+    QList<SimClient *> _clients;
+    QHash<const SimClient *, QHash<quint32, QList<Route>>> _routes;
+
+    // delayed packets ordered by due time then by arrival
+    QElapsedTimer _clock;
+    QTimer _delayTimer;
+    QMap<QPair<qint64, quint64>, DelayedPacket> _delayed;
+    quint64 _forwardedCount;
+};
+
+#endif // SIMFABRIC_H
@@ -30,6 +30,7 @@ SimProject::SimProject(QObject *parent)
     connect(_process, SIGNAL(channelReadyRead(int)), this, SLOT(readProcess()));
     connect(_process, SIGNAL(finished(int, QProcess::ExitStatus)), this, SLOT(finish(int, QProcess::ExitStatus)));
     _valid = false;
+    _client = Q_NULLPTR;
 }
 
 SimProject::~SimProject()
@@ -58,6 +59,28 @@ bool SimProject::setExePath(const QString &exePath)
     return true;
 }
 
+const QString &SimProject::name() const
+{
+    return _name;
+}
+
+/**
+ * @brief Sets the board name of a topology instance, given to the program by
+ * UDK_SIM_BOARD env variable and used to prefix its logs
+ */
+void SimProject::setName(const QString &name)
+{
+    _name = name;
+    QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
+    env.insert("UDK_SIM_BOARD", name);
+    _process->setProcessEnvironment(env);
+}
+
+void SimProject::setArguments(const QStringList &args)
+{
+    _process->setArguments(args);
+}
+
 bool SimProject::isValid() const
 {
     return _valid;
@@ -99,6 +122,11 @@ void SimProject::readProcess()
     if (!out.isEmpty())
         log.append(out);
 
+    if (log.isEmpty())
+        return;
+    if (!_name.isEmpty())
+        log.prepend("<b>" + _name + "</b> ");
+
     log.replace('\n', "<br></br>");
     log.replace('\r', "");
     emit logAppended(log);
@@ -112,7 +140,10 @@ void SimProject::finish(int exitCode, QProcess::ExitStatus exitStatus)
         log.append(QString("<span color='red'>Process crashed with error code %1</span>").arg(exitCode));
     else
         log.append(QString("<span color='0xFF0000'>Process finished with exitCode code %1</span>").arg(exitCode));
+    if (!_name.isEmpty())
+        log.prepend("<b>" + _name + "</b> ");
     emit logAppended(log);
+    emit stopped();
 }
 
 SimClient *SimProject::client() const
@@ -35,6 +35,10 @@ public:
     QString exePath() const;
     bool setExePath(const QString &exePath);
 
+    const QString &name() const;
+    void setName(const QString &name);
+    void setArguments(const QStringList &args);
+
     bool isValid() const;
     enum Status {
         Invalid,
@@ -48,6 +52,7 @@ public:
 
 signals:
     void logAppended(QString log);
+    void stopped();
 
 public slots:
     void start();
@@ -58,6 +63,7 @@ protected slots:
 
 protected:
     QString _exePath;
+    QString _name;
     QDir _path;
     QProcess *_process;
     bool _valid;
@@ -19,6 +19,7 @@
 #include "simserver.h"
 
 #include "simclient.h"
+#include "simfabric.h"
 
 #include "archi/simulator/simulator.h"
 
@@ -29,6 +30,9 @@ SimServer *SimServer::server = Q_NULLPTR;
 SimServer::SimServer(QObject *parent)
     : QObject(parent)
 {
+    _fabric = new SimFabric(this);
+    _headless = false;
+
     _server = new QTcpServer(this);
     connect(_server, SIGNAL(newConnection()), this, SLOT(newClient()));
     _server->listen(QHostAddress::LocalHost, SIM_SOCKET_PORT);
@@ -47,6 +51,30 @@ SimServer *SimServer::instance()
     return server;
 }
 
+const QList<SimClient *> &SimServer::clients() const
+{
+    return _simClients;
+}
+
+SimFabric *SimServer::fabric() const
+{
+    return _fabric;
+}
+
+/**
+ * @brief In headless mode, clients do not create modules widgets and only
+ * packets routed by fabric are processed
+ */
+bool SimServer::isHeadless() const
+{
+    return _headless;
+}
+
+void SimServer::setHeadless(bool headless)
+{
+    _headless = headless;
+}
+
 void SimServer::newClient()
 {
     //qDebug()<<"new connection";
@@ -54,15 +82,33 @@ void SimServer::newClient()
     connect(socket, SIGNAL(error(QAbstractSocket::SocketError)), this, SLOT(deleteClient(QAbstractSocket::SocketError)));
 
     SimClient *client = new SimClient(socket);
+    connect(client, SIGNAL(nameChanged(SimClient *)), this, SLOT(updateClientName(SimClient *)));
     _simClients.append(client);
+    _fabric->addClient(client);
     emit clientAdded(client);
 }
 
 void SimServer::deleteClient(QAbstractSocket::SocketError error)
 {
-    SimClient *client = static_cast<SimClient *>(sender());
+    Q_UNUSED(error)
+    QTcpSocket *socket = static_cast<QTcpSocket *>(sender());
     /*if(error == QAbstractSocket::RemoteHostClosedError)
         qDebug()<<"end connection";*/
 
-    emit clientClosed(client);
+    for (SimClient *client : _simClients)
+    {
+        if (client->socket() == socket)
+        {
+            _simClients.removeOne(client);
+            _fabric->removeClient(client);
+            emit clientClosed(client);
+            return;
+        }
+    }
+}
+
+void SimServer::updateClientName(SimClient *client)
+{
+    _fabric->addClient(client);
+    emit clientNamed(client);
 }
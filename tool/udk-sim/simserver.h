@@ -24,6 +24,7 @@
 #include <QList>
 
 class SimClient;
+class SimFabric;
 
 class SimServer : public QObject
 {
@@ -35,17 +36,27 @@ public:
     bool isConnected() const;
     static SimServer *instance();
 
+    const QList<SimClient *> &clients() const;
+    SimFabric *fabric() const;
+
+    bool isHeadless() const;
+    void setHeadless(bool headless);
+
 signals:
     void clientAdded(SimClient *client);
     void clientClosed(SimClient *client);
+    void clientNamed(SimClient *client);
 
 protected slots:
     void newClient();
     void deleteClient(QAbstractSocket::SocketError error);
+    void updateClientName(SimClient *client);
 
 protected:
     QTcpServer *_server;
     QList<SimClient *> _simClients;
+    SimFabric *_fabric;
+    bool _headless;
     static SimServer *server;
 };
 
@@ -0,0 +1,162 @@
+/**
+ ** This file is part of the UDK-SDK project.
+ ** Copyright 2026 UniSwarm sebastien.caux@uniswarm.eu
+ **
+ ** This program is free software: you can redistribute it and/or modify
+ ** it under the terms of the GNU General Public License as published by
+ ** the Free Software Foundation, either version 3 of the License, or
+ ** (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ ** GNU General Public License for more details.
+ **
+ ** You should have received a copy of the GNU General Public License
+ ** along with this program. If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "simtopology.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QRegularExpression>
+
+#include "driver/can/can_sim.h"
+#include "driver/uart/uart_sim.h"
+
+SimTopology::SimTopology()
+{
+}
+
+bool SimTopology::Endpoint::matchBoard(const QString &boardName) const
+{
+    if (board.endsWith('*'))
+        return boardName.startsWith(board.left(board.size() - 1));
+    return boardName == board;
+}
+
+bool SimTopology::load(const QString &filePath)
+{
+    _boards.clear();
+    _links.clear();
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        _errorString = QString("cannot open '%1'").arg(filePath);
+        return false;
+    }
+
+    QJsonParseError parseError;
+    QJsonDocument doc = QJsonDocument::fromJson(file.readAll(), &parseError);
+    if (doc.isNull())
+    {
+        _errorString = QString("%1 at offset %2").arg(parseError.errorString()).arg(parseError.offset);
+        return false;
+    }
+    QJsonObject root = doc.object();
+
+    // exe paths are relative to the topology file
+    QDir topologyDir = QFileInfo(filePath).absoluteDir();
+    for (const QJsonValue &boardValue : root.value("boards").toArray())
+    {
+        QJsonObject boardObject = boardValue.toObject();
+        QString name = boardObject.value("name").toString();
+        QString exe = boardObject.value("exe").toString();
+        int count = boardObject.value("count").toInt(1);
+        if (name.isEmpty() || exe.isEmpty() || count < 1)
+        {
+            _errorString = QString("board needs a name, an exe and a positive count");
+            return false;
+        }
+
+        QStringList args;
+        for (const QJsonValue &arg : boardObject.value("args").toArray())
+            args.append(arg.toString());
+
+        for (int i = 0; i < count; i++)
+        {
+            Board board;
+            board.name = (count == 1) ? name : QString("%1%2").arg(name).arg(i);
+            board.exePath = topologyDir.absoluteFilePath(exe);
+            board.args = args;
+            _boards.append(board);
+        }
+    }
+
+    for (const QJsonValue &linkValue : root.value("links").toArray())
+    {
+        QJsonObject linkObject = linkValue.toObject();
+        Link link;
+        link.latencyMs = linkObject.value("latency").toInt(0);
+        for (const QJsonValue &endValue : linkObject.value("ends").toArray())
+        {
+            Endpoint endpoint;
+            if (!parseEndpoint(endValue.toString(), endpoint))
+            {
+                _errorString = QString("invalid link end '%1'").arg(endValue.toString());
+                return false;
+            }
+            link.ends.append(endpoint);
+        }
+        if (link.ends.size() < 2)
+        {
+            _errorString = QString("link needs at least two ends");
+            return false;
+        }
+        _links.append(link);
+    }
+
+    _errorString.clear();
+    return true;
+}
+
+const QString &SimTopology::errorString() const
+{
+    return _errorString;
+}
+
+const QList<SimTopology::Board> &SimTopology::boards() const
+{
+    return _boards;
+}
+
+const QList<SimTopology::Link> &SimTopology::links() const
+{
+    return _links;
+}
+
+/**
+ * @brief Parses an end as 'board.uart1', 'board.can2' or 'board.0x0010:0'
+ * (module id and periph id)
+ */
+bool SimTopology::parseEndpoint(const QString &text, SimTopology::Endpoint &endpoint)
+{
+    static const QRegularExpression periphRegexp("^(.+)\\.(uart|can)([1-9][0-9]*)$");
+    static const QRegularExpression rawRegexp("^(.+)\\.(0x[0-9a-fA-F]+|[0-9]+):([0-9]+)$");
+
+    QRegularExpressionMatch match = periphRegexp.match(text);
+    if (match.hasMatch())
+    {
+        endpoint.board = match.captured(1);
+        endpoint.moduleId = (match.captured(2) == "uart") ? UART_SIM_MODULE : CAN_SIM_MODULE;
+        endpoint.periphId = static_cast<uint16_t>(match.captured(3).toUInt() - 1);
+        return true;
+    }
+
+    match = rawRegexp.match(text);
+    if (match.hasMatch())
+    {
+        bool ok;
+        endpoint.board = match.captured(1);
+        endpoint.moduleId = static_cast<uint16_t>(match.captured(2).toUInt(&ok, 0));
+        endpoint.periphId = static_cast<uint16_t>(match.captured(3).toUInt());
+        return ok;
+    }
+    return false;
+}
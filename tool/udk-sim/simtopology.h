@@ -0,0 +1,87 @@
+/**
+ ** This file is part of the UDK-SDK project.
+ ** Copyright 2026 UniSwarm sebastien.caux@uniswarm.eu
+ **
+ ** This program is free software: you can redistribute it and/or modify
+ ** it under the terms of the GNU General Public License as published by
+ ** the Free Software Foundation, either version 3 of the License, or
+ ** (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ ** GNU General Public License for more details.
+ **
+ ** You should have received a copy of the GNU General Public License
+ ** along with this program. If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef SIMTOPOLOGY_H
+#define SIMTOPOLOGY_H
+
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+#include <stdint.h>
+
+/**
+ * @brief Declarative description of a multi-board simulation
+ *
+ * JSON file with a list of boards (simulator executables, optionally
+ * instantiated several times) and a list of links connecting peripherals of
+ * these boards. A link with two ends is a wire, with more ends a bus: each
+ * write on one end is received by all other ends.
+ *
+ * {
+ *     "boards": [
+ *         {"name": "robot", "exe": "swarmtest/build-sim/swarmtest_sim", "count": 10},
+ *         {"name": "base", "exe": "base/build-sim/base_sim"}
+ *     ],
+ *     "links": [
+ *         {"ends": ["robot*.uart1", "base.uart2"], "latency": 5}
+ *     ]
+ * }
+ */
+class SimTopology
+{
+public:
+    SimTopology();
+
+    struct Board
+    {
+        QString name;
+        QString exePath;
+        QStringList args;
+    };
+
+    struct Endpoint
+    {
+        QString board;  // board instance name, may end with '*' to match all instances
+        uint16_t moduleId;
+        uint16_t periphId;
+
+        bool matchBoard(const QString &boardName) const;
+    };
+
+    struct Link
+    {
+        QList<Endpoint> ends;
+        int latencyMs;
+    };
+
+    bool load(const QString &filePath);
+    const QString &errorString() const;
+
+    const QList<Board> &boards() const;
+    const QList<Link> &links() const;
+
+    static bool parseEndpoint(const QString &text, Endpoint &endpoint);
+
+protected:
+    QString _errorString;
+    QList<Board> _boards;
+    QList<Link> _links;
+};
+
+#endif // SIMTOPOLOGY_H
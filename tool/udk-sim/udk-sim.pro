@@ -25,7 +25,10 @@ SOURCES += main.cpp \
     widgets/uartwidget/uartwidget.cpp \
     widgets/adcwidget/adcwidget.cpp \
     widgets/guiwidget/guiwidget.cpp \
-    simproject.cpp
+    widgets/statswidget/statswidget.cpp \
+    simproject.cpp \
+    simtopology.cpp \
+    simfabric.cpp
 
 FORMS +=
 
@@ -43,6 +46,9 @@ HEADERS += \
     widgets/uartwidget/uartwidget.h \
     widgets/adcwidget/adcwidget.h \
     widgets/guiwidget/guiwidget.h \
-    simproject.h
+    widgets/statswidget/statswidget.h \
+    simproject.h \
+    simtopology.h \
+    simfabric.h
 
 INCLUDEPATH += ../../include ../../support
@@ -0,0 +1,105 @@
+/**
+ ** This file is part of the UDK-SDK project.
+ ** Copyright 2026 UniSwarm sebastien.caux@uniswarm.eu
+ **
+ ** This program is free software: you can redistribute it and/or modify
+ ** it under the terms of the GNU General Public License as published by
+ ** the Free Software Foundation, either version 3 of the License, or
+ ** (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ ** GNU General Public License for more details.
+ **
+ ** You should have received a copy of the GNU General Public License
+ ** along with this program. If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "statswidget.h"
+
+#include <QLayout>
+
+#include "simclient.h"
+#include "simserver.h"
+
+StatsWidget::StatsWidget(QWidget *parent)
+    : QWidget(parent)
+{
+    setWindowTitle(QString("Statistics"));
+    createWidget();
+
+    _timer = new QTimer(this);
+    connect(_timer, SIGNAL(timeout()), this, SLOT(refresh()));
+    _timer->start(500);
+    _elapsed.start();
+}
+
+/**
+ * @brief Rebuilds the tree from the counters of all connected clients
+ */
+void StatsWidget::refresh()
+{
+    if (!isVisible())
+    {
+        return;
+    }
+
+    double seconds = _elapsed.restart() / 1000.0;
+    if (seconds <= 0)
+    {
+        seconds = 1;
+    }
+
+    QHash<QPair<const SimClient *, quint64>, QPair<quint64, quint64>> bytes;
+    _tree->clear();
+    int clientId = 0;
+    for (const SimClient *client : SimServer::instance()->clients())
+    {
+        QString name = client->name().isEmpty() ? QString("client %1").arg(clientId) : client->name();
+        clientId++;
+
+        QTreeWidgetItem *clientItem = new QTreeWidgetItem(_tree, QStringList(name));
+        quint64 clientRx = 0, clientTx = 0;
+        QMap<quint64, SimClient::Stats>::const_iterator it;
+        for (it = client->stats().constBegin(); it != client->stats().constEnd(); ++it)
+        {
+            const SimClient::Stats &stats = it.value();
+            QPair<const SimClient *, quint64> key(client, it.key());
+            QPair<quint64, quint64> last = _lastBytes.value(key);
+            bytes.insert(key, qMakePair(stats.rxBytes, stats.txBytes));
+            clientRx += stats.rxBytes;
+            clientTx += stats.txBytes;
+
+            QStringList columns;
+            columns << QString("0x%1:%2:%3")
+                           .arg(it.key() >> 32, 4, 16, QChar('0'))
+                           .arg((it.key() >> 16) & 0xFFFF)
+                           .arg(it.key() & 0xFFFF)
+                    << QString::number(stats.rxPackets) << QString::number(stats.rxBytes)
+                    << QString::number((stats.rxBytes - last.first) / seconds, 'f', 0)
+                    << QString::number(stats.txPackets) << QString::number(stats.txBytes)
+                    << QString::number((stats.txBytes - last.second) / seconds, 'f', 0);
+            new QTreeWidgetItem(clientItem, columns);
+        }
+        clientItem->setText(2, QString::number(clientRx));
+        clientItem->setText(5, QString::number(clientTx));
+        clientItem->setExpanded(true);
+    }
+    _lastBytes = bytes;
+}
+
+void StatsWidget::createWidget()
+{
+    QLayout *layout = new QVBoxLayout();
+    layout->setContentsMargins(0, 0, 0, 0);
+
+    _tree = new QTreeWidget();
+    _tree->setHeaderLabels(QStringList() << "module:periph:fn"
+                                         << "rx packets" << "rx bytes" << "rx B/s"
+                                         << "tx packets" << "tx bytes" << "tx B/s");
+    _tree->setRootIsDecorated(true);
+    layout->addWidget(_tree);
+
+    setLayout(layout);
+}
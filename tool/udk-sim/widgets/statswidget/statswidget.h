@@ -0,0 +1,51 @@
+/**
+ ** This file is part of the UDK-SDK project.
+ ** Copyright 2026 UniSwarm sebastien.caux@uniswarm.eu
+ **
+ ** This program is free software: you can redistribute it and/or modify
+ ** it under the terms of the GNU General Public License as published by
+ ** the Free Software Foundation, either version 3 of the License, or
+ ** (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ ** GNU General Public License for more details.
+ **
+ ** You should have received a copy of the GNU General Public License
+ ** along with this program. If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef STATSWIDGET_H
+#define STATSWIDGET_H
+
+#include <QWidget>
+#include <QTreeWidget>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QPair>
+
+class SimClient;
+
+class StatsWidget : public QWidget
+{
+    Q_OBJECT
+public:
+    explicit StatsWidget(QWidget *parent = Q_NULLPTR);
+
+protected slots:
+    void refresh();
+
+protected:
+    void createWidget();
+
+    QTreeWidget *_tree;
+    QTimer *_timer;
+    QElapsedTimer _elapsed;
+
+    // previous rx/tx bytes per client and key, for rates
+    QHash<QPair<const SimClient *, quint64>, QPair<quint64, quint64>> _lastBytes;
+};
+
+#endif // STATSWIDGET_H